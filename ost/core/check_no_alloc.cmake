@@ -0,0 +1,29 @@
+# Fails when the library LIB references the heap. Run by the POST_BUILD
+# step of ost-core under OST_STATIC_ALLOCATION.
+#
+# Only allocation is looked for: the deleting destructors of the classes
+# with virtual destructors always reference operator delete, it is never
+# called on objects that were not allocated.
+
+execute_process(COMMAND ${NM} -C -u ${LIB}
+  OUTPUT_VARIABLE undefined
+  RESULT_VARIABLE result)
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "${NM} failed on ${LIB}")
+endif()
+
+string(REPLACE "\n" ";" symbols "${undefined}")
+set(offenders)
+foreach(symbol IN LISTS symbols)
+  string(REGEX REPLACE "^ *U " "" symbol "${symbol}")
+  if(symbol MATCHES "^operator new"
+     OR symbol MATCHES "^(malloc|calloc|realloc|aligned_alloc|posix_memalign|strdup)$")
+    list(APPEND offenders "${symbol}")
+  endif()
+endforeach()
+
+if(offenders)
+  list(REMOVE_DUPLICATES offenders)
+  string(REPLACE ";" "\n  " offenders "${offenders}")
+  message(FATAL_ERROR "ost-core allocates under OST_STATIC_ALLOCATION:\n  ${offenders}")
+endif()
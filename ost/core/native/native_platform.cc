@@ -0,0 +1,253 @@
+#include "native_platform.h"
+
+namespace ost
+{
+namespace native
+{
+
+    EventLoop::EventLoop()
+        : now(0),
+          next_order(0),
+          stopped(false)
+    {
+    }
+
+    uint64_t
+    EventLoop::now_us() const
+    {
+        return now;
+    }
+
+    void
+    EventLoop::post(Task &task, micros_t delay)
+    {
+        cancel(task);
+        Key k(now + delay, next_order++);
+        queue[k] = Entry{&task, nullptr};
+        pending[&task] = k;
+    }
+
+    void
+    EventLoop::cancel(Task &task)
+    {
+        auto it = pending.find(&task);
+        if (it == pending.end())
+            return;
+        queue.erase(it->second);
+        pending.erase(it);
+    }
+
+    void
+    EventLoop::schedule(uint64_t delay, std::function<void()> fn)
+    {
+        queue[Key(now + delay, next_order++)] = Entry{nullptr, std::move(fn)};
+    }
+
+    uint64_t
+    EventLoop::run(uint64_t limit_us)
+    {
+        uint64_t events = 0;
+        stopped = false;
+        while (!stopped && !queue.empty() && queue.begin()->first.first <= limit_us)
+        {
+            auto it = queue.begin();
+            now = it->first.first;
+            Entry e = std::move(it->second);
+            queue.erase(it);
+            if (e.task)
+            {
+                pending.erase(e.task);
+                e.task->run();
+            }
+            else
+            {
+                e.fn();
+            }
+            events++;
+        }
+        if (!stopped && now < limit_us)
+            now = limit_us;
+        return events;
+    }
+
+    bool
+    EventLoop::is_empty() const
+    {
+        return queue.empty();
+    }
+
+    uint64_t
+    EventLoop::get_next_us() const
+    {
+        return queue.empty() ? now : queue.begin()->first.first;
+    }
+
+    void
+    EventLoop::stop()
+    {
+        stopped = true;
+    }
+
+    LoopTimer::LoopTimer(EventLoop &l)
+        : loop(l),
+          listener(nullptr),
+          running(false),
+          val(0),
+          deadline(0)
+    {
+    }
+
+    void
+    LoopTimer::set_listener(TimerDriver::Listener *l)
+    {
+        listener = l;
+    }
+
+    void
+    LoopTimer::start(micros_t duration)
+    {
+        val = duration;
+        running = true;
+        deadline = loop.now_us() + duration;
+        loop.post(*this, duration);
+    }
+
+    void
+    LoopTimer::stop()
+    {
+        running = false;
+        loop.cancel(*this);
+    }
+
+    bool
+    LoopTimer::is_running() const
+    {
+        return running;
+    }
+
+    micros_t
+    LoopTimer::get_duration() const
+    {
+        return val;
+    }
+
+    micros_t
+    LoopTimer::get_left_time() const
+    {
+        if (!running)
+            return 0;
+        return deadline - loop.now_us();
+    }
+
+    uint64_t
+    LoopTimer::get_tick_period_ns() const
+    {
+        return 0;
+    }
+
+    uint64_t
+    LoopTimer::get_ticks() const
+    {
+        return 0;
+    }
+
+    void
+    LoopTimer::start_ticks(uint32_t /* ticks */)
+    {
+        // one-shot timer, TimerService never asks for ticks
+    }
+
+    void
+    LoopTimer::run()
+    {
+        running = false;
+        if (listener)
+            listener->timer_expired();
+    }
+
+    bool
+    LoopbackLink::End::is_ready() const
+    {
+        return true;
+    }
+
+    bool
+    LoopbackLink::End::transmit(uint8_t /* dst_addr */, const uint8_t *frame, uint16_t len)
+    {
+        return link->transmit(*this, frame, len);
+    }
+
+    LoopbackLink::LoopbackLink(EventLoop &l, uint64_t rate, micros_t lat, double loss_rate, uint32_t seed)
+        : loop(l),
+          rate_bps(rate),
+          latency(lat),
+          loss(loss_rate),
+          rng(seed ? seed : 1),
+          frames(0),
+          dropped(0)
+    {
+        for (uint8_t i = 0; i < 2; ++i)
+        {
+            ends[i].link = this;
+            ends[i].peer = &ends[1 - i];
+            ends[i].busy_until = 0;
+        }
+    }
+
+    LoopbackLink::End &
+    LoopbackLink::get_end(uint8_t i)
+    {
+        return ends[i];
+    }
+
+    void
+    LoopbackLink::set_receiver(uint8_t i, Receiver r)
+    {
+        ends[i].receiver = r;
+    }
+
+    uint64_t
+    LoopbackLink::get_frames() const
+    {
+        return frames;
+    }
+
+    uint64_t
+    LoopbackLink::get_dropped() const
+    {
+        return dropped;
+    }
+
+    bool
+    LoopbackLink::lose()
+    {
+        // xorshift32, the same sequence for the same seed
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        return loss > 0 && rng < loss * 4294967296.0;
+    }
+
+    bool
+    LoopbackLink::transmit(End &from, const uint8_t *frame, uint16_t len)
+    {
+        uint64_t start = from.busy_until > loop.now_us() ? from.busy_until : loop.now_us();
+        uint64_t serialization = rate_bps ? (uint64_t(len) * 8 * 1000000 + rate_bps - 1) / rate_bps : 0;
+        from.busy_until = start + serialization;
+        frames++;
+        if (lose())
+        {
+            dropped++;
+            return true;
+        }
+        End *to = from.peer;
+        std::vector<uint8_t> copy(frame, frame + len);
+        loop.schedule(from.busy_until + latency - loop.now_us(), [to, copy]() {
+            if (to->receiver)
+                to->receiver(copy.data(), copy.size());
+        });
+        return true;
+    }
+
+} // namespace native
+} // namespace ost
@@ -0,0 +1,142 @@
+#ifndef OST_NATIVE_PLATFORM_H
+#define OST_NATIVE_PLATFORM_H
+
+#include "../ost_platform.h"
+
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+/**
+ * \ingroup ost-core
+ * Platform for running the engine in a plain Linux process.
+ *
+ * Time is virtual: EventLoop jumps from one event to the next, so the
+ * wall-clock time of a run is the CPU cost of the engine plus the loop
+ * itself, which is what a throughput benchmark has to measure.
+ */
+namespace ost
+{
+namespace native
+{
+
+    /**
+     * Discrete event loop in virtual microseconds.
+     */
+    class EventLoop : public Clock, public EventQueue
+    {
+    public:
+        EventLoop();
+
+        uint64_t now_us() const override;
+        void post(Task &task, micros_t delay) override;
+        void cancel(Task &task) override;
+
+        void schedule(uint64_t delay, std::function<void()> fn);
+
+        /**
+         * Run the events due up to limit_us, then the virtual time is limit_us.
+         *
+         * \return number of events run
+         */
+        uint64_t run(uint64_t limit_us);
+        void stop();
+        bool is_empty() const;
+
+        /**
+         * \return time of the earliest event, now if there is none
+         */
+        uint64_t get_next_us() const;
+
+    private:
+        typedef std::pair<uint64_t, uint64_t> Key; // time, order of insertion
+        struct Entry
+        {
+            Task *task;
+            std::function<void()> fn;
+        };
+
+        std::map<Key, Entry> queue;
+        std::map<Task *, Key> pending;
+        uint64_t now;
+        uint64_t next_order;
+        bool stopped;
+    };
+
+    /**
+     * One-shot TimerDriver on the EventLoop.
+     */
+    class LoopTimer : public TimerDriver, private Task
+    {
+    public:
+        LoopTimer(EventLoop &loop);
+
+        void set_listener(TimerDriver::Listener *l) override;
+        void start(micros_t duration) override;
+        void stop() override;
+        bool is_running() const override;
+        micros_t get_duration() const override;
+        micros_t get_left_time() const override;
+        uint64_t get_tick_period_ns() const override;
+        uint64_t get_ticks() const override;
+        void start_ticks(uint32_t ticks) override;
+
+    private:
+        void run() override;
+
+        EventLoop &loop;
+        TimerDriver::Listener *listener;
+        bool running;
+        micros_t val;
+        uint64_t deadline;
+    };
+
+    /**
+     * Point to point link between two ends: frames are serialized at rate
+     * bits per second, delayed by latency and dropped with probability loss.
+     */
+    class LoopbackLink
+    {
+    public:
+        typedef std::function<void(const uint8_t *, uint16_t)> Receiver;
+
+        class End : public LinkDriver
+        {
+        public:
+            bool is_ready() const override;
+            bool transmit(uint8_t dst_addr, const uint8_t *frame, uint16_t len) override;
+
+        private:
+            friend class LoopbackLink;
+            LoopbackLink *link;
+            End *peer;
+            Receiver receiver;
+            uint64_t busy_until;
+        };
+
+        LoopbackLink(EventLoop &loop, uint64_t rate_bps, micros_t latency, double loss, uint32_t seed);
+
+        End &get_end(uint8_t i);
+        void set_receiver(uint8_t i, Receiver r);
+        uint64_t get_frames() const;
+        uint64_t get_dropped() const;
+
+    private:
+        bool transmit(End &from, const uint8_t *frame, uint16_t len);
+        bool lose();
+
+        EventLoop &loop;
+        End ends[2];
+        uint64_t rate_bps;
+        micros_t latency;
+        double loss;
+        uint32_t rng;
+        uint64_t frames;
+        uint64_t dropped;
+    };
+
+} // namespace native
+} // namespace ost
+
+#endif
@@ -0,0 +1,64 @@
+/*
+ * RAM footprint of the OST engine for the configuration it is built with.
+ *
+ * Everything a node needs is in the objects below, so the sum is the
+ * static RAM a target has to reserve for one node (stack excluded).
+ * Build with the configuration of the target, e.g.
+ *
+ *   cmake -S ost/core -B build -DOST_STATIC_ALLOCATION=ON \
+ *         -DOST_MAX_PEERS=2 -DOST_WINDOW_SZ=8 -DOST_MTU=1029
+ *   cmake --build build --target ost-footprint-report
+ *
+ * With OST_CFG_RAM_BUDGET defined the build fails when the total exceeds it.
+ */
+
+#include "../ost_config.h"
+#include "../ost_core_node.h"
+#include "../ost_static_pool.h"
+
+#include <cstdio>
+
+namespace
+{
+
+// the pool is what a static build reserves whatever the allocation mode
+typedef ost::StaticBufferPool<ost::config::MTU, ost::config::NODE_BUFFERS> FullPool;
+
+constexpr size_t NODE_BYTES = sizeof(ost::Node);
+constexpr size_t POOL_BYTES = sizeof(FullPool);
+constexpr size_t TOTAL_BYTES = NODE_BYTES + POOL_BYTES;
+
+#ifdef OST_CFG_RAM_BUDGET
+static_assert(TOTAL_BYTES <= OST_CFG_RAM_BUDGET, "OST node does not fit OST_CFG_RAM_BUDGET");
+#endif
+
+void
+Row(const char *name, size_t count, size_t each)
+{
+    printf("  %-24s %6zu x %8zu = %10zu\n", name, count, each, count * each);
+}
+
+} // namespace
+
+int
+main()
+{
+    namespace cfg = ost::config;
+
+    printf("configuration\n");
+    printf("  max peers                %u\n", unsigned(cfg::MAX_PEERS));
+    printf("  window                   %u\n", unsigned(cfg::WINDOW_SZ));
+    printf("  mtu                      %u\n", unsigned(cfg::MTU));
+    printf("  transmit fifo            %u\n", unsigned(cfg::TRANSMIT_FIFO_SZ));
+    printf("  timers                   %u\n", unsigned(cfg::MAX_TIMERS));
+    printf("  static allocation        %s\n", cfg::STATIC_ALLOCATION ? "yes" : "no");
+
+    printf("footprint (bytes)\n");
+    Row("socket", cfg::MAX_PEERS, sizeof(ost::Socket));
+    Row("timer service", 1, sizeof(ost::TimerService));
+    Row("node (sockets, timers)", 1, NODE_BYTES);
+    Row("segment buffers", cfg::NODE_BUFFERS, cfg::MTU);
+    Row("buffer pool", 1, POOL_BYTES);
+    printf("  %-24s %31zu\n", "total", TOTAL_BYTES);
+    return 0;
+}
@@ -0,0 +1,177 @@
+/*
+ * Throughput of the OST engine compiled natively, without ns-3.
+ *
+ * Two ost::Node are connected by a LoopbackLink and node 0 streams
+ * numbered messages to node 1 as fast as the transmit fifo takes them.
+ * The receiver checks that every message arrives once and in order.
+ * The virtual time is what the protocol achieves on the modelled link,
+ * the wall-clock time is what the engine costs on this machine.
+ *
+ *   ost-native-bench --segments=100000 --payload=1024 --loss=0.01
+ */
+
+#include "native_platform.h"
+
+#include "../ost_core_node.h"
+#include "../ost_static_pool.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct Config
+{
+    uint32_t segments = 100000;
+    uint32_t payload = 1024;
+    uint64_t rate_bps = 100000000;
+    uint32_t latency_us = 10;
+    double loss = 0;
+    uint32_t seed = 1;
+};
+
+class Receiver : public ost::Node::Listener
+{
+  public:
+    void segment_received(uint8_t /* src_addr */, uint8_t /* port */, const uint8_t *payload, uint16_t len) override
+    {
+        uint32_t n;
+        memcpy(&n, payload, sizeof(n));
+        if (n != expected)
+            out_of_order++;
+        expected = n + 1;
+        bytes += len;
+        received++;
+    }
+
+    uint32_t expected = 0;
+    uint32_t received = 0;
+    uint32_t out_of_order = 0;
+    uint64_t bytes = 0;
+};
+
+/*
+ * Keeps the transmit fifo of the sender full.
+ */
+class Sender : public ost::Task
+{
+  public:
+    Sender(ost::Node &n, ost::EventQueue &q, const Config &c)
+        : node(n), events(q), cfg(c), message(c.payload)
+    {
+    }
+
+    void run() override
+    {
+        while (sent < cfg.segments)
+        {
+            memcpy(message.data(), &sent, sizeof(sent));
+            if (node.send_packet(1, message.data(), message.size()) < 0)
+                break;
+            sent++;
+        }
+        if (sent < cfg.segments)
+            events.post(*this, 1000);
+    }
+
+    uint32_t sent = 0;
+
+  private:
+    ost::Node &node;
+    ost::EventQueue &events;
+    const Config &cfg;
+    std::vector<uint8_t> message;
+};
+
+bool
+ParseArg(const char *arg, const char *name, std::string &value)
+{
+    size_t n = strlen(name);
+    if (strncmp(arg, "--", 2) != 0 || strncmp(arg + 2, name, n) != 0 || arg[2 + n] != '=')
+        return false;
+    value = arg + 3 + n;
+    return true;
+}
+
+} // namespace
+
+int
+main(int argc, char *argv[])
+{
+    Config cfg;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string v;
+        if (ParseArg(argv[i], "segments", v))
+            cfg.segments = strtoul(v.c_str(), nullptr, 10);
+        else if (ParseArg(argv[i], "payload", v))
+            cfg.payload = strtoul(v.c_str(), nullptr, 10);
+        else if (ParseArg(argv[i], "rate", v))
+            cfg.rate_bps = strtoull(v.c_str(), nullptr, 10);
+        else if (ParseArg(argv[i], "latency", v))
+            cfg.latency_us = strtoul(v.c_str(), nullptr, 10);
+        else if (ParseArg(argv[i], "loss", v))
+            cfg.loss = strtod(v.c_str(), nullptr);
+        else if (ParseArg(argv[i], "seed", v))
+            cfg.seed = strtoul(v.c_str(), nullptr, 10);
+        else
+        {
+            fprintf(stderr, "usage: %s [--segments=N] [--payload=BYTES] [--rate=BPS] [--latency=US] [--loss=P] [--seed=N]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (cfg.payload < sizeof(uint32_t) || cfg.payload > ost::Socket::MAX_PAYLOAD)
+    {
+        fprintf(stderr, "payload must be 4..%u bytes\n", ost::Socket::MAX_PAYLOAD);
+        return 1;
+    }
+
+    ost::native::EventLoop loop;
+    ost::native::LoopbackLink link(loop, cfg.rate_bps, cfg.latency_us, cfg.loss, cfg.seed);
+    ost::native::LoopTimer timer0(loop), timer1(loop);
+    static ost::NodeBufferPool pool0, pool1;
+
+    ost::Node node0(0, ost::Platform{&loop, &loop, &timer0, &link.get_end(0), &pool0});
+    ost::Node node1(1, ost::Platform{&loop, &loop, &timer1, &link.get_end(1), &pool1});
+    link.set_receiver(0, [&](const uint8_t *f, uint16_t l) { node0.receive_frame(f, l); });
+    link.set_receiver(1, [&](const uint8_t *f, uint16_t l) { node1.receive_frame(f, l); });
+
+    Receiver receiver;
+    node1.set_listener(&receiver);
+    node0.start();
+    node1.start();
+    node0.open_connection(1);
+    node1.open_connection(0);
+
+    Sender sender(node0, loop, cfg);
+    loop.post(sender, 0);
+
+    auto begin = std::chrono::steady_clock::now();
+    uint64_t events = 0;
+    // a millisecond of virtual time at a time, to stop soon after the last delivery
+    while (receiver.received < cfg.segments && !loop.is_empty())
+    {
+        events += loop.run(loop.get_next_us() + 1000);
+    }
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    double virt = loop.now_us() / 1e6;
+
+    ost::Socket *s;
+    node0.get_socket(1, s);
+    const ost::SocketStats &st = s->get_stats();
+
+    printf("segments        %u x %u bytes\n", cfg.segments, cfg.payload);
+    printf("delivered       %u (%u out of order)\n", receiver.received, receiver.out_of_order);
+    printf("frames          %llu (%llu dropped)\n", (unsigned long long)link.get_frames(), (unsigned long long)link.get_dropped());
+    printf("retransmissions %u\n", st.retransmissions);
+    printf("mean rtt        %.1f us\n", st.rtt_samples ? double(st.rtt_sum_us) / st.rtt_samples : 0.0);
+    printf("virtual time    %.6f s, goodput %.3f Mbit/s\n", virt, virt > 0 ? receiver.bytes * 8 / virt / 1e6 : 0.0);
+    printf("wall time       %.6f s, %.0f segments/s, %.0f events/s\n", wall, receiver.received / wall, events / wall);
+
+    return receiver.received == cfg.segments && receiver.out_of_order == 0 ? 0 : 2;
+}
@@ -0,0 +1,83 @@
+#ifndef OST_CONFIG_H
+#define OST_CONFIG_H
+
+#include <stddef.h>
+#include <inttypes.h>
+
+/**
+ * \ingroup ost-core
+ * Compile-time configuration of the engine.
+ *
+ * Every limit can be overridden with -D on the compiler command line (or
+ * the OST_* cache variables of ost/core/CMakeLists.txt). The defaults are
+ * those of the simulation model.
+ *
+ * With OST_STATIC_ALLOCATION the engine never touches the heap: sockets,
+ * timers and segment buffers live in arrays sized from these limits and
+ * HeapBufferPool is not available.
+ */
+
+#ifndef OST_CFG_MAX_PEERS
+#define OST_CFG_MAX_PEERS 3
+#endif
+
+#ifndef OST_CFG_WINDOW_SZ
+#define OST_CFG_WINDOW_SZ 10
+#endif
+
+// header included
+#ifndef OST_CFG_MTU
+#define OST_CFG_MTU (0xffff + 5)
+#endif
+
+#ifndef OST_CFG_TRANSMIT_FIFO_SZ
+#define OST_CFG_TRANSMIT_FIFO_SZ 100
+#endif
+
+// retransmission timers of a full window, delayed ACK and keepalive per peer
+#ifndef OST_CFG_MAX_TIMERS
+#define OST_CFG_MAX_TIMERS (OST_CFG_MAX_PEERS * (OST_CFG_WINDOW_SZ + 2))
+#endif
+
+namespace ost
+{
+namespace config
+{
+
+    /**
+     * \return smallest b such that 2^b >= n
+     */
+    constexpr uint32_t log2_ceil(uint32_t n)
+    {
+        return n <= 1 ? 0 : 1 + log2_ceil((n + 1) / 2);
+    }
+
+    constexpr uint8_t MAX_PEERS = OST_CFG_MAX_PEERS;
+    constexpr uint16_t WINDOW_SZ = OST_CFG_WINDOW_SZ;
+    constexpr uint32_t MTU = OST_CFG_MTU;
+    constexpr uint16_t TRANSMIT_FIFO_SZ = OST_CFG_TRANSMIT_FIFO_SZ;
+    constexpr uint32_t MAX_TIMERS = OST_CFG_MAX_TIMERS;
+
+    /**
+     * Segment buffers a socket can hold at once: queued, unacknowledged
+     * and received out of order.
+     */
+    constexpr uint32_t SOCKET_BUFFERS = TRANSMIT_FIFO_SZ + 2 * WINDOW_SZ;
+    constexpr uint32_t NODE_BUFFERS = MAX_PEERS * SOCKET_BUFFERS;
+
+#ifdef OST_STATIC_ALLOCATION
+    constexpr bool STATIC_ALLOCATION = true;
+#else
+    constexpr bool STATIC_ALLOCATION = false;
+#endif
+
+    static_assert(MAX_PEERS > 0, "at least one peer");
+    static_assert(WINDOW_SZ > 0 && WINDOW_SZ <= 128, "window must fit half of the sequence space");
+    static_assert(MTU > 5 && MTU <= 0xffff + 5, "MTU holds the 5 byte header and up to 64k of payload");
+    static_assert(TRANSMIT_FIFO_SZ > 0, "transmit fifo can not be empty");
+    static_assert(MAX_TIMERS >= WINDOW_SZ, "no room for the retransmission timers of a window");
+
+} // namespace config
+} // namespace ost
+
+#endif
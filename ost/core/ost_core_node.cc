@@ -0,0 +1,312 @@
+#include "ost_core_node.h"
+
+#include <new>
+
+namespace ost
+{
+
+    Node::Node(uint8_t address, const Platform &p)
+        : self_address(address),
+          platform(p),
+          timers(*p.timer),
+          ports_count(0),
+          frames_in_link(0),
+          link_depth(LINK_DEPTH),
+          socket_options(Socket::default_options()),
+          upper_handler(nullptr)
+    {
+        for (uint8_t i = 0; i < PORTS_NUMBER; ++i)
+            ports[i] = nullptr;
+        timers.set_listener(this);
+    }
+
+    Node::~Node()
+    {
+        for (uint8_t i = 0; i < ports_count; ++i)
+            ports[i]->~Socket();
+    }
+
+    int8_t
+    Node::start()
+    {
+        if (ports_count == PORTS_NUMBER)
+            return -1;
+        ports[ports_count] = new (sockets[ports_count]) Socket(*this, ports_count);
+        ports_count++;
+        return 0;
+    }
+
+    void
+    Node::shutdown()
+    {
+        for (uint8_t i = 0; i < ports_count; ++i)
+        {
+            if (ports[i]->get_address() != self_address && ports[i]->get_state() != Socket::State::CLOSED)
+            {
+                ports[i]->close();
+            }
+        }
+    }
+
+    int8_t
+    Node::set_socket_options(const SocketOptions &o)
+    {
+        if (!Socket::valid_options(o))
+            return -1;
+        socket_options = o;
+        for (uint8_t i = 0; i < ports_count; ++i)
+            ports[i]->set_options(o);
+        return 1;
+    }
+
+    const SocketOptions &
+    Node::get_socket_options() const
+    {
+        return socket_options;
+    }
+
+    int8_t
+    Node::set_link_depth(uint8_t depth)
+    {
+        if (depth == 0)
+            return -1;
+        link_depth = depth;
+        return 1;
+    }
+
+    uint8_t
+    Node::get_link_depth() const
+    {
+        return link_depth;
+    }
+
+    int8_t
+    Node::open_connection(uint8_t addr)
+    {
+        if (addr == self_address)
+            return -1;
+
+        Socket *sk;
+        int8_t r = get_socket(addr, sk);
+        if (r != 1) // create new
+        {
+            int8_t r = aggregate_socket(addr);
+            if (r == -1)
+                return -1;
+            ports[r]->open(Socket::Mode::CONNECTIONLESS);
+        }
+        else
+        {
+            if (sk->get_state() == Socket::OPEN)
+                return 0; // already opened
+            sk->open(Socket::Mode::CONNECTIONLESS);
+        }
+        return 1;
+    }
+
+    int8_t
+    Node::close_connection(uint8_t addr)
+    {
+        if (addr == self_address)
+            return -1;
+
+        for (uint8_t i = 0; i < ports_count; ++i)
+        {
+            if (ports[i]->get_address() == addr)
+            {
+                ports[i]->close();
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    int8_t
+    Node::send_packet(uint8_t address, const uint8_t *buffer, uint32_t size)
+    {
+        Socket *sk;
+        if (get_socket(address, sk) != 1 || sk->get_state() != Socket::State::OPEN)
+            return -1;
+        return sk->send(buffer, size);
+    }
+
+    bool
+    Node::receive_frame(const uint8_t *frame, uint16_t len)
+    {
+        if (ports_count == 0 || len < SegmentHeader::SIZE)
+            return false;
+
+        SegmentHeader header;
+        header.read(frame);
+        Socket *sk = ports[0];
+        for (uint8_t i = 0; i < ports_count; ++i)
+        {
+            if (ports[i]->get_address() == header.source_addr)
+            {
+                sk = ports[i];
+                break;
+            }
+        }
+        sk->socket_event_handler(Socket::Event::PACKET_ARRIVED_FROM_NETWORK, frame, len, 0);
+        return true;
+    }
+
+    void
+    Node::link_ready()
+    {
+        // the link queue is empty or starting over, held frames still go out
+        uint16_t held = platform.link->reports_sent() ? platform.link->frames_held() : 0;
+        frames_in_link = held < 0xff ? held : 0xff;
+        for (uint8_t i = 0; i < ports_count; ++i)
+        {
+            if (ports[i]->get_state() == Socket::State::OPEN)
+                ports[i]->socket_event_handler(Socket::Event::SPW_READY, nullptr, 0, 0);
+        }
+    }
+
+    void
+    Node::link_down()
+    {
+        for (uint8_t i = 0; i < ports_count; ++i)
+        {
+            if (ports[i]->get_state() == Socket::State::OPEN)
+                ports[i]->socket_event_handler(Socket::Event::LINK_DOWN, nullptr, 0, 0);
+        }
+    }
+
+    void
+    Node::frame_lost(uint8_t addr, const uint8_t *frame, uint16_t len)
+    {
+        if (frames_in_link > 0)
+            frames_in_link--;
+        Socket *sk;
+        if (len < SegmentHeader::SIZE || get_socket(addr, sk) != 1)
+            return;
+        if (sk->get_state() == Socket::State::OPEN)
+            sk->socket_event_handler(Socket::Event::FRAME_LOST, frame, len, 0);
+    }
+
+    void
+    Node::congestion(uint8_t addr, const uint8_t *frame, uint16_t len)
+    {
+        Socket *sk;
+        if (len < SegmentHeader::SIZE || get_socket(addr, sk) != 1)
+            return;
+        if (sk->get_state() == Socket::State::OPEN)
+            sk->socket_event_handler(Socket::Event::CONGESTION, frame, len, 0);
+    }
+
+    void
+    Node::frame_sent(uint8_t addr, const uint8_t *header, uint16_t len)
+    {
+        if (frames_in_link > 0)
+            frames_in_link--;
+        Socket *sk;
+        if (len >= SegmentHeader::SIZE && get_socket(addr, sk) == 1 && sk->get_state() == Socket::State::OPEN)
+            sk->socket_event_handler(Socket::Event::FRAME_SENT, header, len, 0);
+        // top the link up again
+        for (uint8_t i = 0; i < ports_count && link_has_room(); ++i)
+        {
+            if (ports[i]->get_state() == Socket::State::OPEN)
+                ports[i]->peek_from_transmit_fifo();
+        }
+    }
+
+    bool
+    Node::transmit(uint8_t addr, const uint8_t *frame, uint16_t len)
+    {
+        if (!platform.link->transmit(addr, frame, len))
+            return false;
+        if (platform.link->reports_sent() && frames_in_link < 0xff)
+            frames_in_link++;
+        return true;
+    }
+
+    bool
+    Node::link_has_room() const
+    {
+        return !platform.link->reports_sent() || frames_in_link < link_depth;
+    }
+
+    void
+    Node::timer_expired(uint8_t port, TimerService::TimerKind kind, uint8_t seq_n)
+    {
+        if (port < ports_count)
+            ports[port]->timer_handler(kind, seq_n);
+    }
+
+    void
+    Node::set_listener(Listener *l)
+    {
+        upper_handler = l;
+    }
+
+    void
+    Node::deliver(uint8_t src_addr, uint8_t port, const uint8_t *payload, uint16_t len)
+    {
+        if (upper_handler)
+            upper_handler->segment_received(src_addr, port, payload, len);
+    }
+
+    int8_t
+    Node::get_socket(uint8_t addr, Socket *&sk)
+    {
+        for (uint8_t i = 0; i < ports_count; ++i)
+        {
+            if (ports[i]->get_address() == addr)
+            {
+                sk = ports[i];
+                return 1;
+            }
+        }
+        return -1;
+    }
+
+    Socket *
+    Node::get_port(uint8_t port) const
+    {
+        if (port >= ports_count)
+            return nullptr;
+        return ports[port];
+    }
+
+    int8_t
+    Node::aggregate_socket(uint8_t address)
+    {
+        for (uint8_t i = 0; i < ports_count; ++i)
+        {
+            if (!ports[i]->is_aggregated())
+            {
+                ports[i]->set_address(address);
+                ports[i]->set_aggregated(true);
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    uint8_t
+    Node::get_ports_count() const
+    {
+        return ports_count;
+    }
+
+    uint8_t
+    Node::get_address() const
+    {
+        return self_address;
+    }
+
+    const Platform &
+    Node::get_platform() const
+    {
+        return platform;
+    }
+
+    TimerService &
+    Node::get_timer_service()
+    {
+        return timers;
+    }
+
+} // namespace ost
@@ -0,0 +1,144 @@
+#ifndef OST_CORE_NODE_H
+#define OST_CORE_NODE_H
+
+#include "ost_config.h"
+#include "ost_core_socket.h"
+#include "ost_platform.h"
+#include "timer_service.h"
+
+#include <inttypes.h>
+
+namespace ost
+{
+
+    /**
+     * \ingroup ost-core
+     * Transport layer of one SpaceWire node: the sockets of the node, the
+     * demultiplexing of received frames and the node-wide TimerService.
+     *
+     * The platform feeds it with receive_frame() for every frame from the
+     * link, link_down() when the link goes down and link_ready() when it
+     * can take frames again. Messages received in order are passed to the
+     * Listener.
+     *
+     * If the link reports departures with frame_sent(), the sockets keep
+     * at most get_link_depth() frames in it, so data frames do not pile up in
+     * the link queue ahead of retransmissions and ACKs, and retransmission
+     * timers run from the departure of their segment.
+     */
+    class Node : public TimerService::Listener
+    {
+    public:
+        static const uint8_t PORTS_NUMBER = config::MAX_PEERS;
+        static const uint8_t LINK_DEPTH = 2; // default: one frame on the wire, the next one queued
+
+        class Listener
+        {
+        public:
+            virtual ~Listener() {}
+            virtual void segment_received(uint8_t src_addr, uint8_t port, const uint8_t *payload, uint16_t len) = 0;
+        };
+
+        Node(uint8_t address, const Platform &platform);
+        ~Node();
+
+        int8_t start();
+        void shutdown();
+
+        /**
+         * Settings of the sockets, those started later get them too.
+         *
+         * \return 1, -1 if a setting is out of range, see SocketOptions
+         */
+        int8_t set_socket_options(const SocketOptions &o);
+        const SocketOptions &get_socket_options() const;
+
+        /**
+         * \param depth frames the sockets keep in a link reporting departures
+         * \return 1, -1 for 0
+         */
+        int8_t set_link_depth(uint8_t depth);
+        uint8_t get_link_depth() const;
+
+        int8_t open_connection(uint8_t address);
+        int8_t close_connection(uint8_t address);
+        int8_t send_packet(uint8_t address, const uint8_t *buffer, uint32_t size);
+
+        /**
+         * A frame arrived from the link.
+         *
+         * \return false if there is no socket to take it
+         */
+        bool receive_frame(const uint8_t *frame, uint16_t len);
+        void link_ready();
+
+        /**
+         * A frame the link took for dst_addr was lost when the link was
+         * reset. The socket sends it again on the next link_ready()
+         * instead of waiting for its retransmission timer.
+         */
+        void frame_lost(uint8_t dst_addr, const uint8_t *frame, uint16_t len);
+
+        /**
+         * The link is being reset: until link_ready() the sockets hand
+         * nothing to it and their retransmission timers are stopped.
+         */
+        void link_down();
+
+        /**
+         * A frame for dst_addr was dropped or marked by a congested queue
+         * of the link, the socket halves its congestion window. A dropped
+         * frame is reported with frame_lost() as well.
+         */
+        void congestion(uint8_t dst_addr, const uint8_t *frame, uint16_t len);
+
+        /**
+         * A frame for dst_addr has left the link.
+         *
+         * \param header the first SegmentHeader::SIZE bytes of the frame
+         * \param len length of the whole frame
+         */
+        void frame_sent(uint8_t dst_addr, const uint8_t *header, uint16_t len);
+
+        /**
+         * Hand a frame of a socket to the link.
+         *
+         * \return false if the link dropped it
+         */
+        bool transmit(uint8_t dst_addr, const uint8_t *frame, uint16_t len);
+
+        /**
+         * \return false if the link already holds get_link_depth() frames
+         * and reports their departure
+         */
+        bool link_has_room() const;
+        void timer_expired(uint8_t port, TimerService::TimerKind kind, uint8_t seq_n) override;
+
+        void set_listener(Listener *l);
+        void deliver(uint8_t src_addr, uint8_t port, const uint8_t *payload, uint16_t len);
+
+        int8_t get_socket(uint8_t address, Socket *&socket);
+        Socket *get_port(uint8_t port) const;
+        int8_t aggregate_socket(uint8_t address);
+        uint8_t get_ports_count() const;
+        uint8_t get_address() const;
+        const Platform &get_platform() const;
+        TimerService &get_timer_service();
+
+    private:
+        uint8_t self_address;
+        Platform platform;
+        TimerService timers;
+        // sockets are constructed in place by start()
+        alignas(Socket) uint8_t sockets[PORTS_NUMBER][sizeof(Socket)];
+        Socket *ports[PORTS_NUMBER];
+        uint8_t ports_count;
+        uint8_t frames_in_link; // handed to the link and not reported sent or lost
+        uint8_t link_depth;
+        SocketOptions socket_options;
+        Listener *upper_handler;
+    };
+
+} // namespace ost
+
+#endif
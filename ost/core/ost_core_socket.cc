@@ -0,0 +1,943 @@
+#include "ost_core_socket.h"
+
+#include "ost_core_node.h"
+
+#include <string.h>
+
+namespace ost
+{
+
+    template <uint16_t W>
+    int8_t
+    BasicSocket<W>::socket_event_handler(Event e, const uint8_t *seg, uint16_t len, uint8_t seq_n)
+    {
+        switch (e)
+        {
+        case PACKET_ARRIVED_FROM_NETWORK:
+            return segment_arrival_event_socket_handler(seg, len);
+        case APPLICATION_PACKET_READY:
+            return send_to_physical(DTA, (tx_window_top + MAX_SEQ_N - 1) % MAX_SEQ_N);
+        case RETRANSMISSION_INTERRUPT:
+            if (!in_tx_window(seq_n) || acknowledged.test(uint8_t(seq_n - tx_window_bottom)))
+                return -1;
+            stats.retransmissions++;
+            retransmitted[Window::slot(seq_n)] = true;
+            return send_to_physical(DTA, seq_n);
+        case SPW_READY:
+            if (link_down)
+            {
+                link_down = false;
+                restart_timers();
+            }
+            send_pending();
+            peek_from_transmit_fifo();
+            return 1;
+        case FRAME_LOST:
+            return frame_lost_handler(seg, len);
+        case CONGESTION:
+            return congestion_handler(seg, len);
+        case FRAME_SENT:
+            return frame_sent_handler(seg, len);
+        case LINK_DOWN:
+            if (!link_down)
+            {
+                link_down = true;
+                platform.events->cancel(peek_task);
+                freeze_timers();
+            }
+            return 1;
+        default:
+            return -1;
+        }
+        return 1;
+    }
+
+    template <uint16_t W>
+    BasicSocket<W>::BasicSocket(Node &parent, uint8_t port)
+        : ost(parent),
+          platform(parent.get_platform()),
+          options(parent.get_socket_options()),
+          mode(CONNECTIONLESS),
+          state(State::CLOSED),
+          to_address(parent.get_address()),
+          self_port(port),
+          to_retr(0),
+          tx_window_bottom(0),
+          tx_window_top(0),
+          rx_window_bottom(0),
+          transmit_fifo_head(0),
+          transmit_fifo_size(0),
+          timers(parent.get_timer_service()),
+          peek_task(*this),
+          aggregated(false),
+          link_down(false),
+          cwnd(options.window),
+          cwnd_acked(0),
+          recovering(false),
+          recover(0),
+          srtt_us(0),
+          rttvar_us(0)
+    {
+        memset(transmit_fifo, 0, sizeof(transmit_fifo));
+        memset(tx_window, 0, sizeof(tx_window));
+        memset(rx_window, 0, sizeof(rx_window));
+        memset(retransmitted, 0, sizeof(retransmitted));
+        memset(pending, 0, sizeof(pending));
+        memset(pending_acks, 0, sizeof(pending_acks));
+        memset(sent_at, 0, sizeof(sent_at));
+        memset(&stats, 0, sizeof(stats));
+    }
+
+    template <uint16_t W>
+    BasicSocket<W>::~BasicSocket()
+    {
+        platform.events->cancel(peek_task);
+        timers.cancel_port(self_port);
+        flush();
+    }
+
+    template <uint16_t W>
+    SocketOptions
+    BasicSocket<W>::default_options()
+    {
+        SocketOptions o;
+        o.window = W;
+        o.transmit_fifo_sz = TRANSMIT_FIFO_SZ;
+        o.mtu = config::MTU;
+        o.rto_initial = DURATION_RETRANSMISSON;
+        o.rto_min = DURATION_RETRANSMISSON;
+        o.rto_max = DURATION_RETRANSMISSON;
+        o.ack_policy = ACK_EACH;
+        o.ack_delay = 100;
+        return o;
+    }
+
+    template <uint16_t W>
+    bool
+    BasicSocket<W>::valid_options(const SocketOptions &o)
+    {
+        return o.window >= 1 && o.window <= W &&
+               o.transmit_fifo_sz >= 1 && o.transmit_fifo_sz <= TRANSMIT_FIFO_SZ &&
+               o.mtu > SegmentHeader::SIZE && o.mtu <= config::MTU &&
+               o.rto_initial <= MAX_TIMER_DURATION && o.rto_min <= MAX_TIMER_DURATION &&
+               o.rto_max <= MAX_TIMER_DURATION && o.ack_delay <= MAX_TIMER_DURATION &&
+               (o.ack_policy == ACK_EACH || o.ack_policy == ACK_DELAYED);
+    }
+
+    template <uint16_t W>
+    int8_t
+    BasicSocket<W>::set_options(const SocketOptions &o)
+    {
+        if (!valid_options(o))
+            return -1;
+        // an idle window follows the new size, a reduced one keeps growing towards it
+        if (cwnd > o.window || (cwnd == options.window && !recovering))
+            cwnd = o.window;
+        bool flush_acks = options.ack_policy == ACK_DELAYED && o.ack_policy == ACK_EACH;
+        options = o;
+        if (flush_acks && !link_down)
+            send_held_acks();
+        return 1;
+    }
+
+    template <uint16_t W>
+    const SocketOptions &
+    BasicSocket<W>::get_options() const
+    {
+        return options;
+    }
+
+    template <uint16_t W>
+    micros_t
+    BasicSocket<W>::get_retransmission_timeout() const
+    {
+        micros_t rto = stats.rtt_samples ? srtt_us + 4 * rttvar_us : options.rto_initial;
+        if (rto < options.rto_min)
+            rto = options.rto_min;
+        if (rto > options.rto_max)
+            rto = options.rto_max;
+        return rto;
+    }
+
+    template <uint16_t W>
+    int8_t
+    BasicSocket<W>::open(Mode sk_mode)
+    {
+        mode = sk_mode;
+        if (mode == CONNECTIONLESS)
+        {
+            set_state(OPEN);
+        }
+        else
+        {
+            return -1;
+        }
+        return 1;
+    }
+
+    template <uint16_t W>
+    int8_t
+    BasicSocket<W>::close()
+    {
+        if (mode != CONNECTIONLESS)
+        {
+            set_state(CLOSE_WAIT);
+            send_rejection(0);
+        }
+        else
+        {
+            set_state(CLOSED);
+        }
+        platform.events->cancel(peek_task);
+        timers.cancel_port(self_port);
+        flush();
+        tx_window_bottom = 0;
+        tx_window_top = 0;
+        rx_window_bottom = 0;
+        to_retr = 0;
+
+        return 1;
+    }
+
+    template <uint16_t W>
+    int8_t
+    BasicSocket<W>::send(const uint8_t *buffer, uint32_t size)
+    {
+        if (state != OPEN)
+            return -1;
+
+        if (size > options.mtu - SegmentHeader::SIZE)
+            return -2;
+
+        if (transmit_fifo_size >= options.transmit_fifo_sz)
+            return -3;
+
+        uint8_t *data = platform.buffers->alloc(SegmentHeader::SIZE + size);
+        if (!data)
+            return -3;
+
+        SegmentHeader header(0, ost.get_address(), size);
+        header.set_flag(DTA);
+        header.write(data);
+        memcpy(data + SegmentHeader::SIZE, buffer, size);
+
+        Segment &s = transmit_fifo[(transmit_fifo_head + transmit_fifo_size) % TRANSMIT_FIFO_SZ];
+        s.data = data;
+        s.len = SegmentHeader::SIZE + size;
+        transmit_fifo_size++;
+
+        if (!link_down && platform.link->is_ready())
+        {
+            platform.events->post(peek_task, 0);
+            return 1;
+        }
+        return 0;
+    }
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::peek_from_transmit_fifo()
+    {
+        if (!link_down && transmit_fifo_size != 0 && tx_sliding_window_have_space() && ost.link_has_room())
+        {
+            Segment &s = transmit_fifo[transmit_fifo_head];
+            if (add_packet_to_tx(s) != -1)
+            {
+                s.data = nullptr;
+                transmit_fifo_head = (transmit_fifo_head + 1) % TRANSMIT_FIFO_SZ;
+                transmit_fifo_size--;
+                socket_event_handler(APPLICATION_PACKET_READY, nullptr, 0, 0);
+                if (transmit_fifo_size != 0)
+                    platform.events->post(peek_task, PEEK_INTERVAL);
+            }
+        }
+    }
+
+    template <uint16_t W>
+    int8_t
+    BasicSocket<W>::add_packet_to_tx(Segment s)
+    {
+        if (tx_sliding_window_have_space())
+        {
+            uint8_t slot = Window::slot(tx_window_top);
+            SegmentHeader::write_seq_number(s.data, tx_window_top);
+            tx_window[slot] = s;
+            retransmitted[slot] = false;
+            pending[slot] = false;
+            sent_at[slot] = platform.clock->now_us();
+            tx_window_top = (tx_window_top + 1) % MAX_SEQ_N;
+            return 1;
+        }
+        return -1;
+    }
+
+    template <uint16_t W>
+    uint8_t
+    BasicSocket<W>::get_address() const
+    {
+        return to_address;
+    }
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::set_address(uint8_t addr)
+    {
+        to_address = addr;
+    }
+
+    template <uint16_t W>
+    typename BasicSocket<W>::State
+    BasicSocket<W>::get_state() const
+    {
+        return state;
+    }
+
+    template <uint16_t W>
+    typename BasicSocket<W>::Mode
+    BasicSocket<W>::get_mode() const
+    {
+        return mode;
+    }
+
+    template <uint16_t W>
+    bool
+    BasicSocket<W>::is_aggregated() const
+    {
+        return aggregated;
+    }
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::set_aggregated(bool aggr)
+    {
+        aggregated = aggr;
+    }
+
+    template <uint16_t W>
+    uint8_t
+    BasicSocket<W>::get_port() const
+    {
+        return self_port;
+    }
+
+    template <uint16_t W>
+    const SocketStats &
+    BasicSocket<W>::get_stats() const
+    {
+        return stats;
+    }
+
+    template <uint16_t W>
+    uint16_t
+    BasicSocket<W>::get_transmit_fifo_size() const
+    {
+        return transmit_fifo_size;
+    }
+
+    template <uint16_t W>
+    uint16_t
+    BasicSocket<W>::get_segments_in_flight() const
+    {
+        return uint8_t(tx_window_top - tx_window_bottom);
+    }
+
+    template <uint16_t W>
+    uint16_t
+    BasicSocket<W>::get_congestion_window() const
+    {
+        return cwnd;
+    }
+
+    template <uint16_t W>
+    int8_t
+    BasicSocket<W>::segment_arrival_event_socket_handler(const uint8_t *seg, uint16_t len)
+    {
+        if (len < SegmentHeader::SIZE)
+            return -1;
+
+        if (mode == CONNECTIONLESS)
+        {
+            SegmentHeader header;
+            header.read(seg);
+
+            if (header.is_ack())
+            {
+                if (in_tx_window(header.seq_number) &&
+                    !acknowledged.test(uint8_t(header.seq_number - tx_window_bottom)))
+                {
+                    mark_packet_ack(header.seq_number);
+                }
+            }
+            else
+            {
+                if (header.payload_length > len - SegmentHeader::SIZE)
+                    return -1;
+                if (in_rx_window(header.seq_number) &&
+                    !received.test(uint8_t(header.seq_number - rx_window_bottom)))
+                {
+                    // without a copy kept the segment must come again
+                    if (mark_packet_receipt(header.seq_number, seg, len) != 1)
+                        return -1;
+                }
+                else
+                {
+                    stats.duplicates_received++;
+                }
+                acknowledge(header.seq_number);
+            }
+            return 1;
+        }
+        else
+        {
+            full_states_handler(seg, len);
+        }
+        return -1;
+    }
+
+    template <uint16_t W>
+    int8_t
+    BasicSocket<W>::frame_lost_handler(const uint8_t *seg, uint16_t len)
+    {
+        if (len < SegmentHeader::SIZE)
+            return -1;
+        SegmentHeader header;
+        header.read(seg);
+        stats.frames_lost++;
+        if (header.is_ack())
+        {
+            pending_acks[header.seq_number / 64] |= uint64_t(1) << (header.seq_number % 64);
+            return 1;
+        }
+        // only the copy still waiting for its acknowledgement is worth sending
+        uint8_t slot = Window::slot(header.seq_number);
+        if (!in_tx_window(header.seq_number) ||
+            acknowledged.test(uint8_t(header.seq_number - tx_window_bottom)) ||
+            !tx_window[slot].data || tx_window[slot].len != len ||
+            memcmp(tx_window[slot].data, seg, len) != 0)
+        {
+            return -1;
+        }
+        pending[slot] = true;
+        return 1;
+    }
+
+    template <uint16_t W>
+    int8_t
+    BasicSocket<W>::congestion_handler(const uint8_t *seg, uint16_t len)
+    {
+        if (len < SegmentHeader::SIZE)
+            return -1;
+        SegmentHeader header;
+        header.read(seg);
+        stats.congestion_signals++;
+        if (!header.is_dta() || !in_tx_window(header.seq_number))
+            return -1;
+        // the window already shrank for the queue that segment sat in
+        if (recovering && seq_in_window(tx_window_bottom, recover, header.seq_number))
+            return 1;
+        cwnd = cwnd > 1 ? cwnd / 2 : 1;
+        cwnd_acked = 0;
+        recovering = true;
+        recover = tx_window_top;
+        stats.window_reductions++;
+        return 1;
+    }
+
+    template <uint16_t W>
+    int8_t
+    BasicSocket<W>::frame_sent_handler(const uint8_t *seg, uint16_t len)
+    {
+        if (len < SegmentHeader::SIZE)
+            return -1;
+        SegmentHeader header;
+        header.read(seg);
+        if (link_down || !header.is_dta() || !in_tx_window(header.seq_number))
+            return -1;
+        uint8_t slot = Window::slot(header.seq_number);
+        if (acknowledged.test(uint8_t(header.seq_number - tx_window_bottom)) || tx_window[slot].len != len)
+            return -1;
+        if (!retransmitted[slot])
+            sent_at[slot] = platform.clock->now_us();
+        timers.cancel_timer(self_port, TimerService::RETRANSMISSION, header.seq_number);
+        timers.add_timer(self_port, TimerService::RETRANSMISSION, header.seq_number, get_retransmission_timeout());
+        return 1;
+    }
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::send_pending()
+    {
+        send_held_acks();
+        for (uint8_t seq_n = tx_window_bottom; seq_n != tx_window_top; ++seq_n)
+        {
+            uint8_t slot = Window::slot(seq_n);
+            if (!pending[slot])
+                continue;
+            pending[slot] = false;
+            if (acknowledged.test(uint8_t(seq_n - tx_window_bottom)))
+                continue;
+            timers.cancel_timer(self_port, TimerService::RETRANSMISSION, seq_n);
+            stats.retransmissions++;
+            retransmitted[slot] = true;
+            send_to_physical(DTA, seq_n);
+        }
+    }
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::acknowledge(uint8_t seq_n)
+    {
+        if (options.ack_policy == ACK_EACH || link_down)
+        {
+            send_to_physical(ACK, seq_n);
+            return;
+        }
+        pending_acks[seq_n / 64] |= uint64_t(1) << (seq_n % 64);
+        if (!timers.is_pending(self_port, TimerService::DELAYED_ACK, 0) &&
+            timers.add_timer(self_port, TimerService::DELAYED_ACK, 0, options.ack_delay) != 1)
+        {
+            send_held_acks();
+        }
+    }
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::send_held_acks()
+    {
+        // only with the link up, send_to_physical would hold them again
+        timers.cancel_timer(self_port, TimerService::DELAYED_ACK, 0);
+        for (uint16_t i = 0; i < MAX_SEQ_N / 64; ++i)
+        {
+            while (pending_acks[i])
+            {
+                uint8_t seq_n = i * 64 + count_trailing_ones(~pending_acks[i]); // lowest set bit
+                pending_acks[i] &= pending_acks[i] - 1;
+                send_to_physical(ACK, seq_n);
+            }
+        }
+    }
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::freeze_timers()
+    {
+        for (uint8_t seq_n = tx_window_bottom; seq_n != tx_window_top; ++seq_n)
+        {
+            if (!acknowledged.test(uint8_t(seq_n - tx_window_bottom)))
+                timers.cancel_timer(self_port, TimerService::RETRANSMISSION, seq_n);
+        }
+    }
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::restart_timers()
+    {
+        // the ones sent again get a new timer from send_to_physical
+        for (uint8_t seq_n = tx_window_bottom; seq_n != tx_window_top; ++seq_n)
+        {
+            if (!acknowledged.test(uint8_t(seq_n - tx_window_bottom)) && !pending[Window::slot(seq_n)])
+                timers.add_timer(self_port, TimerService::RETRANSMISSION, seq_n, get_retransmission_timeout());
+        }
+    }
+
+    template <uint16_t W>
+    int8_t
+    BasicSocket<W>::mark_packet_ack(uint8_t seq_n)
+    {
+        uint8_t offset = seq_n - tx_window_bottom;
+        if (!acknowledged.test(offset))
+        {
+            uint8_t slot = Window::slot(seq_n);
+            acknowledged.set(offset);
+            stats.acks_received++;
+            if (!retransmitted[slot])
+            {
+                micros_t rtt = platform.clock->now_us() - sent_at[slot];
+                if (stats.rtt_samples == 0)
+                {
+                    srtt_us = rtt;
+                    rttvar_us = rtt / 2;
+                }
+                else
+                {
+                    micros_t err = srtt_us > rtt ? srtt_us - rtt : rtt - srtt_us;
+                    rttvar_us = (3 * rttvar_us + err) / 4;
+                    srtt_us = (7 * srtt_us + rtt) / 8;
+                }
+                stats.rtt_sum_us += rtt;
+                stats.rtt_samples++;
+            }
+            timers.cancel_timer(self_port, TimerService::RETRANSMISSION, seq_n);
+            if (cwnd < options.window && ++cwnd_acked >= cwnd)
+            {
+                cwnd++;
+                cwnd_acked = 0;
+            }
+            for (uint16_t n = acknowledged.advance(); n != 0; --n)
+            {
+                release(tx_window[Window::slot(tx_window_bottom)]);
+                tx_window_bottom++;
+                if (tx_window_bottom == recover)
+                    recovering = false;
+            }
+            peek_from_transmit_fifo();
+        }
+        return 1;
+    }
+
+    template <uint16_t W>
+    int8_t
+    BasicSocket<W>::mark_packet_receipt(uint8_t seq_n, const uint8_t *seg, uint16_t len)
+    {
+        uint8_t offset = seq_n - rx_window_bottom;
+        if (!received.test(offset))
+        {
+            uint8_t *data = platform.buffers->alloc(len);
+            if (!data)
+                return -1;
+            memcpy(data, seg, len);
+            Segment &s = rx_window[Window::slot(seq_n)];
+            s.data = data;
+            s.len = len;
+            received.set(offset);
+            stats.segments_received++;
+            for (uint16_t n = received.advance(); n != 0; --n)
+            {
+                Segment &next = rx_window[Window::slot(rx_window_bottom)];
+                rx_window_bottom++;
+                send_to_application(next);
+                release(next);
+            }
+        }
+        return 1;
+    }
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::send_rejection(uint8_t seq_n) {};
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::send_syn(uint8_t seq_n) {};
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::send_syn_confirm(uint8_t seq_n) {};
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::send_confirm(uint8_t seq_n) {};
+
+    template <uint16_t W>
+    int8_t
+    BasicSocket<W>::send_to_physical(SegmentFlag f, uint8_t seq_n)
+    {
+        if (link_down)
+        {
+            // the link would only queue it, hold it until SPW_READY
+            if (f == ACK)
+                pending_acks[seq_n / 64] |= uint64_t(1) << (seq_n % 64);
+            else if (in_tx_window(seq_n))
+                pending[Window::slot(seq_n)] = true;
+            return 0;
+        }
+        if (f == ACK)
+        {
+            uint8_t ack[SegmentHeader::SIZE];
+            SegmentHeader header(seq_n, ost.get_address(), 0);
+            header.set_flag(ACK);
+            header.write(ack);
+            send_spw(ack, sizeof(ack));
+        }
+        else
+        {
+            const Segment &s = tx_window[Window::slot(seq_n)];
+            if (!s.data)
+                return -1;
+            SegmentHeader header;
+            header.read(s.data);
+            if (header.payload_length == 0 || !header.is_dta() || header.seq_number != seq_n ||
+                header.source_addr != ost.get_address())
+            {
+                // trying transmit wrong packet from buffer
+                return -1;
+            }
+            send_spw(s.data, s.len);
+            if (!retransmitted[Window::slot(seq_n)])
+                stats.segments_sent++;
+            if (timers.add_timer(self_port, TimerService::RETRANSMISSION, seq_n, get_retransmission_timeout()) != 1)
+                return -1;
+        }
+        return 1;
+    }
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::send_spw(const uint8_t *segment, uint16_t len)
+    {
+        ost.transmit(to_address, segment, len);
+    }
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::start_close_wait_timer() {};
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::stop_close_wait_timer() {};
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::dealloc()
+    {
+        flush();
+    };
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::send_to_application(const Segment &segment)
+    {
+        SegmentHeader header;
+        header.read(segment.data);
+        ost.deliver(to_address, self_port, segment.data + SegmentHeader::SIZE, header.payload_length);
+    }
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::release(Segment &s)
+    {
+        platform.buffers->release(s.data);
+        s.data = nullptr;
+        s.len = 0;
+    }
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::flush()
+    {
+        for (uint16_t i = 0; i < Window::SLOTS; ++i)
+        {
+            release(tx_window[i]);
+            release(rx_window[i]);
+        }
+        acknowledged.reset();
+        received.reset();
+        memset(pending, 0, sizeof(pending));
+        memset(pending_acks, 0, sizeof(pending_acks));
+        for (uint16_t i = 0; i < TRANSMIT_FIFO_SZ; ++i)
+        {
+            release(transmit_fifo[i]);
+        }
+        transmit_fifo_head = 0;
+        transmit_fifo_size = 0;
+        cwnd = options.window;
+        cwnd_acked = 0;
+        recovering = false;
+    }
+
+    template <uint16_t W>
+    bool
+    BasicSocket<W>::in_tx_window(uint8_t seq_n) const
+    {
+        return seq_in_window(tx_window_bottom, tx_window_top, seq_n);
+    }
+
+    template <uint16_t W>
+    bool
+    BasicSocket<W>::in_rx_window(uint8_t seq_n) const
+    {
+        return Window::contains(rx_window_bottom, seq_n);
+    }
+
+    template <uint16_t W>
+    bool
+    BasicSocket<W>::tx_sliding_window_have_space() const
+    {
+        return window_have_space(tx_window_bottom, tx_window_top, cwnd);
+    }
+
+    template <uint16_t W>
+    const char *
+    BasicSocket<W>::get_state_name(State s)
+    {
+        switch (s)
+        {
+        case CLOSED:
+            return "CLOSED";
+        case SYN_SENT:
+            return "SYN-SENT";
+        case SYN_RCVD:
+            return "SYN-RCVD";
+        case LISTEN:
+            return "LISTEN";
+        case OPEN:
+            return "OPEN";
+        case CLOSE_WAIT:
+            return "CLOSE-WAIT";
+        default:
+            return "bad";
+        }
+    }
+
+    template <uint16_t W>
+    int8_t
+    BasicSocket<W>::full_states_handler(const uint8_t *seg, uint16_t len)
+    {
+        SegmentHeader hd;
+        hd.read(seg);
+        switch (state)
+        {
+        case State::CLOSED:
+            if (hd.is_rst())
+                ;
+            else
+                send_rejection(0);
+            break;
+        case State::CLOSE_WAIT:
+            if (hd.is_rst())
+            {
+                set_state(State::CLOSED);
+                stop_close_wait_timer();
+                dealloc();
+            }
+            break;
+        case State::LISTEN:
+            if (hd.is_ack() or hd.is_dta())
+                send_rejection(0);
+            else if (hd.is_syn())
+            {
+                tx_window_bottom = hd.seq_number;
+                tx_window_top = hd.seq_number;
+                rx_window_bottom = hd.seq_number;
+                send_syn_confirm(hd.seq_number);
+                set_state(State::SYN_RCVD);
+            }
+            break;
+        case State::SYN_SENT:
+            if (hd.is_syn())
+            {
+                tx_window_bottom = hd.seq_number;
+                tx_window_top = hd.seq_number;
+                rx_window_bottom = hd.seq_number;
+                if (hd.is_ack())
+                {
+                    send_confirm(hd.seq_number);
+                    set_state(State::OPEN);
+                }
+                else
+                {
+                    send_syn_confirm(hd.seq_number);
+                    set_state(State::SYN_RCVD);
+                }
+            }
+            else if (hd.is_rst())
+            {
+                set_state(State::CLOSED);
+                dealloc();
+            }
+            else if (hd.is_ack())
+            {
+                if (hd.seq_number != tx_window_bottom)
+                {
+                    send_rejection(0);
+                    start_close_wait_timer();
+                    set_state(State::CLOSE_WAIT);
+                }
+            }
+        case State::SYN_RCVD:
+            if (hd.is_rst())
+            {
+                if (mode)
+                {
+                    set_state(State::CLOSED);
+                    dealloc();
+                }
+                else
+                {
+                    set_state(State::LISTEN);
+                }
+            }
+            else if (hd.is_syn() || hd.is_dta())
+            {
+                send_rejection(0);
+                start_close_wait_timer();
+                set_state(State::CLOSE_WAIT);
+            }
+            else if (hd.is_ack())
+            {
+                if (hd.seq_number == tx_window_bottom)
+                {
+                    set_state(State::OPEN);
+                }
+                else
+                {
+                    send_rejection(0);
+                    start_close_wait_timer();
+                    set_state(State::CLOSE_WAIT);
+                }
+            }
+            break;
+        case State::OPEN:
+            if (hd.is_rst())
+            {
+                start_close_wait_timer();
+                set_state(State::CLOSE_WAIT);
+            }
+            else if (hd.is_syn())
+            {
+                send_rejection(0);
+                start_close_wait_timer();
+                set_state(State::CLOSE_WAIT);
+            }
+            else if (hd.is_ack())
+            {
+                if (in_tx_window(hd.seq_number))
+                {
+                    mark_packet_ack(hd.seq_number);
+                }
+            }
+            else if (hd.is_dta())
+            {
+                if (in_rx_window(hd.seq_number))
+                {
+                    mark_packet_receipt(hd.seq_number, seg, len);
+                }
+                send_confirm(hd.seq_number);
+            }
+            break;
+        default:
+            break;
+        }
+        return 0;
+    }
+
+    template <uint16_t W>
+    bool
+    BasicSocket<W>::timer_handler(TimerService::TimerKind kind, uint8_t seq_n)
+    {
+        switch (kind)
+        {
+        case TimerService::RETRANSMISSION:
+            socket_event_handler(RETRANSMISSION_INTERRUPT, nullptr, 0, seq_n);
+            return true;
+        case TimerService::DELAYED_ACK:
+            // while the link is down they wait for SPW_READY
+            if (!link_down)
+                send_held_acks();
+            return true;
+        default:
+            // keepalive is not armed by the connectionless mode
+            return false;
+        }
+    }
+
+    template <uint16_t W>
+    void
+    BasicSocket<W>::set_state(State s)
+    {
+        state = s;
+    }
+
+    template class BasicSocket<config::WINDOW_SZ>;
+
+} // namespace ost
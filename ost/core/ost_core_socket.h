@@ -0,0 +1,292 @@
+#ifndef OST_CORE_SOCKET_H
+#define OST_CORE_SOCKET_H
+
+#include "ost_config.h"
+#include "ost_platform.h"
+#include "ost_segment.h"
+#include "sliding_window.h"
+#include "timer_service.h"
+
+#include <inttypes.h>
+
+namespace ost
+{
+
+    class Node;
+
+    /**
+     * \ingroup ost-core
+     * Counters of a socket.
+     *
+     * rtt_sum_us / rtt_samples is the mean time from the first transmission
+     * of a segment, or its departure if the link reports it, to its
+     * acknowledgement, retransmitted segments are not sampled (Karn).
+     * frames_lost counts the frames the link reported lost, the segments
+     * sent again for them count as retransmissions.
+     * congestion_signals counts the frames the link queue dropped or marked
+     * for congestion, window_reductions how many of them halved the
+     * congestion window.
+     */
+    struct SocketStats
+    {
+        uint32_t segments_sent;
+        uint32_t retransmissions;
+        uint32_t acks_received;
+        uint32_t segments_received;
+        uint32_t duplicates_received;
+        uint64_t rtt_sum_us;
+        uint32_t rtt_samples;
+        uint32_t frames_lost;
+        uint32_t congestion_signals;
+        uint32_t window_reductions;
+    };
+
+    /**
+     * \ingroup ost-core
+     * How a socket acknowledges the segments it receives.
+     */
+    typedef enum
+    {
+        ACK_EACH = 0, // an ACK as soon as the segment arrives
+        ACK_DELAYED   // ACKs held for up to ack_delay, then sent together
+    } AckPolicy;
+
+    /**
+     * \ingroup ost-core
+     * Runtime settings of a socket. The capacities of ost_config.h are
+     * their upper bounds: window up to the window the socket is built
+     * for, transmit_fifo_sz up to config::TRANSMIT_FIFO_SZ and mtu, the
+     * frame with its header, up to config::MTU.
+     *
+     * The retransmission timeout is rto_initial until the first round
+     * trip is measured, then srtt + 4 * rttvar (RFC 6298) kept between
+     * rto_min and rto_max, rto_max wins if they cross. rto_min == rto_max
+     * fixes it.
+     */
+    struct SocketOptions
+    {
+        uint16_t window;
+        uint16_t transmit_fifo_sz;
+        uint32_t mtu;
+        micros_t rto_initial;
+        micros_t rto_min;
+        micros_t rto_max;
+        AckPolicy ack_policy;
+        micros_t ack_delay;
+    };
+
+    /**
+     * \ingroup ost-core
+     * Protocol engine of one OST connection.
+     *
+     * Sliding window over the 0..255 sequence space: segments wait in the
+     * transmit fifo until there is room in the tx window, every segment in
+     * the tx window has a retransmission timer in the TimerService of the
+     * node, received segments are acknowledged one by one and passed to the
+     * application in order.
+     *
+     * The window size W is a template parameter: segments of the windows
+     * are kept in WindowBitmap<W>::SLOTS entries addressed with a mask and
+     * acknowledgement and receipt are machine-word bitmaps, so a run of
+     * acknowledged segments leaves the window at once. The engine is built
+     * for config::WINDOW_SZ, see Socket.
+     *
+     * Between LINK_DOWN and SPW_READY nothing is handed to the link: the
+     * retransmission timers are stopped, new segments stay in the transmit
+     * fifo and ACKs are held. On SPW_READY the held ACKs and the segments
+     * reported lost go out in sequence order and the timers start again.
+     *
+     * A CONGESTION event for one of its segments halves the congestion
+     * window, which caps the segments in flight below the window. Signals
+     * for segments sent before the last reduction are ignored, every
+     * window of acknowledged segments opens it by one again.
+     *
+     * New segments are taken from the transmit fifo only while the node
+     * has room in the link. On FRAME_SENT the retransmission timer of the
+     * segment starts over from its departure.
+     */
+    template <uint16_t W>
+    class BasicSocket
+    {
+    public:
+        static const uint16_t MAX_SEQ_N = 256; // in fact range 0..255
+        static const uint16_t WINDOW_SZ = W;
+        static const micros_t DURATION_RETRANSMISSON = 2000000; // 2 secs
+        static const uint16_t TRANSMIT_FIFO_SZ = config::TRANSMIT_FIFO_SZ;
+        static const micros_t PEEK_INTERVAL = 10;
+        static const uint32_t MAX_PAYLOAD = config::MTU - SegmentHeader::SIZE;
+
+        typedef enum
+        {
+            CONNECTIONLESS = 0,
+            CONNECTION_ACTIVE,
+            CONNECTION_PASSIVE
+        } Mode;
+
+        typedef enum
+        {
+            CLOSED = 0,
+            LISTEN,
+            SYN_SENT,
+            SYN_RCVD,
+            OPEN,
+            CLOSE_WAIT,
+        } State;
+
+        typedef enum
+        {
+            PACKET_ARRIVED_FROM_NETWORK = 0,
+            APPLICATION_PACKET_READY,
+            RETRANSMISSION_INTERRUPT,
+            SPW_READY,
+            FRAME_LOST,
+            LINK_DOWN,
+            CONGESTION,
+            FRAME_SENT
+        } Event;
+
+        BasicSocket(Node &parent, uint8_t port);
+        ~BasicSocket();
+
+        /**
+         * \return the settings the ost_config.h defaults stand for: full
+         * window and fifo, config::MTU, a fixed DURATION_RETRANSMISSON
+         * timeout and an ACK for each segment
+         */
+        static SocketOptions default_options();
+
+        /**
+         * \return false if a setting is out of its range
+         */
+        static bool valid_options(const SocketOptions &o);
+
+        /**
+         * Change the settings, the segments already in flight and queued
+         * stay. A smaller transmit fifo takes new messages once it has
+         * drained below its size.
+         *
+         * \return 1, -1 if a setting is out of range
+         */
+        int8_t set_options(const SocketOptions &o);
+        const SocketOptions &get_options() const;
+
+        /**
+         * \return the timeout the next retransmission timer gets
+         */
+        micros_t get_retransmission_timeout() const;
+
+        int8_t open(Mode mode);
+        int8_t close();
+
+        /**
+         * Queue a message for transmission.
+         *
+         * \return 1 if the link is ready and transmission started, 0 if the
+         * message waits for the link, -1 if the socket is not open, -2 if
+         * the message is too long, -3 if there is no room for it
+         */
+        int8_t send(const uint8_t *buffer, uint32_t size);
+        int8_t socket_event_handler(const Event e, const uint8_t *seg, uint16_t len, uint8_t seq_n);
+        bool timer_handler(TimerService::TimerKind kind, uint8_t seq_n);
+        void peek_from_transmit_fifo();
+
+        uint8_t get_address() const;
+        void set_address(uint8_t);
+        uint8_t get_port() const;
+        State get_state() const;
+        Mode get_mode() const;
+        bool is_aggregated() const;
+        void set_aggregated(bool);
+        const SocketStats &get_stats() const;
+        uint16_t get_transmit_fifo_size() const;
+        uint16_t get_segments_in_flight() const;
+        uint16_t get_congestion_window() const;
+        static const char *get_state_name(State);
+
+    private:
+        class PeekTask : public Task
+        {
+        public:
+            PeekTask(BasicSocket &s) : socket(s) {}
+            void run() override { socket.peek_from_transmit_fifo(); }
+
+        private:
+            BasicSocket &socket;
+        };
+
+        int8_t segment_arrival_event_socket_handler(const uint8_t *seg, uint16_t len);
+        int8_t frame_lost_handler(const uint8_t *seg, uint16_t len);
+        int8_t congestion_handler(const uint8_t *seg, uint16_t len);
+        int8_t frame_sent_handler(const uint8_t *seg, uint16_t len);
+        void send_pending();
+        void acknowledge(uint8_t seq_n);
+        void send_held_acks();
+        void freeze_timers();
+        void restart_timers();
+        int8_t send_to_physical(SegmentFlag f, uint8_t seg_n);
+        void send_spw(const uint8_t *segment, uint16_t len);
+        void send_rejection(uint8_t seq_n);
+        void send_syn(uint8_t seq_n);
+        void send_syn_confirm(uint8_t seq_n);
+        void send_confirm(uint8_t seq_n);
+        void start_close_wait_timer();
+        void stop_close_wait_timer();
+        void dealloc();
+        bool in_rx_window(uint8_t) const;
+        void send_to_application(const Segment &segment);
+        int8_t mark_packet_receipt(uint8_t seq_n, const uint8_t *seg, uint16_t len);
+        bool in_tx_window(uint8_t) const;
+        bool tx_sliding_window_have_space() const;
+        int8_t add_packet_to_tx(Segment s);
+        int8_t mark_packet_ack(uint8_t seq_n);
+        int8_t full_states_handler(const uint8_t *seg, uint16_t len);
+        void set_state(State);
+        void release(Segment &s);
+        void flush();
+
+        Node &ost;
+        Platform platform;
+        typedef WindowBitmap<W> Window;
+
+        SocketOptions options;
+        Mode mode;
+        State state;
+        uint8_t to_address;
+        uint8_t self_port;
+        uint8_t to_retr;
+        uint8_t tx_window_bottom;
+        uint8_t tx_window_top;
+        uint8_t rx_window_bottom;
+        Segment transmit_fifo[TRANSMIT_FIFO_SZ];
+        uint16_t transmit_fifo_head;
+        uint16_t transmit_fifo_size;
+        Segment tx_window[Window::SLOTS];
+        Segment rx_window[Window::SLOTS];
+        Window acknowledged;
+        Window received;
+        bool retransmitted[Window::SLOTS];
+        bool pending[Window::SLOTS];           // sent on SPW_READY
+        uint64_t pending_acks[MAX_SEQ_N / 64]; // same for ACKs and delayed ACKs, by sequence number
+        uint64_t sent_at[Window::SLOTS];
+        TimerService &timers;
+        PeekTask peek_task;
+        bool aggregated;
+        bool link_down;
+        uint16_t cwnd;       // segments allowed in flight, at most options.window
+        uint16_t cwnd_acked; // acknowledged since cwnd last grew
+        bool recovering;     // a reduction waits for the segments sent before it
+        uint8_t recover;     // tx_window_top at the last reduction
+        micros_t srtt_us;
+        micros_t rttvar_us;
+        SocketStats stats;
+    };
+
+    /**
+     * \ingroup ost-core
+     * Socket of the configured window size, the one Node is made of.
+     */
+    typedef BasicSocket<config::WINDOW_SZ> Socket;
+
+} // namespace ost
+
+#endif
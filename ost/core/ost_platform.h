@@ -0,0 +1,202 @@
+#ifndef OST_PLATFORM_H
+#define OST_PLATFORM_H
+
+#include "ost_types.h"
+
+#include <stddef.h>
+
+/**
+ * \ingroup ost
+ * \defgroup ost-core Portable protocol engine
+ *
+ * The OST engine (ost::Node, ost::Socket, ost::TimerService) depends on
+ * nothing but the interfaces below. The ns-3 model implements them on top
+ * of Simulator and SpWDevice, ost/core/native implements them for a plain
+ * Linux process, and the target implements them on its interval timer and
+ * SpaceWire controller.
+ *
+ * The engine is single threaded and run to completion: every call into it
+ * (a received frame, an expired timer, a posted task, an application send)
+ * must return before the next one is made.
+ */
+namespace ost
+{
+
+    /**
+     * \ingroup ost-core
+     * Monotonic time, used for statistics only. The engine never decides
+     * anything by reading the clock, timers are what drives it.
+     */
+    class Clock
+    {
+    public:
+        virtual ~Clock() {}
+        virtual uint64_t now_us() const = 0;
+    };
+
+    /**
+     * \ingroup ost-core
+     * Unit of deferred work.
+     */
+    class Task
+    {
+    public:
+        virtual ~Task() {}
+        virtual void run() = 0;
+    };
+
+    /**
+     * \ingroup ost-core
+     * Deferred execution, the replacement of Simulator::Schedule. On the
+     * target it is the main loop that runs outside of interrupt context.
+     */
+    class EventQueue
+    {
+    public:
+        virtual ~EventQueue() {}
+
+        /**
+         * Run the task after delay, a task that is already pending is rescheduled.
+         */
+        virtual void post(Task &task, micros_t delay) = 0;
+        virtual void cancel(Task &task) = 0;
+    };
+
+    /**
+     * \ingroup ost-core
+     * The single one-shot hardware timer of a node.
+     *
+     * A periodic tick implementation reports a non zero tick period and
+     * supports start_ticks()/get_ticks(), ost::TimerService then counts
+     * deadlines in ticks.
+     */
+    class TimerDriver
+    {
+    public:
+        class Listener
+        {
+        public:
+            virtual ~Listener() {}
+            virtual void timer_expired() = 0;
+        };
+
+        virtual ~TimerDriver() {}
+        virtual void set_listener(Listener *listener) = 0;
+
+        /**
+         * Arm the timer, the previous one (if any) is dropped.
+         *
+         * \param duration in microseconds
+         */
+        virtual void start(micros_t duration) = 0;
+        virtual void stop() = 0;
+        virtual bool is_running() const = 0;
+        virtual micros_t get_duration() const = 0;
+
+        /**
+         * Time left before expiration, never more than what is really left.
+         */
+        virtual micros_t get_left_time() const = 0;
+
+        /**
+         * \return period of the tick in nanoseconds, 0 for one-shot timers
+         */
+        virtual uint64_t get_tick_period_ns() const = 0;
+        virtual uint64_t get_ticks() const = 0;
+        virtual void start_ticks(uint32_t ticks) = 0;
+    };
+
+    /**
+     * \ingroup ost-core
+     * The SpaceWire link below the node.
+     */
+    class LinkDriver
+    {
+    public:
+        virtual ~LinkDriver() {}
+        virtual bool is_ready() const = 0;
+
+        /**
+         * Hand a frame (OST header and payload) to the link. The frame is
+         * copied or sent before the call returns.
+         *
+         * \return false if the frame was dropped
+         */
+        virtual bool transmit(uint8_t dst_addr, const uint8_t *frame, uint16_t len) = 0;
+
+        /**
+         * \return true if the platform calls Node::frame_sent() for every
+         * frame that has left the link
+         */
+        virtual bool reports_sent() const { return false; }
+
+        /**
+         * \return frames transmit() took that the link still holds back
+         * and will send later, they stay counted when the link is ready
+         */
+        virtual uint16_t frames_held() const { return 0; }
+    };
+
+    /**
+     * \ingroup ost-core
+     * Storage of the segments the engine keeps: queued for transmission,
+     * waiting for acknowledgement, received out of order.
+     */
+    class BufferPool
+    {
+    public:
+        virtual ~BufferPool() {}
+
+        /**
+         * \return buffer of at least size bytes, nullptr if there is none
+         */
+        virtual uint8_t *alloc(uint32_t size) = 0;
+        virtual void release(uint8_t *buffer) = 0;
+    };
+
+#ifndef OST_STATIC_ALLOCATION
+    /**
+     * \ingroup ost-core
+     * BufferPool on top of the heap, see StaticBufferPool for the
+     * static allocation profile.
+     */
+    class HeapBufferPool : public BufferPool
+    {
+    public:
+        HeapBufferPool() : in_use(0) {}
+        uint8_t *alloc(uint32_t size) override
+        {
+            in_use++;
+            return new uint8_t[size];
+        }
+        void release(uint8_t *buffer) override
+        {
+            if (buffer)
+            {
+                in_use--;
+                delete[] buffer;
+            }
+        }
+        size_t get_in_use() const { return in_use; }
+
+    private:
+        size_t in_use;
+    };
+#endif
+
+    /**
+     * \ingroup ost-core
+     * Everything the engine needs from the platform it runs on.
+     */
+    struct Platform
+    {
+        Clock *clock;
+        EventQueue *events;
+        TimerDriver *timer;
+        LinkDriver *link;
+        BufferPool *buffers;
+    };
+
+} // namespace ost
+
+#endif
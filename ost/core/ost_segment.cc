@@ -0,0 +1,43 @@
+#include "ost_segment.h"
+
+namespace ost
+{
+    void
+    SegmentHeader::write(uint8_t *buffer) const
+    {
+        buffer[0] = flags;
+        buffer[1] = source_addr;
+        buffer[2] = seq_number;
+        buffer[3] = payload_length & 0xff;
+        buffer[4] = payload_length >> 8;
+    }
+
+    void
+    SegmentHeader::read(const uint8_t *buffer)
+    {
+        flags = buffer[0];
+        source_addr = buffer[1];
+        seq_number = buffer[2];
+        payload_length = buffer[3] | (uint16_t(buffer[4]) << 8);
+    }
+
+    void
+    SegmentHeader::set_flag(SegmentFlag flag)
+    {
+        switch (flag)
+        {
+        case ACK:
+            flags |= 0b00000001;
+            break;
+        case SYN:
+            flags |= 0b00000010;
+            break;
+        case RST:
+            flags |= 0b00000100;
+            break;
+        default:
+            flags &= 0b11111000;
+            break;
+        }
+    }
+} // namespace ost
@@ -0,0 +1,73 @@
+#ifndef OST_SEGMENT_H
+#define OST_SEGMENT_H
+
+#include <inttypes.h>
+
+namespace ost
+{
+
+    typedef enum
+    {
+        ACK,
+        SYN,
+        RST,
+        DTA // virtual
+    } SegmentFlag;
+
+    /**
+     * \ingroup ost-core
+     * Header of an OST segment as it is on the wire:
+     *
+     *   0      flags (bit 0 ACK, bit 1 SYN, bit 2 RST, none of them - data)
+     *   1      source address
+     *   2      sequence number
+     *   3..4   payload length, least significant byte first
+     */
+    struct SegmentHeader
+    {
+        static const uint16_t SIZE = 5;
+
+        uint8_t flags;
+        uint8_t source_addr;
+        uint8_t seq_number;
+        uint16_t payload_length;
+
+        SegmentHeader()
+            : flags(0),
+              source_addr(0),
+              seq_number(0),
+              payload_length(0){};
+        SegmentHeader(uint8_t seq_n, uint8_t addr, uint16_t len)
+            : flags(0),
+              source_addr(addr),
+              seq_number(seq_n),
+              payload_length(len){};
+
+        void write(uint8_t *buffer) const;
+        void read(const uint8_t *buffer);
+
+        /**
+         * Patch the sequence number of an encoded header in place.
+         */
+        static void write_seq_number(uint8_t *buffer, uint8_t seq_n) { buffer[2] = seq_n; }
+
+        void set_flag(SegmentFlag flag);
+        bool is_ack() const { return flags & 0b00000001; }
+        bool is_syn() const { return flags & 0b00000010; }
+        bool is_rst() const { return flags & 0b00000100; }
+        bool is_dta() const { return (flags & 0b00000111) == 0; }
+    };
+
+    /**
+     * \ingroup ost-core
+     * Encoded segment kept by the engine, header included.
+     */
+    struct Segment
+    {
+        uint8_t *data;
+        uint16_t len;
+    };
+
+} // namespace ost
+
+#endif
@@ -0,0 +1,87 @@
+#ifndef OST_STATIC_POOL_H
+#define OST_STATIC_POOL_H
+
+#include "ost_config.h"
+#include "ost_platform.h"
+
+#include <string.h>
+
+namespace ost
+{
+
+    /**
+     * \ingroup ost-core
+     * BufferPool of BLOCKS buffers of BLOCK_SIZE bytes each, kept in the
+     * object itself. Free blocks are chained through their first bytes, so
+     * alloc and release are O(1) and there is no storage besides the blocks.
+     */
+    template <uint32_t BLOCK_SIZE, uint32_t BLOCKS>
+    class StaticBufferPool : public BufferPool
+    {
+        static_assert(BLOCK_SIZE >= sizeof(uint32_t), "block can not hold the free list link");
+        static_assert(BLOCKS > 0, "empty pool");
+
+        static constexpr uint32_t NONE = 0xffffffff;
+
+    public:
+        StaticBufferPool()
+            : free_head(0),
+              in_use(0),
+              high_watermark(0)
+        {
+            for (uint32_t i = 0; i < BLOCKS; ++i)
+                set_next(i, i + 1 < BLOCKS ? i + 1 : NONE);
+        }
+
+        uint8_t *alloc(uint32_t size) override
+        {
+            if (size > BLOCK_SIZE || free_head == NONE)
+                return nullptr;
+            uint8_t *b = storage + size_t(free_head) * BLOCK_SIZE;
+            memcpy(&free_head, b, sizeof(free_head));
+            in_use++;
+            if (in_use > high_watermark)
+                high_watermark = in_use;
+            return b;
+        }
+
+        void release(uint8_t *buffer) override
+        {
+            if (!buffer)
+                return;
+            uint32_t i = (buffer - storage) / BLOCK_SIZE;
+            set_next(i, free_head);
+            free_head = i;
+            in_use--;
+        }
+
+        size_t get_in_use() const { return in_use; }
+        size_t get_high_watermark() const { return high_watermark; }
+        static constexpr size_t get_capacity() { return BLOCKS; }
+        static constexpr size_t get_block_size() { return BLOCK_SIZE; }
+
+    private:
+        void set_next(uint32_t i, uint32_t next)
+        {
+            memcpy(storage + size_t(i) * BLOCK_SIZE, &next, sizeof(next));
+        }
+
+        uint8_t storage[size_t(BLOCK_SIZE) * BLOCKS];
+        uint32_t free_head;
+        size_t in_use;
+        size_t high_watermark;
+    };
+
+#ifdef OST_STATIC_ALLOCATION
+    /**
+     * \ingroup ost-core
+     * Pool that holds every segment the sockets of one node can keep at once.
+     */
+    typedef StaticBufferPool<config::MTU, config::NODE_BUFFERS> NodeBufferPool;
+#else
+    typedef HeapBufferPool NodeBufferPool;
+#endif
+
+} // namespace ost
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef OST_TYPES_H
+#define OST_TYPES_H
+
+#include <inttypes.h>
+
+/**
+* @ingroup Timer
+* @typedef micros_t
+* @brief Целочисленный беззнаковый тип микросекунды
+*/
+typedef uint32_t micros_t;
+
+/**
+* @ingroup Timer
+* @brief основная частота в кГц
+*/
+static const uint32_t CPU_FREQ = 32768;
+static const micros_t MAX_TIMER_DURATION = 16843000;
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef SLIDING_WINDOW_H
+#define SLIDING_WINDOW_H
+
+#include "ost_config.h"
+
+#include <inttypes.h>
+
+namespace ost
+{
+
+    /**
+     * \ingroup ost-core
+     * Check if seq_n lies in the window [bottom, top) of the 0..255 sequence space.
+     *
+     * Kept outside of the socket so the per-segment checks can be measured on their own.
+     */
+    inline bool
+    seq_in_window(uint8_t bottom, uint8_t top, uint8_t seq_n)
+    {
+        return uint8_t(seq_n - bottom) < uint8_t(top - bottom);
+    }
+
+    /**
+     * \ingroup ost-core
+     * Check if one more segment can be put into the tx window [bottom, top).
+     */
+    inline bool
+    window_have_space(uint8_t bottom, uint8_t top, uint16_t window_sz)
+    {
+        return uint8_t(top - bottom) < window_sz;
+    }
+
+    /**
+     * \ingroup ost-core
+     * Number of consecutive set bits starting from bit 0.
+     */
+    inline uint16_t
+    count_trailing_ones(uint64_t word)
+    {
+        if (word == ~uint64_t(0))
+            return 64;
+#if defined(__GNUC__)
+        return __builtin_ctzll(~word);
+#else
+        uint16_t n = 0;
+        while (word & 1)
+        {
+            word >>= 1;
+            n++;
+        }
+        return n;
+#endif
+    }
+
+    /**
+     * \ingroup ost-core
+     * Per-segment flags of a sliding window of W sequence numbers.
+     *
+     * Bit i stands for the sequence number bottom + i, so checking a
+     * sequence number is one subtraction and sliding the window over all
+     * the flagged segments at its edge is a count of trailing ones and a
+     * shift, whatever their number. Segments of the window are stored in
+     * SLOTS entries indexed by seq_n & MASK; SLOTS is a power of two and
+     * divides 256, so the slots of a window never collide.
+     */
+    template <uint16_t W>
+    class WindowBitmap
+    {
+        static_assert(W > 0 && W <= 128, "window must fit half of the sequence space");
+
+    public:
+        static constexpr uint16_t SIZE = W;
+        static constexpr uint16_t SLOTS = uint16_t(1) << config::log2_ceil(W);
+        static constexpr uint8_t MASK = SLOTS - 1;
+        static constexpr uint16_t WORDS = (W + 63) / 64;
+
+        WindowBitmap()
+        {
+            reset();
+        }
+
+        /**
+         * \return true if seq_n lies in the full window starting at bottom
+         */
+        static bool contains(uint8_t bottom, uint8_t seq_n)
+        {
+            return uint8_t(seq_n - bottom) < W;
+        }
+
+        static uint8_t slot(uint8_t seq_n)
+        {
+            return seq_n & MASK;
+        }
+
+        bool test(uint8_t offset) const
+        {
+            return (bits[offset / 64] >> (offset % 64)) & 1;
+        }
+
+        void set(uint8_t offset)
+        {
+            bits[offset / 64] |= uint64_t(1) << (offset % 64);
+        }
+
+        void reset()
+        {
+            for (uint16_t i = 0; i < WORDS; ++i)
+                bits[i] = 0;
+        }
+
+        /**
+         * Slide the window over the flags set at its bottom edge.
+         *
+         * \return number of sequence numbers the window moved by
+         */
+        uint16_t advance()
+        {
+            uint16_t n = 0;
+            for (uint16_t i = 0; i < WORDS; ++i)
+            {
+                uint16_t ones = count_trailing_ones(bits[i]);
+                n += ones;
+                if (ones != 64)
+                    break;
+            }
+            if (n != 0)
+                shift(n);
+            return n;
+        }
+
+    private:
+        void shift(uint16_t n)
+        {
+            uint16_t words = n / 64;
+            uint16_t rest = n % 64;
+            for (uint16_t i = 0; i < WORDS; ++i)
+            {
+                uint64_t lo = i + words < WORDS ? bits[i + words] : 0;
+                uint64_t hi = i + words + 1 < WORDS ? bits[i + words + 1] : 0;
+                bits[i] = rest ? (lo >> rest) | (hi << (64 - rest)) : lo;
+            }
+        }
+
+        uint64_t bits[WORDS];
+    };
+
+} // namespace ost
+
+#endif
@@ -1,30 +1,33 @@
 #include "timer_fifo.h"
 
-#include <format>
-#include "ns3/simulator.h"
-#include "ns3/ost_node.h"
+#ifndef OST_STATIC_ALLOCATION
+#include <string>
+#endif
 
-namespace ns3 {
-    NS_LOG_COMPONENT_DEFINE("TimerFifo");
+namespace ost {
 
-    TimerFifo::TimerFifo() :
+    TimerFifo::TimerFifo(TimerDriver &hw) :
         head(0),
         tail(0),
-        timers_sum(0)
-    {}    
+        timers_sum(0),
+        hw_timer(hw),
+        upper_handler(nullptr)
+    {
+        hw_timer.set_listener(this);
+    }
 
     TimerFifo::~TimerFifo() {}    
 
-    void TimerFifo::set_callback(TimerHandleCallback cb) {upper_handler = cb;}
+    void TimerFifo::set_listener(Listener *l) {upper_handler = l;}
 
-    void TimerFifo::init_hw_timer() { ; /*register and enable timer interrupt*/ } 
+    TimerDriver &TimerFifo::get_hw_timer() const { return hw_timer; }
 
     bool TimerFifo::is_queue_have_space() {
         return ((head + 1) % (MAX_UNACK_PACKETS + 1)) != tail;
     }
 
     int8_t TimerFifo::get_number_of_timers() {
-
+        return (head + MAX_UNACK_PACKETS + 1 - tail) % (MAX_UNACK_PACKETS + 1);
     }
 
     void TimerFifo::move_head() {
@@ -46,16 +49,12 @@ namespace ns3 {
     }
 
     int8_t TimerFifo::pop_timer(uint8_t seq_n, micros_t& duration_to_set) {
-        NS_LOG_FUNCTION("pop timer " << std::to_string(seq_n));
-
         if (tail == head) {
             return -1;
         }
 
         if(seq_n == data[tail].first) {
-            NS_LOG_DEBUG("timer is on tail");
             if(((tail > head) && tail == MAX_UNACK_PACKETS && head == 0) || ((tail < head) && head - tail == 1)) {
-                NS_LOG_DEBUG("timer is the only");
                 move_tail();
                 duration_to_set = 0;
             } else {
@@ -64,10 +63,8 @@ namespace ns3 {
                 timers_sum -= data[tail].second;
                 data[tail].second += r;
                 duration_to_set = data[tail].second;
-                NS_LOG_DEBUG("there is another, left in hw: " << std::to_string(r) << ", to set: " << std::to_string(duration_to_set));
             }
         } else {
-            NS_LOG_DEBUG("timer is smwhere else");
             duration_to_set = 0;
 
             uint8_t t_id = tail;
@@ -109,6 +106,7 @@ namespace ns3 {
         return 1;
     }
 
+#ifndef OST_STATIC_ALLOCATION
     void TimerFifo::Print(std::ostream& os) const {
         for(uint16_t i = 0; i < MAX_UNACK_PACKETS + 1; ++i) {
             if(i == tail && i == head) os << "[]";
@@ -123,7 +121,7 @@ namespace ns3 {
             }
 
         }
-        micros_t left = Simulator::GetDelayLeft(last_timer.e_id).GetMicroSeconds();
+        micros_t left = hw_timer.get_left_time();
         os << "\n tail=" << std::to_string(tail) << ", head=" << std::to_string(head) <<  ", sum=" << std::to_string(timers_sum) << ", left_in_hw=" << std::to_string(left) << "\n";
     }
 
@@ -133,6 +131,7 @@ namespace ns3 {
         q.Print(os);
         return os;
     }
+#endif
 
     micros_t TimerFifo::get_hard_timer_left_time() {
         /**
@@ -146,12 +145,11 @@ namespace ns3 {
         * could be too frequent
         *
         * Although it is possible in the simulator.
+        *
+        * HwTimer in TICK_DRIVEN mode does exactly that, and gives a lower bound
+        * of the left time counted in ticks.
         */
-       
-        int64_t nanos = Simulator::GetDelayLeft(last_timer.e_id).GetNanoSeconds();
-        int64_t micros = Simulator::GetDelayLeft(last_timer.e_id).GetMicroSeconds();
-        if(nanos) return micros + 1;
-        return micros;
+        return hw_timer.get_left_time();
     }
 
     int8_t TimerFifo::add_new_timer(uint8_t seq_n, const micros_t duration) {
@@ -160,8 +158,6 @@ namespace ns3 {
         if(r != 1) return -1;
         if(to_set != 0)
             activate_timer(to_set);
-        else
-            NS_LOG_INFO("added new timer{" << std::to_string(seq_n) <<  "} for " << std::to_string(duration) << " microseconds");
         return 1;
     }
 
@@ -170,9 +166,8 @@ namespace ns3 {
         micros_t to_set;
         int8_t r = pop_timer(seq_n, to_set);
         if(r != 0) return -1;
-        NS_LOG_LOGIC("NODE[] canceled timer{" << std::to_string(seq_n) <<  "} for " << std::to_string(last_timer.val) << " microseconds: \n" << *this);
         if(was_in_hw) {
-            Simulator::Cancel(last_timer.e_id);
+            hw_timer.stop();
         }
         if(to_set != 0) {
             activate_timer(to_set);
@@ -180,25 +175,18 @@ namespace ns3 {
         return 1;
     }
 
-    void TimerFifo::timer_interrupt_handler() {
+    void TimerFifo::timer_expired() {
         uint8_t seq_n = data[tail].first;
-        NS_LOG_INFO("timer is up {" << std::to_string(seq_n) <<  "}" << *this);
         micros_t to_set;
         int8_t r = pop_timer(seq_n, to_set);
         if(r == 0 && to_set != 0) {
             activate_timer(to_set);
         }
-        upper_handler(seq_n);
+        if (upper_handler) upper_handler->timer_expired(seq_n);
     }
 
     int8_t TimerFifo::activate_timer(const micros_t duration) {
-        last_timer.e_id = Simulator::Schedule(
-                MicroSeconds(duration),
-                &TimerFifo::timer_interrupt_handler,
-                this
-        );
-        last_timer.val = duration;
-        NS_LOG_INFO("ACTIVATED timer{" << std::to_string(data[tail].first) <<  "} for " << std::to_string(last_timer.val) << " microseconds \n");
+        hw_timer.start(duration);
         return 0;
     }
 }
\ No newline at end of file
@@ -4,55 +4,19 @@
 #define MAX_UNACK_PACKETS 255
 
 #include <inttypes.h>
-#include "ns3/event-id.h"
+#include "ost_platform.h"
 
-#include "ns3/callback.h"
+#include <utility>
+#ifndef OST_STATIC_ALLOCATION
+#include <ostream>
+#endif
 
 /**
  * @ingroup ost
  * \defgroup Timer Timer structures and functions
  */
 
-/**
-* @ingroup Timer
-* @typedef NanoSeconds
-* @brief Целочисленный беззнаковый тип наносекунды
-*/
-typedef uint32_t micros_t;
-
-/**
-* @ingroup Timer
-* @brief основная частота в кГц
-*/
-static const uint32_t CPU_FREQ = 32768; 
-static const micros_t MAX_TIMER_DURATION = 16843000;
-
-namespace ns3 {
-
-/**
- * @ingroup Timer
- * @struct HardwareTimer
- * @brief Implementation (elvees 1892VM15F) of hardware timer.
- * 
- *
- * @var HardwareTimer::ITCR
- * Регистр управления (182F_5000). 5 разрядов.
- *
- * @var HardwareTimer::ITPERIOD
- * Регистр периода работы таймера (182F_5004). 32 разрядов.
- *
- * @var HardwareTimer::ITCOUNT
- * Регистр счетчика (182F_5008). 32 разрядов.
- *
- * @var HardwareTimer::ITSCALE
- * Регистр предделителя (182F_500C). 8 разрядов.
- */
-typedef struct {
-    uint8_t ITCR;
-    uint32_t ITPERIOD;
-    uint32_t ITCOUNT;
-    uint8_t ITSCALE;
-} HardwareTimer;
+namespace ost {
 
 /**
  * \ingroup Timer
@@ -83,22 +47,25 @@ typedef struct {
  * Текущая сумма таймеров - время, через которое срабатает самый правый таймер
  * при условии что левой только что был запущен.
 
- * @var TimerFifo::last_timer
- * Продлжительность таймера, который сейчас тикает.
+ * @var TimerFifo::hw_timer
+ * Аппаратный таймер, на котором тикает таймер из хвоста очереди.
  */
-class TimerFifo : public SimpleRefCount<TimerFifo>
+class TimerFifo : public TimerDriver::Listener
 {
-    struct Timer {
-        EventId e_id;
-        micros_t val;
-    };
-
     public:
-        typedef Callback<bool, uint8_t> TimerHandleCallback;
-        TimerFifo();
+        class Listener
+        {
+            public:
+                virtual ~Listener() {}
+                virtual bool timer_expired(uint8_t seq_n) = 0;
+        };
+
+        TimerFifo(TimerDriver &hw);
         ~TimerFifo();
 
+#ifndef OST_STATIC_ALLOCATION
         void Print(std::ostream& os) const;
+#endif
 
         /**
          * Add new timer.
@@ -117,9 +84,10 @@ class TimerFifo : public SimpleRefCount<TimerFifo>
          */
         int8_t cancel_timer(uint8_t seq_n);
 
-        void set_callback(TimerHandleCallback cb);
+        void set_listener(Listener *l);
+        TimerDriver &get_hw_timer() const;
+        void timer_expired() override;
 
-        void init_hw_timer();
     private:
         void move_head();
         void rmove_head();
@@ -149,19 +117,19 @@ class TimerFifo : public SimpleRefCount<TimerFifo>
 
         micros_t get_hard_timer_left_time();
         int8_t activate_timer(const micros_t duration);
-        void timer_interrupt_handler();
 
         std::pair<uint8_t, micros_t> data[MAX_UNACK_PACKETS + 1];
         uint16_t head;
         uint16_t tail;
         uint16_t window_sz;
         micros_t timers_sum;
-        struct Timer last_timer;
-        HardwareTimer hw;
-        TimerHandleCallback upper_handler;
+        TimerDriver &hw_timer;
+        Listener *upper_handler;
 };
 
+#ifndef OST_STATIC_ALLOCATION
 std::ostream& operator<<(std::ostream& os, const TimerFifo& q);
+#endif
 
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,240 @@
+#include "timer_service.h"
+
+#include <utility>
+
+namespace ost {
+
+    TimerService::TimerService(TimerDriver &hw) :
+        free_count(0),
+        heap_size(0),
+        armed_at(0),
+        armed_deadline(0),
+        next_order(0),
+        hw_timer(hw),
+        upper_handler(nullptr)
+    {
+        hw_timer.set_listener(this);
+        for (uint32_t i = CAPACITY; i > 0; --i) {
+            slots[i - 1].heap_pos = NONE;
+            free_slots[free_count++] = i - 1;
+        }
+        for (uint32_t i = 0; i < INDEX_SZ; ++i) {
+            index_slots[i] = NONE;
+        }
+    }
+
+    TimerService::~TimerService() {}
+
+    void TimerService::set_listener(Listener *l) {upper_handler = l;}
+
+    TimerDriver &TimerService::get_hw_timer() const { return hw_timer; }
+
+    uint32_t TimerService::make_key(uint8_t port, TimerKind kind, uint8_t seq_n) {
+        return (uint32_t(port) << 16) | (uint32_t(kind) << 8) | seq_n;
+    }
+
+    uint32_t TimerService::bucket(uint32_t key) {
+        // Fibonacci hashing, sequence numbers of a window land in different buckets
+        if (INDEX_BITS == 0) return 0;
+        return (key * 2654435769u) >> (32 - INDEX_BITS);
+    }
+
+    uint32_t TimerService::find(uint32_t key) const {
+        uint32_t i = bucket(key);
+        while (index_slots[i] != NONE) {
+            if (index_keys[i] == key) return i;
+            i = (i + 1) & (INDEX_SZ - 1);
+        }
+        return NONE;
+    }
+
+    void TimerService::index_insert(uint32_t key, uint32_t slot) {
+        uint32_t i = bucket(key);
+        while (index_slots[i] != NONE && index_keys[i] != key) {
+            i = (i + 1) & (INDEX_SZ - 1);
+        }
+        index_keys[i] = key;
+        index_slots[i] = slot;
+    }
+
+    void TimerService::index_erase(uint32_t key) {
+        uint32_t i = find(key);
+        if (i == NONE) return;
+        // backward shift deletion, no tombstones are left behind
+        uint32_t j = i;
+        while (true) {
+            j = (j + 1) & (INDEX_SZ - 1);
+            if (index_slots[j] == NONE) break;
+            uint32_t h = bucket(index_keys[j]);
+            bool stays = (i <= j) ? (i < h && h <= j) : (i < h || h <= j);
+            if (!stays) {
+                index_keys[i] = index_keys[j];
+                index_slots[i] = index_slots[j];
+                i = j;
+            }
+        }
+        index_slots[i] = NONE;
+    }
+
+    bool TimerService::is_tick() const {
+        return hw_timer.get_tick_period_ns() != 0;
+    }
+
+    uint64_t TimerService::get_time() const {
+        if (is_tick()) return hw_timer.get_ticks();
+        if (!hw_timer.is_running()) return armed_at;
+        return armed_at + hw_timer.get_duration() - hw_timer.get_left_time();
+    }
+
+    bool TimerService::before(uint32_t a, uint32_t b) const {
+        const Timer& ta = slots[heap[a]];
+        const Timer& tb = slots[heap[b]];
+        if (ta.deadline != tb.deadline) return ta.deadline < tb.deadline;
+        return ta.order < tb.order;
+    }
+
+    void TimerService::heap_swap(uint32_t i, uint32_t j) {
+        std::swap(heap[i], heap[j]);
+        slots[heap[i]].heap_pos = i;
+        slots[heap[j]].heap_pos = j;
+    }
+
+    void TimerService::sift_up(uint32_t i) {
+        while (i > 0 && before(i, (i - 1) / 2)) {
+            heap_swap(i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+    }
+
+    void TimerService::sift_down(uint32_t i) {
+        uint32_t n = heap_size;
+        while (true) {
+            uint32_t l = 2 * i + 1;
+            uint32_t r = l + 1;
+            uint32_t m = i;
+            if (l < n && before(l, m)) m = l;
+            if (r < n && before(r, m)) m = r;
+            if (m == i) return;
+            heap_swap(i, m);
+            i = m;
+        }
+    }
+
+    void TimerService::heap_remove(uint32_t i) {
+        uint32_t slot = heap[i];
+        uint32_t last = heap_size - 1;
+        if (i != last) {
+            heap_swap(i, last);
+        }
+        heap_size--;
+        if (i != last) {
+            sift_down(i);
+            sift_up(i);
+        }
+        index_erase(slots[slot].key);
+        slots[slot].heap_pos = NONE;
+        free_slots[free_count++] = slot;
+    }
+
+    uint32_t TimerService::alloc_slot() {
+        if (free_count == 0) return NONE;
+        return free_slots[--free_count];
+    }
+
+    void TimerService::rearm() {
+        if (heap_size == 0) {
+            hw_timer.stop();
+            armed_at = 0;
+            armed_deadline = 0;
+            return;
+        }
+        uint64_t deadline = slots[heap[0]].deadline;
+        if (hw_timer.is_running() && deadline == armed_deadline) return;
+
+        uint64_t now = get_time();
+        armed_at = now;
+        armed_deadline = deadline;
+        if (is_tick()) {
+            hw_timer.start_ticks(deadline > now ? deadline - now : 0);
+        } else {
+            hw_timer.start(deadline > now ? deadline - now : 0);
+        }
+    }
+
+    int8_t TimerService::add_timer(uint8_t port, TimerKind kind, uint8_t seq_n, micros_t duration) {
+        if (duration > MAX_TIMER_DURATION) return -1;
+
+        uint32_t key = make_key(port, kind, seq_n);
+        uint32_t i = find(key);
+        if (i != NONE) {
+            heap_remove(slots[index_slots[i]].heap_pos);
+        }
+
+        uint32_t s = alloc_slot();
+        if (s == NONE) {
+            rearm();
+            return -1;
+        }
+        if (is_tick()) {
+            uint64_t tick_ns = hw_timer.get_tick_period_ns();
+            slots[s].deadline = get_time() + (uint64_t(duration) * 1000 + tick_ns - 1) / tick_ns + 1;
+        } else {
+            slots[s].deadline = get_time() + duration;
+        }
+        slots[s].order = next_order++;
+        slots[s].key = key;
+        slots[s].heap_pos = heap_size;
+        heap[heap_size++] = s;
+        index_insert(key, s);
+        sift_up(slots[s].heap_pos);
+
+        rearm();
+        return 1;
+    }
+
+    int8_t TimerService::cancel_timer(uint8_t port, TimerKind kind, uint8_t seq_n) {
+        uint32_t i = find(make_key(port, kind, seq_n));
+        if (i == NONE) return -1;
+        heap_remove(slots[index_slots[i]].heap_pos);
+        rearm();
+        return 1;
+    }
+
+    uint32_t TimerService::cancel_port(uint8_t port) {
+        uint32_t canceled = 0;
+        for (uint32_t s = 0; s < CAPACITY; ++s) {
+            if (slots[s].heap_pos != NONE && (slots[s].key >> 16) == port) {
+                heap_remove(slots[s].heap_pos);
+                canceled++;
+            }
+        }
+        rearm();
+        return canceled;
+    }
+
+    bool TimerService::is_pending(uint8_t port, TimerKind kind, uint8_t seq_n) const {
+        return find(make_key(port, kind, seq_n)) != NONE;
+    }
+
+    uint32_t TimerService::get_number_of_timers() const {
+        return heap_size;
+    }
+
+    void TimerService::timer_expired() {
+        armed_at = is_tick() ? get_time() : armed_deadline;
+
+        uint32_t expired[CAPACITY];
+        uint32_t n = 0;
+        while (heap_size != 0 && slots[heap[0]].deadline <= armed_at) {
+            expired[n++] = slots[heap[0]].key;
+            heap_remove(0);
+        }
+        rearm();
+
+        if (!upper_handler) return;
+        for (uint32_t i = 0; i < n; ++i) {
+            uint32_t key = expired[i];
+            upper_handler->timer_expired(key >> 16, TimerKind((key >> 8) & 0xff), key & 0xff);
+        }
+    }
+}
@@ -0,0 +1,128 @@
+#ifndef TIMER_SERVICE_H
+#define TIMER_SERVICE_H
+
+#include <inttypes.h>
+#include "ost_config.h"
+#include "ost_platform.h"
+
+namespace ost {
+
+/**
+ * \ingroup ost-core
+ * \class TimerService
+ * \brief Node-wide timers of all sockets multiplexed onto one hardware timer.
+ *
+ * Every timer is identified by (port, kind, seq_n) and kept in a binary
+ * min-heap ordered by deadline, so add and cancel are O(log n) and the
+ * lookup of a timer by its key is O(1). Only the earliest deadline is
+ * programmed into the hardware timer, whatever the number of sockets.
+ *
+ * Up to CAPACITY (config::MAX_TIMERS) timers can be pending, all the
+ * storage is inside the object.
+ *
+ * The hardware timer is the only clock. Over a one-shot timer the
+ * service remembers when the current hw timer was armed (armed_at) and
+ * derives the current time in microseconds from what is left in it, while
+ * no timer is pending time is not tracked at all. Over a periodic tick
+ * deadlines are kept in ticks of the interval timer; a timer added
+ * between two ticks is charged one more tick so it never expires early.
+ *
+ * Timers with equal deadlines expire in the order they were added.
+ */
+class TimerService : public TimerDriver::Listener
+{
+    public:
+        typedef enum {
+            RETRANSMISSION = 0,
+            DELAYED_ACK,
+            KEEPALIVE,
+        } TimerKind;
+
+        class Listener
+        {
+            public:
+                virtual ~Listener() {}
+                virtual void timer_expired(uint8_t port, TimerKind kind, uint8_t seq_n) = 0;
+        };
+
+        static constexpr uint32_t CAPACITY = config::MAX_TIMERS;
+
+        TimerService(TimerDriver &hw);
+        ~TimerService();
+
+        void set_listener(Listener *l);
+        TimerDriver &get_hw_timer() const;
+        void timer_expired() override;
+
+        /**
+         * Add a new timer, an already pending timer with the same key is restarted.
+         *
+         * \param port socket the timer belongs to
+         * \param kind purpose of the timer
+         * \param seq_n sequence number of packet timer set for.
+         * \param duration in microseconds
+         * \return 1 if timer added succesfully, -1 if the duration is too
+         * long or CAPACITY timers are already pending
+         */
+        int8_t add_timer(uint8_t port, TimerKind kind, uint8_t seq_n, micros_t duration);
+
+        /**
+         * \return 1 if timer cancel succesfully, -1 if there was no such timer
+         */
+        int8_t cancel_timer(uint8_t port, TimerKind kind, uint8_t seq_n);
+
+        /**
+         * Cancel every timer of the socket.
+         *
+         * \return number of timers canceled
+         */
+        uint32_t cancel_port(uint8_t port);
+
+        bool is_pending(uint8_t port, TimerKind kind, uint8_t seq_n) const;
+        uint32_t get_number_of_timers() const;
+
+    private:
+        struct Timer {
+            uint64_t deadline;
+            uint64_t order;
+            uint32_t key;
+            uint32_t heap_pos;
+        };
+
+        static constexpr uint32_t NONE = 0xffffffff;
+
+        // open addressing, at most half full
+        static constexpr uint32_t INDEX_BITS = config::log2_ceil(2 * CAPACITY);
+        static constexpr uint32_t INDEX_SZ = 1u << INDEX_BITS;
+
+        static uint32_t make_key(uint8_t port, TimerKind kind, uint8_t seq_n);
+        static uint32_t bucket(uint32_t key);
+        bool is_tick() const;
+        uint64_t get_time() const;
+        bool before(uint32_t a, uint32_t b) const;
+        void heap_swap(uint32_t i, uint32_t j);
+        void sift_up(uint32_t i);
+        void sift_down(uint32_t i);
+        void heap_remove(uint32_t i);
+        uint32_t alloc_slot();
+        uint32_t find(uint32_t key) const;
+        void index_insert(uint32_t key, uint32_t slot);
+        void index_erase(uint32_t key);
+        void rearm();
+
+        Timer slots[CAPACITY];
+        uint32_t free_slots[CAPACITY];
+        uint32_t free_count;
+        uint32_t heap[CAPACITY];
+        uint32_t heap_size;
+        uint32_t index_keys[INDEX_SZ];
+        uint32_t index_slots[INDEX_SZ];
+        uint64_t armed_at;
+        uint64_t armed_deadline;
+        uint64_t next_order;
+        TimerDriver &hw_timer;
+        Listener *upper_handler;
+};
+
+}
+#endif
@@ -0,0 +1,490 @@
+/*
+ * Microbenchmarks of the per-segment building blocks of OST.
+ *
+ * Every case is run for a number of samples, each sample times a fixed
+ * number of iterations. The first sample is a warm-up and is dropped, the
+ * rest are reported as min / median / mean / stddev in nanoseconds per
+ * operation. The median is the figure to compare between builds.
+ *
+ *   ./ns3 run "ost-microbench --samples=21 --iterations=100000"
+ *   ./ns3 run "ost-microbench --csv=1 --filter=timer"
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/core-module.h"
+#include "ns3/hw_timer.h"
+#include "ns3/ost-header.h"
+#include "ns3/ost_core_socket.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/sliding_window.h"
+#include "ns3/timer_fifo.h"
+#include "ns3/timer_service.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string.h>
+#include <vector>
+
+using namespace ns3;
+using ost::TimerFifo;
+using ost::TimerService;
+
+namespace
+{
+
+volatile uint64_t g_sink = 0;
+
+struct BenchResult
+{
+    std::string name;
+    std::string param;
+    double min;
+    double median;
+    double mean;
+    double stddev;
+};
+
+struct BenchConfig
+{
+    uint32_t samples;
+    uint32_t iterations;
+    bool csv;
+    std::string filter;
+};
+
+/**
+ * One case of the suite. setup() is called before every sample and is
+ * not timed, run(n) performs n operations.
+ */
+struct BenchCase
+{
+    std::string name;
+    std::string param;
+    std::function<void()> setup;
+    std::function<void(uint32_t)> run;
+    std::function<void()> teardown;
+};
+
+BenchResult
+Measure(const BenchCase& c, const BenchConfig& cfg)
+{
+    std::vector<double> perOp;
+    for (uint32_t s = 0; s <= cfg.samples; ++s)
+    {
+        if (c.setup)
+        {
+            c.setup();
+        }
+        auto begin = std::chrono::steady_clock::now();
+        c.run(cfg.iterations);
+        auto end = std::chrono::steady_clock::now();
+        if (c.teardown)
+        {
+            c.teardown();
+        }
+        if (s == 0)
+        {
+            continue; // warm-up
+        }
+        double ns = std::chrono::duration<double, std::nano>(end - begin).count();
+        perOp.push_back(ns / cfg.iterations);
+    }
+
+    std::sort(perOp.begin(), perOp.end());
+    BenchResult r;
+    r.name = c.name;
+    r.param = c.param;
+    r.min = perOp.front();
+    size_t n = perOp.size();
+    r.median = n % 2 ? perOp[n / 2] : (perOp[n / 2 - 1] + perOp[n / 2]) / 2;
+    double sum = 0;
+    for (double v : perOp)
+    {
+        sum += v;
+    }
+    r.mean = sum / n;
+    double sq = 0;
+    for (double v : perOp)
+    {
+        sq += (v - r.mean) * (v - r.mean);
+    }
+    r.stddev = n > 1 ? std::sqrt(sq / (n - 1)) : 0;
+    return r;
+}
+
+void
+Report(const BenchResult& r, const BenchConfig& cfg)
+{
+    if (cfg.csv)
+    {
+        std::cout << r.name << "," << r.param << "," << cfg.samples << "," << cfg.iterations << ","
+                  << r.min << "," << r.median << "," << r.mean << "," << r.stddev << std::endl;
+        return;
+    }
+    std::cout << std::left << std::setw(32) << r.name << std::setw(26) << r.param << std::right
+              << std::fixed << std::setprecision(2) << std::setw(10) << r.min << std::setw(10)
+              << r.median << std::setw(10) << r.mean << std::setw(10) << r.stddev << std::endl;
+}
+
+class NoopTimerHandler : public TimerFifo::Listener, public TimerService::Listener
+{
+  public:
+    bool timer_expired(uint8_t) override
+    {
+        return true;
+    }
+
+    void timer_expired(uint8_t, TimerService::TimerKind, uint8_t) override
+    {
+    }
+};
+
+NoopTimerHandler g_noop;
+
+Ptr<HwTimer>
+CreateHwTimer(bool tick)
+{
+    Ptr<HwTimer> hw = Create<HwTimer>();
+    if (tick)
+    {
+        hw->init_tick(4095, 0);
+    }
+    else
+    {
+        hw->init();
+    }
+    return hw;
+}
+
+/*
+ * TimerFifo with `pending` timers armed: every operation acknowledges the
+ * oldest segment and arms a timer for a new one, which is what the socket
+ * does in steady state. The simulator never runs, so no timer expires.
+ */
+void
+AddTimerFifoCases(std::vector<BenchCase>& cases, bool tick)
+{
+    for (uint32_t pending : {1, 8, 64, 254})
+    {
+        auto hw = std::make_shared<Ptr<HwTimer>>();
+        auto fifo = std::make_shared<std::unique_ptr<TimerFifo>>();
+        auto oldest = std::make_shared<uint8_t>(0);
+        auto next = std::make_shared<uint8_t>(0);
+        BenchCase c;
+        c.name = tick ? "timer_fifo_tick.add_cancel" : "timer_fifo.add_cancel";
+        c.param = "timers=" + std::to_string(pending);
+        c.setup = [=]() {
+            *hw = CreateHwTimer(tick);
+            fifo->reset(new TimerFifo(**hw));
+            (*fifo)->set_listener(&g_noop);
+            *oldest = 0;
+            *next = 0;
+            for (uint32_t i = 0; i < pending; ++i)
+            {
+                (*fifo)->add_new_timer((*next)++, ost::Socket::DURATION_RETRANSMISSON);
+            }
+        };
+        c.run = [=](uint32_t n) {
+            TimerFifo* f = fifo->get();
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                f->cancel_timer((*oldest)++);
+                f->add_new_timer((*next)++, ost::Socket::DURATION_RETRANSMISSON);
+            }
+        };
+        c.teardown = [=]() {
+            fifo->reset();
+            *hw = nullptr;
+            Simulator::Destroy();
+        };
+        cases.push_back(c);
+    }
+}
+
+void
+AddTimerServiceCases(std::vector<BenchCase>& cases, bool tick)
+{
+    // TimerService holds at most CAPACITY timers (OST_CFG_MAX_TIMERS)
+    std::vector<uint32_t> counts;
+    for (uint32_t pending : {1u, 8u, 64u, 254u, 1024u})
+    {
+        if (pending < TimerService::CAPACITY)
+        {
+            counts.push_back(pending);
+        }
+    }
+    counts.push_back(TimerService::CAPACITY);
+
+    for (uint32_t pending : counts)
+    {
+        auto hw = std::make_shared<Ptr<HwTimer>>();
+        auto service = std::make_shared<std::unique_ptr<TimerService>>();
+        auto oldest = std::make_shared<uint32_t>(0);
+        auto next = std::make_shared<uint32_t>(0);
+        BenchCase c;
+        c.name = tick ? "timer_service_tick.add_cancel" : "timer_service.add_cancel";
+        c.param = "timers=" + std::to_string(pending);
+        // keys wrap every 256 ports * 256 seqs, far more than ever pending
+        c.setup = [=]() {
+            *hw = CreateHwTimer(tick);
+            service->reset(new TimerService(**hw));
+            (*service)->set_listener(&g_noop);
+            *oldest = 0;
+            *next = 0;
+            for (uint32_t i = 0; i < pending; ++i, ++*next)
+            {
+                (*service)->add_timer(*next >> 8, TimerService::RETRANSMISSION, *next, ost::Socket::DURATION_RETRANSMISSON);
+            }
+        };
+        c.run = [=](uint32_t n) {
+            TimerService* t = service->get();
+            for (uint32_t i = 0; i < n; ++i, ++*oldest, ++*next)
+            {
+                t->cancel_timer(uint8_t(*oldest >> 8), TimerService::RETRANSMISSION, uint8_t(*oldest));
+                t->add_timer(uint8_t(*next >> 8), TimerService::RETRANSMISSION, uint8_t(*next), ost::Socket::DURATION_RETRANSMISSON);
+            }
+        };
+        c.teardown = [=]() {
+            service->reset();
+            *hw = nullptr;
+            Simulator::Destroy();
+        };
+        cases.push_back(c);
+    }
+}
+
+void
+AddHeaderCases(std::vector<BenchCase>& cases)
+{
+    auto buffer = std::make_shared<Buffer>();
+    buffer->AddAtStart(OstHeader().GetSerializedSize());
+
+    BenchCase ser;
+    ser.name = "ost_header.serialize";
+    ser.param = "-";
+    ser.run = [=](uint32_t n) {
+        OstHeader h(0, 1, 1000);
+        h.set_flag(ACK);
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            h.set_seq_number(i);
+            h.Serialize(buffer->Begin());
+        }
+        g_sink += buffer->Begin().ReadU8();
+    };
+    cases.push_back(ser);
+
+    BenchCase des;
+    des.name = "ost_header.deserialize";
+    des.param = "-";
+    des.run = [=](uint32_t n) {
+        OstHeader h;
+        uint64_t acc = 0;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            h.Deserialize(buffer->Begin());
+            acc += h.get_seq_number();
+        }
+        g_sink += acc;
+    };
+    cases.push_back(des);
+}
+
+/*
+ * Every operation checks one sequence number, all 256 of them are walked
+ * so both hits and misses are counted. The window starts at 200 so the
+ * larger windows wrap around the sequence space.
+ */
+void
+AddWindowCases(std::vector<BenchCase>& cases)
+{
+    for (uint32_t window : {10, 64, 128, 255})
+    {
+        uint8_t bottom = 200;
+        uint8_t top = (bottom + window) % ost::Socket::MAX_SEQ_N;
+
+        BenchCase in;
+        in.name = "sliding_window.in_window";
+        in.param = "window=" + std::to_string(window);
+        in.run = [=](uint32_t n) {
+            uint64_t acc = 0;
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                acc += ost::seq_in_window(bottom, top, uint8_t(i));
+            }
+            g_sink += acc;
+        };
+        cases.push_back(in);
+
+        BenchCase space;
+        space.name = "sliding_window.have_space";
+        space.param = "window=" + std::to_string(window);
+        space.run = [=](uint32_t n) {
+            uint64_t acc = 0;
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                acc += ost::window_have_space(bottom, uint8_t(bottom + i % window), window);
+            }
+            g_sink += acc;
+        };
+        cases.push_back(space);
+    }
+}
+
+/*
+ * Acknowledgements of a whole window arriving in reverse order, as after
+ * the loss of the oldest segment: every ACK but the last only sets its
+ * bit, the last one slides the window over all of them.
+ */
+template <uint16_t W>
+void
+AddWindowBitmapCase(std::vector<BenchCase>& cases)
+{
+    BenchCase c;
+    c.name = "window_bitmap.ack_burst";
+    c.param = "window=" + std::to_string(W);
+    c.run = [](uint32_t n) {
+        ost::WindowBitmap<W> acked;
+        uint64_t acc = 0;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            uint8_t offset = W - 1 - i % W;
+            if (!acked.test(offset))
+            {
+                acked.set(offset);
+            }
+            if (offset == 0)
+            {
+                acc += acked.advance();
+            }
+        }
+        g_sink += acc;
+    };
+    cases.push_back(c);
+}
+
+void
+AddWindowBitmapCases(std::vector<BenchCase>& cases)
+{
+    AddWindowBitmapCase<8>(cases);
+    AddWindowBitmapCase<64>(cases);
+    AddWindowBitmapCase<128>(cases);
+}
+
+/*
+ * What ost::Socket::send and ost::Socket::add_packet_to_tx do for a
+ * segment: take a buffer from the pool, encode the header and copy the
+ * payload into it, then patch the sequence number in place when the
+ * segment enters the tx window. The oldest slot is released once the
+ * window is full, as an acknowledgement would.
+ */
+void
+AddTxPathCases(std::vector<BenchCase>& cases)
+{
+    for (uint32_t window : {10, 64, 255})
+    {
+        for (uint32_t payload : {16, 1024})
+        {
+            auto pool = std::make_shared<ost::HeapBufferPool>();
+            auto data = std::make_shared<std::vector<uint8_t>>();
+            auto ring = std::make_shared<std::vector<ost::Segment>>();
+            BenchCase c;
+            c.name = "socket.add_packet_to_tx";
+            c.param = "window=" + std::to_string(window) + ",payload=" + std::to_string(payload);
+            c.setup = [=]() {
+                data->assign(payload, 0x5a);
+                ring->assign(ost::Socket::MAX_SEQ_N, ost::Segment{nullptr, 0});
+            };
+            c.run = [=](uint32_t n) {
+                uint8_t top = 0;
+                uint16_t len = ost::SegmentHeader::SIZE + payload;
+                for (uint32_t i = 0; i < n; ++i)
+                {
+                    ost::Segment s = {pool->alloc(len), len};
+                    ost::SegmentHeader h(0, 1, payload);
+                    h.set_flag(ost::DTA);
+                    h.write(s.data);
+                    memcpy(s.data + ost::SegmentHeader::SIZE, data->data(), payload);
+                    ost::SegmentHeader::write_seq_number(s.data, top);
+                    (*ring)[top] = s;
+                    ost::Segment& old = (*ring)[uint8_t(top - window)];
+                    pool->release(old.data);
+                    old.data = nullptr;
+                    top++;
+                }
+            };
+            c.teardown = [=]() {
+                for (ost::Segment& s : *ring)
+                {
+                    pool->release(s.data);
+                }
+                ring->clear();
+            };
+            cases.push_back(c);
+        }
+    }
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    BenchConfig cfg;
+    cfg.samples = 15;
+    cfg.iterations = 20000;
+    cfg.csv = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("samples", "Timed samples per case (one more is run as warm-up)", cfg.samples);
+    cmd.AddValue("iterations", "Operations per sample", cfg.iterations);
+    cmd.AddValue("csv", "Print CSV instead of a table", cfg.csv);
+    cmd.AddValue("filter", "Run only the cases whose name contains this string", cfg.filter);
+    cmd.Parse(argc, argv);
+
+    if (cfg.samples == 0 || cfg.iterations == 0)
+    {
+        std::cerr << "samples and iterations must be positive" << std::endl;
+        return 1;
+    }
+
+    std::vector<BenchCase> cases;
+    AddTimerFifoCases(cases, false);
+    AddTimerFifoCases(cases, true);
+    AddTimerServiceCases(cases, false);
+    AddTimerServiceCases(cases, true);
+    AddHeaderCases(cases);
+    AddWindowCases(cases);
+    AddWindowBitmapCases(cases);
+    AddTxPathCases(cases);
+
+    if (cfg.csv)
+    {
+        std::cout << "case,param,samples,iterations,min_ns,median_ns,mean_ns,stddev_ns" << std::endl;
+    }
+    else
+    {
+        std::cout << std::left << std::setw(32) << "case" << std::setw(26) << "param" << std::right
+                  << std::setw(10) << "min" << std::setw(10) << "median" << std::setw(10) << "mean"
+                  << std::setw(10) << "stddev" << "   (ns/op)" << std::endl;
+    }
+
+    for (const BenchCase& c : cases)
+    {
+        if (!cfg.filter.empty() && c.name.find(cfg.filter) == std::string::npos)
+        {
+            continue;
+        }
+        Report(Measure(c, cfg), cfg);
+    }
+
+    Simulator::Destroy();
+    return 0;
+}
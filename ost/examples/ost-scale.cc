@@ -0,0 +1,141 @@
+/*
+ * Setup cost of scenarios with many OST links.
+ *
+ * SpWHelper installs --links links between two NodeContainers and
+ * OstHelper an OstNode at each end. The setup is timed and the resident
+ * memory read before and after it, both reported per link. Then every
+ * link carries one message of --size bytes.
+ *
+ *   ./ns3 run "ost-scale --links=500"
+ *   ./ns3 run "ost-scale --links=200 --rate=200Mbps --window=8"
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/ost-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/spw-helper.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+uint32_t g_delivered = 0;
+
+/**
+ * \return resident memory of the process in bytes, 0 where /proc is missing
+ */
+uint64_t
+ResidentBytes()
+{
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0;
+    uint64_t resident = 0;
+    if (!(statm >> size >> resident))
+    {
+        return 0;
+    }
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+void
+Delivered(uint8_t address, Ptr<Packet> p)
+{
+    g_delivered++;
+}
+
+void
+SendMessage(Ptr<OstNode> node, uint8_t address, uint32_t size)
+{
+    std::vector<uint8_t> buffer(size, 0x5a);
+    if (node->send_packet(address, buffer.data(), size) < 0)
+    {
+        std::cerr << "node " << +node->GetAddress() << " cannot send" << std::endl;
+    }
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t links = 100;
+    std::string rate = "100Mbps";
+    uint16_t window = 4;
+    uint32_t size = 1000;
+    double stop = 2.0;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("links", "SpW links, each with an OstNode at both ends", links);
+    cmd.AddValue("rate", "Data rate of the links", rate);
+    cmd.AddValue("window", "Window of the sockets", window);
+    cmd.AddValue("size", "Bytes sent over every link", size);
+    cmd.AddValue("stop", "Simulated seconds", stop);
+    cmd.Parse(argc, argv);
+
+    if (links == 0 || size == 0 || size > ost::Socket::MAX_PAYLOAD)
+    {
+        std::cerr << "links must be positive and size at most " << ost::Socket::MAX_PAYLOAD
+                  << std::endl;
+        return 1;
+    }
+
+    uint64_t memoryBefore = ResidentBytes();
+    auto setupStart = std::chrono::steady_clock::now();
+
+    NodeContainer a;
+    NodeContainer b;
+    a.Create(links);
+    b.Create(links);
+
+    SpWHelper spw;
+    spw.SetDeviceAttribute("AnalyticalHandshake", BooleanValue(true));
+    spw.SetDeviceAttribute("DataRate", DataRateValue(DataRate(rate)));
+    NetDeviceContainer devices = spw.Install(a, b);
+
+    OstHelper ost;
+    ost.SetWindow(window);
+    ost.SetReceiveCallback(MakeCallback(&Delivered));
+    std::vector<Ptr<OstNode>> nodes = ost.Install(devices);
+
+    auto setupEnd = std::chrono::steady_clock::now();
+    uint64_t memoryAfter = ResidentBytes();
+
+    ost.Start(nodes, MilliSeconds(1));
+    for (uint32_t i = 0; i < links; ++i)
+    {
+        Simulator::Schedule(MilliSeconds(2),
+                            &SendMessage,
+                            nodes[2 * i],
+                            nodes[2 * i + 1]->GetAddress(),
+                            size);
+    }
+    Simulator::Stop(Seconds(stop));
+    auto runStart = std::chrono::steady_clock::now();
+    Simulator::Run();
+    auto runEnd = std::chrono::steady_clock::now();
+
+    double setupUs = std::chrono::duration<double, std::micro>(setupEnd - setupStart).count();
+    double runS = std::chrono::duration<double>(runEnd - runStart).count();
+    std::cout << "links            " << links << std::endl;
+    std::cout << "setup            " << setupUs / links << " us/link" << std::endl;
+    if (memoryBefore && memoryAfter >= memoryBefore)
+    {
+        std::cout << "memory           " << double(memoryAfter - memoryBefore) / links / 1024
+                  << " KiB/link" << std::endl;
+    }
+    std::cout << "run              " << runS << " s" << std::endl;
+    std::cout << "delivered        " << g_delivered << "/" << links << std::endl;
+
+    Simulator::Destroy();
+    return g_delivered == links ? 0 : 1;
+}
@@ -0,0 +1,367 @@
+/*
+ * Parameter sweep of ost-throughput over a pool of processes.
+ *
+ * Every point of the --windows x --errorRates x --segments grid is run
+ * --seeds times, with RngRun --firstRun, --firstRun + 1, ... so the grid
+ * points share their error patterns. Up to --jobs simulations run at once,
+ * each in its own ost-throughput process. Their lines go to --out as they
+ * finish, the order of the file is the order of completion.
+ *
+ * Once all have run, a summary per grid point is printed: mean and 95%
+ * confidence half-width (Student t) across the seeds of goodput,
+ * retransmission ratio and median and p99 latency.
+ *
+ *   ./ns3 build ost-throughput ost-sweep
+ *   ./ns3 run "ost-sweep --windows=1,4,10 --errorRates=0,0.01,0.05 --seeds=10"
+ *   ./ns3 run "ost-sweep --segments=256,4096 --args='--processing=10us' --jobs=8"
+ *
+ * --program is the ost-throughput binary, by default the one next to this
+ * program.
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/core-module.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <poll.h>
+#include <sstream>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <tuple>
+#include <unistd.h>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+struct SweepConfig
+{
+    std::string windows;
+    std::string errorRates;
+    std::string segments;
+    uint32_t seeds;
+    uint32_t firstRun;
+    uint32_t jobs;
+    std::string program;
+    std::string args;
+    std::string out;
+};
+
+/**
+ * One simulation: a grid point and a seed.
+ */
+struct Job
+{
+    std::string window;
+    std::string errorRate;
+    std::string segment;
+    uint32_t run;
+};
+
+struct Running
+{
+    pid_t pid;
+    int fd;
+    Job job;
+    std::string output;
+};
+
+typedef std::tuple<std::string, std::string, std::string> GridPoint;
+
+const char* const METRICS[] = {"goodput_mbps", "retx_ratio", "latency_p50_us", "latency_p99_us"};
+
+std::vector<std::string>
+Split(const std::string& s, char separator)
+{
+    std::vector<std::string> items;
+    std::istringstream is(s);
+    std::string item;
+    while (std::getline(is, item, separator))
+    {
+        if (!item.empty())
+        {
+            items.push_back(item);
+        }
+    }
+    return items;
+}
+
+/**
+ * \return two-sided 95% quantile of Student's t with df degrees of freedom
+ */
+double
+StudentT95(uint32_t df)
+{
+    static const double t[] = {12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306,
+                               2.262,  2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120,
+                               2.110,  2.101, 2.093, 2.086, 2.080, 2.074, 2.069, 2.064,
+                               2.060,  2.056, 2.052, 2.048, 2.045, 2.042};
+    return df <= 30 ? t[df - 1] : 1.96;
+}
+
+/**
+ * \return the ost-throughput binary next to argv0, whatever the prefix
+ * and suffix of the build
+ */
+std::string
+DefaultProgram(const std::string& argv0)
+{
+    size_t pos = argv0.rfind("ost-sweep");
+    if (pos == std::string::npos)
+    {
+        return "ost-throughput";
+    }
+    return argv0.substr(0, pos) + "ost-throughput" + argv0.substr(pos + 9);
+}
+
+/**
+ * Fork and exec the program for a job, its standard output into a pipe.
+ */
+bool
+Start(const SweepConfig& cfg, const Job& job, Running& r)
+{
+    std::vector<std::string> args = {cfg.program,
+                                     "--window=" + job.window,
+                                     "--errorRate=" + job.errorRate,
+                                     "--segment=" + job.segment,
+                                     "--RngRun=" + std::to_string(job.run),
+                                     "--format=csv",
+                                     "--header=1"};
+    for (auto& a : Split(cfg.args, ' '))
+    {
+        args.push_back(a);
+    }
+    std::vector<char*> argv;
+    for (auto& a : args)
+    {
+        argv.push_back(const_cast<char*>(a.c_str()));
+    }
+    argv.push_back(nullptr);
+
+    int fds[2];
+    if (pipe(fds) != 0)
+    {
+        return false;
+    }
+    pid_t pid = fork();
+    if (pid < 0)
+    {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0)
+    {
+        dup2(fds[1], STDOUT_FILENO);
+        close(fds[0]);
+        close(fds[1]);
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+    close(fds[1]);
+    r.pid = pid;
+    r.fd = fds[0];
+    r.job = job;
+    r.output.clear();
+    return true;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    SweepConfig cfg;
+    cfg.windows = "1,4,10";
+    cfg.errorRates = "0,0.01";
+    cfg.segments = "1024";
+    cfg.seeds = 5;
+    cfg.firstRun = 1;
+    cfg.jobs = std::max(1u, std::thread::hardware_concurrency());
+    cfg.program = DefaultProgram(argv[0]);
+    cfg.args = "";
+    cfg.out = "ost-sweep.csv";
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("windows", "Comma separated windows", cfg.windows);
+    cmd.AddValue("errorRates", "Comma separated packet error rates", cfg.errorRates);
+    cmd.AddValue("segments", "Comma separated segment sizes", cfg.segments);
+    cmd.AddValue("seeds", "Runs per grid point", cfg.seeds);
+    cmd.AddValue("firstRun", "RngRun of the first seed", cfg.firstRun);
+    cmd.AddValue("jobs", "Simulations run at once", cfg.jobs);
+    cmd.AddValue("program", "ost-throughput binary", cfg.program);
+    cmd.AddValue("args", "More options for every run, space separated", cfg.args);
+    cmd.AddValue("out", "CSV file of the runs", cfg.out);
+    cmd.Parse(argc, argv);
+
+    std::vector<Job> jobs;
+    std::vector<GridPoint> grid;
+    for (auto& w : Split(cfg.windows, ','))
+    {
+        for (auto& e : Split(cfg.errorRates, ','))
+        {
+            for (auto& s : Split(cfg.segments, ','))
+            {
+                grid.emplace_back(w, e, s);
+                for (uint32_t i = 0; i < cfg.seeds; ++i)
+                {
+                    jobs.push_back(Job{w, e, s, cfg.firstRun + i});
+                }
+            }
+        }
+    }
+    if (jobs.empty() || cfg.jobs == 0)
+    {
+        std::cerr << "empty grid, no seeds or no jobs" << std::endl;
+        return 1;
+    }
+    if (access(cfg.program.c_str(), X_OK) != 0)
+    {
+        std::cerr << "cannot run " << cfg.program << ", build ost-throughput or set --program"
+                  << std::endl;
+        return 1;
+    }
+
+    std::ofstream out(cfg.out);
+    if (!out)
+    {
+        std::cerr << "cannot write " << cfg.out << std::endl;
+        return 1;
+    }
+
+    std::map<GridPoint, std::map<std::string, std::vector<double>>> results;
+    std::vector<Running> running;
+    size_t next = 0;
+    size_t done = 0;
+    uint32_t failed = 0;
+    bool header = false;
+    while (next < jobs.size() || !running.empty())
+    {
+        while (running.size() < cfg.jobs && next < jobs.size())
+        {
+            Running r;
+            if (!Start(cfg, jobs[next], r))
+            {
+                std::cerr << "cannot start " << cfg.program << std::endl;
+                return 1;
+            }
+            running.push_back(r);
+            next++;
+        }
+
+        std::vector<pollfd> fds;
+        for (auto& r : running)
+        {
+            fds.push_back(pollfd{r.fd, POLLIN, 0});
+        }
+        if (poll(fds.data(), fds.size(), -1) < 0)
+        {
+            continue;
+        }
+        for (size_t i = fds.size(); i-- > 0;)
+        {
+            if (!fds[i].revents)
+            {
+                continue;
+            }
+            Running& r = running[i];
+            char buffer[4096];
+            ssize_t n = read(r.fd, buffer, sizeof(buffer));
+            if (n > 0)
+            {
+                r.output.append(buffer, n);
+                continue;
+            }
+            close(r.fd);
+            int status = 0;
+            waitpid(r.pid, &status, 0);
+            done++;
+
+            // exit status 2 is a run that did not complete, its line still counts
+            std::vector<std::string> lines = Split(r.output, '\n');
+            int code = WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+            if ((code != 0 && code != 2) || lines.size() < 2)
+            {
+                failed++;
+                std::cerr << "\nrun failed: window " << r.job.window << " error rate "
+                          << r.job.errorRate << " segment " << r.job.segment << " RngRun "
+                          << r.job.run << std::endl;
+            }
+            else
+            {
+                if (!header)
+                {
+                    out << lines[0] << std::endl;
+                    header = true;
+                }
+                out << lines[1] << std::endl;
+
+                std::vector<std::string> names = Split(lines[0], ',');
+                std::vector<std::string> values = Split(lines[1], ',');
+                auto& point = results[GridPoint(r.job.window, r.job.errorRate, r.job.segment)];
+                for (size_t k = 0; k < names.size() && k < values.size(); ++k)
+                {
+                    point[names[k]].push_back(std::stod(values[k]));
+                }
+            }
+            std::cerr << "\r" << done << "/" << jobs.size() << " runs" << std::flush;
+            running.erase(running.begin() + i);
+        }
+    }
+    std::cerr << std::endl;
+
+    std::cout << "window,error_rate,segment,runs,complete";
+    for (auto m : METRICS)
+    {
+        std::cout << "," << m << "," << m << "_ci95";
+    }
+    std::cout << std::endl;
+    for (auto& g : grid)
+    {
+        auto& point = results[g];
+        auto& complete = point["complete"];
+        uint32_t n = complete.size();
+        double completed = 0;
+        for (double c : complete)
+        {
+            completed += c;
+        }
+        std::cout << std::get<0>(g) << "," << std::get<1>(g) << "," << std::get<2>(g) << "," << n
+                  << "," << completed;
+        for (auto m : METRICS)
+        {
+            auto& v = point[m];
+            if (v.empty())
+            {
+                std::cout << ",,";
+                continue;
+            }
+            double mean = 0;
+            for (double x : v)
+            {
+                mean += x;
+            }
+            mean /= v.size();
+            std::cout << "," << mean << ",";
+            if (v.size() > 1)
+            {
+                double ss = 0;
+                for (double x : v)
+                {
+                    ss += (x - mean) * (x - mean);
+                }
+                std::cout << StudentT95(v.size() - 1) * std::sqrt(ss / (v.size() - 1) / v.size());
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    return failed ? 1 : 0;
+}
@@ -0,0 +1,293 @@
+/*
+ * End-to-end throughput of OST over one SpW link.
+ *
+ * Node A sends --transfer bytes to node B in messages of --segment bytes,
+ * offering a new one as soon as its socket takes it. The receiver devices
+ * drop packets at --errorRate and take --processing for every frame, the
+ * 100 ms default of SpWFixedProcessingModel makes the window the limit.
+ * Once B has everything, or at --stop, one line is printed:
+ *
+ *  - goodput: payload delivered in order over the time from the first
+ *    message offered to the last one delivered;
+ *  - retransmission ratio: retransmissions over segments sent;
+ *  - latency percentiles: from a message entering the socket to its
+ *    delivery at B;
+ *  - wall-clock time of Simulator::Run and the events it executed.
+ *
+ *   ./ns3 run "ost-throughput --rate=100Mbps --errorRate=0.01 --window=8"
+ *   ./ns3 run "ost-throughput --processing=10us --transfer=10000000"
+ *   ./ns3 run "ost-throughput --format=json --RngRun=3"
+ *   ./ns3 run "ost-throughput --header=1 --ns3::OstNode::AckPolicy=Delayed"
+ */
+
+#include "ns3/abort.h"
+#include "ns3/command-line.h"
+#include "ns3/core-module.h"
+#include "ns3/error-model.h"
+#include "ns3/network-module.h"
+#include "ns3/ost-helper.h"
+#include "ns3/ost_socket.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/simulator.h"
+#include "ns3/spw-helper.h"
+#include "ns3/spw-processing-model.h"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+namespace
+{
+
+struct BenchConfig
+{
+    std::string rate;
+    std::string processing;
+    double errorRate;
+    uint16_t window;
+    uint32_t segment;
+    uint64_t transfer;
+    double stop;
+    std::string format;
+    bool header;
+};
+
+/**
+ * Feeds the transfer to the sender and times every message.
+ */
+class Transfer
+{
+  public:
+    Transfer(Ptr<OstNode> sender, uint8_t to, const BenchConfig& cfg, Time poll)
+        : m_sender(sender),
+          m_to(to),
+          m_segment(cfg.segment),
+          m_left(cfg.transfer),
+          m_poll(poll),
+          m_payload(cfg.segment, 0x5a),
+          m_delivered(0)
+    {
+    }
+
+    void Offer()
+    {
+        if (m_first.IsZero())
+        {
+            m_first = Simulator::Now();
+        }
+        while (m_left)
+        {
+            uint32_t size = std::min<uint64_t>(m_left, m_segment);
+            int8_t r = m_sender->send_packet(m_to, m_payload.data(), size);
+            if (r == -2)
+            {
+                NS_ABORT_MSG("message of " << size << " bytes over the MTU");
+            }
+            if (r < 0)
+            {
+                break;
+            }
+            m_offered.push_back(Simulator::Now());
+            m_left -= size;
+        }
+        if (m_left)
+        {
+            // no callback for room in the socket, poll once per segment time
+            Simulator::Schedule(m_poll, &Transfer::Offer, this);
+        }
+    }
+
+    void Receive(uint8_t address, Ptr<Packet> p)
+    {
+        if (m_offered.empty())
+        {
+            return;
+        }
+        // delivered in order, so the oldest message offered is this one
+        m_latencies.push_back((Simulator::Now() - m_offered.front()).GetMicroSeconds());
+        m_offered.pop_front();
+        m_delivered += p->GetSize();
+        m_last = Simulator::Now();
+        if (!m_left && m_offered.empty())
+        {
+            Simulator::Stop();
+        }
+    }
+
+    Ptr<OstNode> m_sender;
+    uint8_t m_to;
+    uint32_t m_segment;
+    uint64_t m_left;
+    Time m_poll;
+    std::vector<uint8_t> m_payload;
+    std::deque<Time> m_offered;
+    std::vector<int64_t> m_latencies; //!< us, in delivery order
+    uint64_t m_delivered;
+    Time m_first;
+    Time m_last;
+};
+
+/**
+ * \return the nearest-rank percentile p of sorted values, 0 if empty
+ */
+int64_t
+Percentile(const std::vector<int64_t>& sorted, double p)
+{
+    if (sorted.empty())
+    {
+        return 0;
+    }
+    size_t rank = size_t(p / 100 * sorted.size() + 0.5);
+    return sorted[std::min(std::max<size_t>(rank, 1), sorted.size()) - 1];
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+    BenchConfig cfg;
+    cfg.rate = "200Mbps";
+    cfg.processing = "100ms";
+    cfg.errorRate = 0;
+    cfg.window = ost::Socket::WINDOW_SZ;
+    cfg.segment = 1024;
+    cfg.transfer = 1 << 20;
+    cfg.stop = 600;
+    cfg.format = "csv";
+    cfg.header = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("rate", "Data rate of the link", cfg.rate);
+    cmd.AddValue("processing", "Receiver processing delay of every frame", cfg.processing);
+    cmd.AddValue("errorRate", "Packet error rate of the receiving devices", cfg.errorRate);
+    cmd.AddValue("window", "Window of the sockets", cfg.window);
+    cmd.AddValue("segment", "Payload bytes per message", cfg.segment);
+    cmd.AddValue("transfer", "Bytes sent from A to B", cfg.transfer);
+    cmd.AddValue("stop", "Simulated seconds before giving up", cfg.stop);
+    cmd.AddValue("format", "csv or json", cfg.format);
+    cmd.AddValue("header", "Print the CSV header line first", cfg.header);
+    cmd.Parse(argc, argv);
+
+    if (cfg.segment == 0 || cfg.segment > ost::Socket::MAX_PAYLOAD || cfg.transfer == 0 ||
+        cfg.window == 0 || cfg.window > ost::Socket::WINDOW_SZ ||
+        (cfg.format != "csv" && cfg.format != "json"))
+    {
+        std::cerr << "segment 1.." << ost::Socket::MAX_PAYLOAD << ", window 1.."
+                  << ost::Socket::WINDOW_SZ << ", transfer > 0, format csv or json" << std::endl;
+        return 1;
+    }
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    SpWHelper spw;
+    spw.SetDeviceAttribute("AnalyticalHandshake", BooleanValue(true));
+    spw.SetDeviceAttribute("DataRate", DataRateValue(DataRate(cfg.rate)));
+    NetDeviceContainer devices = spw.Install(nodes);
+    Ptr<SpWFixedProcessingModel> processing = CreateObject<SpWFixedProcessingModel>();
+    processing->SetDelay(Time(cfg.processing));
+    DynamicCast<SpWDevice>(devices.Get(0))->GetSpWChannel()->SetProcessingModel(processing);
+    if (cfg.errorRate > 0)
+    {
+        Ptr<RateErrorModel> em = CreateObject<RateErrorModel>();
+        em->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
+        em->SetRate(cfg.errorRate);
+        for (uint32_t i = 0; i < devices.GetN(); ++i)
+        {
+            DynamicCast<SpWDevice>(devices.Get(i))->SetCharacterParityErrorModel(em);
+        }
+    }
+
+    OstHelper ost;
+    ost.SetWindow(cfg.window);
+    std::vector<Ptr<OstNode>> ostNodes = ost.Install(devices);
+    Ptr<OstNode> a = ostNodes[0];
+    Ptr<OstNode> b = ostNodes[1];
+
+    Time poll = DataRate(cfg.rate).CalculateBytesTxTime(cfg.segment + ost::SegmentHeader::SIZE);
+    Transfer transfer(a, b->GetAddress(), cfg, Max(poll, NanoSeconds(1)));
+    b->SetReceiveCallback(MakeCallback(&Transfer::Receive, &transfer));
+    ost.Start(a, b, Time(0));
+    Simulator::Schedule(MilliSeconds(1), &Transfer::Offer, &transfer);
+    Simulator::Stop(Seconds(cfg.stop));
+
+    auto wallStart = std::chrono::steady_clock::now();
+    Simulator::Run();
+    auto wallEnd = std::chrono::steady_clock::now();
+    double wall = std::chrono::duration<double>(wallEnd - wallStart).count();
+    uint64_t events = Simulator::GetEventCount();
+
+    ost::SocketStats stats = {};
+    Ptr<OstSocket> socket;
+    if (a->GetSocket(b->GetAddress(), socket) == 1)
+    {
+        stats = socket->GetStats();
+    }
+    std::vector<int64_t> latencies = transfer.m_latencies;
+    std::sort(latencies.begin(), latencies.end());
+    double elapsed = (transfer.m_last - transfer.m_first).GetSeconds();
+    bool complete = transfer.m_delivered == cfg.transfer;
+
+    std::vector<std::pair<std::string, std::string>> fields;
+    auto add = [&fields](std::string name, auto value) {
+        std::ostringstream os;
+        os << value;
+        fields.emplace_back(name, os.str());
+    };
+    add("rate_bps", DataRate(cfg.rate).GetBitRate());
+    add("processing_us", Time(cfg.processing).GetMicroSeconds());
+    add("error_rate", cfg.errorRate);
+    add("window", cfg.window);
+    add("segment", cfg.segment);
+    add("transfer", cfg.transfer);
+    add("run", RngSeedManager::GetRun());
+    add("complete", complete ? 1 : 0);
+    add("delivered", transfer.m_delivered);
+    add("sim_s", elapsed);
+    add("goodput_mbps", elapsed > 0 ? transfer.m_delivered * 8 / elapsed / 1e6 : 0);
+    add("segments_sent", stats.segments_sent);
+    add("retransmissions", stats.retransmissions);
+    add("retx_ratio", stats.segments_sent ? double(stats.retransmissions) / stats.segments_sent : 0);
+    add("latency_p50_us", Percentile(latencies, 50));
+    add("latency_p90_us", Percentile(latencies, 90));
+    add("latency_p99_us", Percentile(latencies, 99));
+    add("latency_max_us", latencies.empty() ? 0 : latencies.back());
+    add("wall_s", wall);
+    add("events", events);
+    add("events_per_s", wall > 0 ? events / wall : 0);
+
+    if (cfg.format == "json")
+    {
+        std::cout << "{";
+        for (size_t i = 0; i < fields.size(); ++i)
+        {
+            std::cout << (i ? ", " : "") << "\"" << fields[i].first << "\": " << fields[i].second;
+        }
+        std::cout << "}" << std::endl;
+    }
+    else
+    {
+        if (cfg.header)
+        {
+            for (size_t i = 0; i < fields.size(); ++i)
+            {
+                std::cout << (i ? "," : "") << fields[i].first;
+            }
+            std::cout << std::endl;
+        }
+        for (size_t i = 0; i < fields.size(); ++i)
+        {
+            std::cout << (i ? "," : "") << fields[i].second;
+        }
+        std::cout << std::endl;
+    }
+
+    Simulator::Destroy();
+    return complete ? 0 : 2;
+}
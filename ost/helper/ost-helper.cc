@@ -1,8 +1,100 @@
 #include "ost-helper.h"
 
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
 namespace ns3
 {
 
-/* ... */
+    NS_LOG_COMPONENT_DEFINE("OstHelper");
+
+    OstHelper::OstHelper()
+        : tick_itperiod(0),
+          tick_itscale(0)
+    {
+    }
+
+    void
+    OstHelper::SetNodeAttribute(std::string name, const AttributeValue &value)
+    {
+        attributes.emplace_back(name, value.Copy());
+    }
+
+    void
+    OstHelper::SetWindow(uint16_t window)
+    {
+        SetNodeAttribute("Window", UintegerValue(window));
+    }
+
+    void
+    OstHelper::SetHwTimerTick(uint32_t itperiod, uint8_t itscale)
+    {
+        tick_itperiod = itperiod;
+        tick_itscale = itscale;
+    }
+
+    void
+    OstHelper::SetReceiveCallback(OstNode::ReceiveCallback cb)
+    {
+        rx_cb = cb;
+    }
+
+    Ptr<OstNode>
+    OstHelper::Install(Ptr<SpWDevice> device) const
+    {
+        NS_LOG_FUNCTION(this << device);
+        Ptr<OstNode> node = CreateObject<OstNode>(device, 0);
+        for (auto &a : attributes)
+            node->SetAttribute(a.first, *a.second);
+        if (tick_itperiod)
+            node->SetHwTimerTick(tick_itperiod, tick_itscale);
+        if (!rx_cb.IsNull())
+            node->SetReceiveCallback(rx_cb);
+        return node;
+    }
+
+    std::vector<Ptr<OstNode>>
+    OstHelper::Install(const NetDeviceContainer &devices) const
+    {
+        std::vector<Ptr<OstNode>> nodes;
+        nodes.reserve(devices.GetN());
+        for (auto i = devices.Begin(); i != devices.End(); ++i)
+        {
+            Ptr<SpWDevice> device = DynamicCast<SpWDevice>(*i);
+            if (device)
+                nodes.push_back(Install(device));
+        }
+        return nodes;
+    }
+
+    std::vector<Ptr<OstNode>>
+    OstHelper::Install(const NodeContainer &nodes) const
+    {
+        NetDeviceContainer devices;
+        for (auto i = nodes.Begin(); i != nodes.End(); ++i)
+        {
+            for (uint32_t j = 0; j < (*i)->GetNDevices(); ++j)
+                devices.Add((*i)->GetDevice(j));
+        }
+        return Install(devices);
+    }
+
+    void
+    OstHelper::Start(Ptr<OstNode> a, Ptr<OstNode> b, Time at) const
+    {
+        Simulator::Schedule(at, &OstNode::start_connection, a, b->GetAddress());
+        Simulator::Schedule(at, &OstNode::start_connection, b, a->GetAddress());
+    }
+
+    void
+    OstHelper::Start(const std::vector<Ptr<OstNode>> &nodes, Time at) const
+    {
+        NS_ABORT_MSG_IF(nodes.size() % 2, "OstHelper starts the nodes in pairs");
+        for (size_t i = 0; i < nodes.size(); i += 2)
+            Start(nodes[i], nodes[i + 1], at);
+    }
 
-}
+} // namespace ns3
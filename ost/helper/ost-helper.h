@@ -1,14 +1,89 @@
 #ifndef OST_HELPER_H
 #define OST_HELPER_H
 
+#include "ns3/attribute.h"
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+#include "ns3/nstime.h"
+#include "ns3/ost_node.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
 namespace ns3
 {
 
-// Each class should be documented using Doxygen,
-// and have an \ingroup ost directive
+    /**
+     * \ingroup ost
+     * Puts an OstNode on SpW devices, see SpWHelper for the links.
+     *
+     * Every node installed gets the attributes of the helper. The nodes are
+     * not started: starting resets the link, so the scenario says when with
+     * Start.
+     */
+    class OstHelper
+    {
+    public:
+        OstHelper();
+
+        /**
+         * \param name the name of an ns3::OstNode attribute
+         * \param value the value every node installed gets
+         */
+        void SetNodeAttribute(std::string name, const AttributeValue &value);
+
+        /**
+         * \param window the window of the sockets, the Window attribute
+         */
+        void SetWindow(uint16_t window);
+
+        /**
+         * \see OstNode::SetHwTimerTick
+         */
+        void SetHwTimerTick(uint32_t itperiod, uint8_t itscale);
+
+        /**
+         * \param cb called by every node with the messages it receives
+         */
+        void SetReceiveCallback(OstNode::ReceiveCallback cb);
+
+        /**
+         * \param device the device the node sends through
+         * \return the node
+         */
+        Ptr<OstNode> Install(Ptr<SpWDevice> device) const;
+
+        /**
+         * \param devices the devices, the ones that are not SpWDevices are left out
+         * \return a node per SpWDevice, in order
+         */
+        std::vector<Ptr<OstNode>> Install(const NetDeviceContainer &devices) const;
+
+        /**
+         * \param nodes the nodes
+         * \return a node per SpWDevice of the nodes, in order
+         */
+        std::vector<Ptr<OstNode>> Install(const NodeContainer &nodes) const;
+
+        /**
+         * Start two nodes at a time, each with a socket open to the other.
+         */
+        void Start(Ptr<OstNode> a, Ptr<OstNode> b, Time at) const;
+
+        /**
+         * Start the nodes two by two, in the order SpWHelper installs the
+         * devices of its links.
+         */
+        void Start(const std::vector<Ptr<OstNode>> &nodes, Time at) const;
 
-/* ... */
+    private:
+        std::vector<std::pair<std::string, Ptr<AttributeValue>>> attributes;
+        uint32_t tick_itperiod;
+        uint8_t tick_itscale;
+        OstNode::ReceiveCallback rx_cb;
+    };
 
-}
+} // namespace ns3
 
 #endif /* OST_HELPER_H */
@@ -0,0 +1,196 @@
+#include "hw_timer.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3 {
+    NS_LOG_COMPONENT_DEFINE("HwTimer");
+
+    HwTimer::HwTimer() :
+        backend(EVENT_DRIVEN),
+        hw({0, 0, 0, 0}),
+        tick_ns(0),
+        running(false),
+        ticking(false),
+        val(0),
+        ticks_passed(0),
+        ticks_to_expire(0),
+        listener(nullptr)
+    {
+        reset_stats();
+    }
+
+    HwTimer::~HwTimer() {}
+
+    void HwTimer::set_listener(ost::TimerDriver::Listener *l) {listener = l;}
+
+    void HwTimer::init() {
+        stop();
+        Simulator::Cancel(e_id);
+        ticking = false;
+        backend = EVENT_DRIVEN;
+        tick_ns = 0;
+        reset_stats();
+    }
+
+    void HwTimer::init_tick(uint32_t itperiod, uint8_t itscale) {
+        stop();
+        Simulator::Cancel(e_id);
+        ticking = false;
+
+        backend = TICK_DRIVEN;
+        hw.ITCR = 1;
+        hw.ITPERIOD = itperiod;
+        hw.ITCOUNT = itperiod;
+        hw.ITSCALE = itscale;
+        // CPU_FREQ is in kHz, so there are CPU_FREQ / 1000 cycles in a microsecond
+        tick_ns = (uint64_t(itperiod) + 1) * (uint64_t(itscale) + 1) * 1000000 / CPU_FREQ;
+        if (tick_ns == 0) tick_ns = 1;
+        tick_origin = Simulator::Now();
+        last_tick = tick_origin;
+        reset_stats();
+        NS_LOG_INFO("tick timer period " << std::to_string(tick_ns) << " ns");
+    }
+
+    HwTimer::Backend HwTimer::get_backend() const {
+        return backend;
+    }
+
+    uint64_t HwTimer::get_tick_period_ns() const {
+        return tick_ns;
+    }
+
+    void HwTimer::start(micros_t duration) {
+        val = duration;
+        running = true;
+        deadline = Simulator::Now() + MicroSeconds(duration);
+
+        if (backend == EVENT_DRIVEN) {
+            Simulator::Cancel(e_id);
+            e_id = Simulator::Schedule(MicroSeconds(duration), &HwTimer::expire, this);
+            return;
+        }
+
+        uint64_t ns = uint64_t(duration) * 1000;
+        ticks_passed = 0;
+        ticks_to_expire = (ns + tick_ns - 1) / tick_ns;
+        // only inside the tick interrupt the phase is known to be zero
+        if (Simulator::Now() != last_tick) ticks_to_expire += 1;
+        if (ticks_to_expire == 0) ticks_to_expire = 1;
+        if (!ticking) schedule_next_tick();
+    }
+
+    void HwTimer::start_ticks(uint32_t ticks) {
+        if (ticks == 0) ticks = 1;
+        val = (uint64_t(ticks) * tick_ns) / 1000;
+        running = true;
+        deadline = tick_origin + NanoSeconds((get_ticks() + ticks) * tick_ns);
+        ticks_passed = 0;
+        ticks_to_expire = ticks;
+        if (!ticking) schedule_next_tick();
+    }
+
+    void HwTimer::stop() {
+        running = false;
+        if (backend == EVENT_DRIVEN) {
+            Simulator::Cancel(e_id);
+        }
+        // the tick keeps running until the next interrupt notices there is nothing to count
+    }
+
+    bool HwTimer::is_running() const {
+        return running;
+    }
+
+    micros_t HwTimer::get_duration() const {
+        return val;
+    }
+
+    micros_t HwTimer::get_left_time() const {
+        if (!running) return 0;
+        if (backend == EVENT_DRIVEN) {
+            // rounded down, a partial microsecond is not left in full
+            return Simulator::GetDelayLeft(e_id).GetMicroSeconds();
+        }
+        uint64_t ticks_left = ticks_to_expire - ticks_passed;
+        if (Simulator::Now() != last_tick) ticks_left -= 1;
+        // the extra tick waited for the unknown phase is not part of the request
+        uint64_t left = ticks_left * tick_ns / 1000;
+        return left < val ? left : val;
+    }
+
+    uint64_t HwTimer::get_ticks() const {
+        if (backend == EVENT_DRIVEN) return 0;
+        // while idle the interrupts are not simulated, but they happen on the target
+        if (ticking) return get_tick_index(last_tick);
+        return get_tick_index(Simulator::Now());
+    }
+
+    const HwTimerStats& HwTimer::get_stats() const {
+        return stats;
+    }
+
+    uint64_t HwTimer::get_interrupts() const {
+        if (backend == EVENT_DRIVEN || ticking) return stats.interrupts;
+        return stats.interrupts + get_tick_index(Simulator::Now()) - get_tick_index(last_tick);
+    }
+
+    double HwTimer::get_interrupt_rate() const {
+        double elapsed = (Simulator::Now() - stats_since).GetSeconds();
+        if (elapsed <= 0) return 0;
+        return get_interrupts() / elapsed;
+    }
+
+    double HwTimer::get_mean_lateness_us() const {
+        if (stats.expirations == 0) return 0;
+        return double(stats.lateness_sum_ns) / stats.expirations / 1000;
+    }
+
+    void HwTimer::reset_stats() {
+        stats = {0, 0, 0, 0};
+        stats_since = Simulator::Now();
+    }
+
+    uint64_t HwTimer::get_tick_index(Time t) const {
+        return (t - tick_origin).GetNanoSeconds() / tick_ns;
+    }
+
+    void HwTimer::schedule_next_tick() {
+        Time now = Simulator::Now();
+        uint64_t next = get_tick_index(now) + 1;
+        uint64_t last = get_tick_index(last_tick);
+        // on the target the ISR ran on every one of these ticks as well
+        if (next - 1 > last) {
+            stats.interrupts += next - 1 - last;
+            last_tick = tick_origin + NanoSeconds((next - 1) * tick_ns);
+        }
+        e_id = Simulator::Schedule(tick_origin + NanoSeconds(next * tick_ns) - now,
+                                   &HwTimer::tick_interrupt_handler,
+                                   this);
+        ticking = true;
+    }
+
+    void HwTimer::tick_interrupt_handler() {
+        ticking = false;
+        stats.interrupts++;
+        last_tick = Simulator::Now();
+        hw.ITCOUNT = hw.ITPERIOD;
+        if (running && ++ticks_passed >= ticks_to_expire) {
+            expire();
+        }
+        if (running && !ticking) {
+            schedule_next_tick();
+        }
+    }
+
+    void HwTimer::expire() {
+        running = false;
+        if (backend == EVENT_DRIVEN) stats.interrupts++;
+        stats.expirations++;
+        int64_t late = (Simulator::Now() - deadline).GetNanoSeconds();
+        stats.lateness_sum_ns += late;
+        if (late > stats.lateness_max_ns) stats.lateness_max_ns = late;
+        NS_LOG_LOGIC("timer for " << std::to_string(val) << " microseconds expired, late by " << std::to_string(late) << " ns");
+        if (listener) listener->timer_expired();
+    }
+}
@@ -0,0 +1,170 @@
+#ifndef HW_TIMER_H
+#define HW_TIMER_H
+
+#include <inttypes.h>
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/ost_platform.h"
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+/**
+ * @ingroup Timer
+ * @struct HardwareTimer
+ * @brief Implementation (elvees 1892VM15F) of hardware timer.
+ *
+ *
+ * @var HardwareTimer::ITCR
+ * Регистр управления (182F_5000). 5 разрядов.
+ *
+ * @var HardwareTimer::ITPERIOD
+ * Регистр периода работы таймера (182F_5004). 32 разрядов.
+ *
+ * @var HardwareTimer::ITCOUNT
+ * Регистр счетчика (182F_5008). 32 разрядов.
+ *
+ * @var HardwareTimer::ITSCALE
+ * Регистр предделителя (182F_500C). 8 разрядов.
+ */
+typedef struct {
+    uint8_t ITCR;
+    uint32_t ITPERIOD;
+    uint32_t ITCOUNT;
+    uint8_t ITSCALE;
+} HardwareTimer;
+
+/**
+ * @ingroup Timer
+ * @struct HwTimerStats
+ * @brief Counters collected by HwTimer to estimate CPU load and accuracy.
+ *
+ * @var HwTimerStats::interrupts
+ * Interrupts taken by the CPU. In tick mode this includes the ticks that
+ * arrive while no timer is armed, they cost an ISR entry on the target too.
+ *
+ * @var HwTimerStats::expirations
+ * Timers delivered to the owner.
+ *
+ * @var HwTimerStats::lateness_sum_ns
+ * Sum of (delivery time - requested deadline) over all expirations.
+ *
+ * @var HwTimerStats::lateness_max_ns
+ * Worst lateness seen.
+ */
+typedef struct {
+    uint64_t interrupts;
+    uint64_t expirations;
+    int64_t lateness_sum_ns;
+    int64_t lateness_max_ns;
+} HwTimerStats;
+
+/**
+ * \ingroup Timer
+ * \class HwTimer
+ * \brief Single one-shot hardware timer with two interchangeable backends.
+ *
+ * EVENT_DRIVEN programs the interval timer for the exact duration and reads
+ * the remaining time back from the simulator. This is what the simulator can
+ * do, but the 1892VM15F can not: ITCOUNT of the interval timer is not
+ * readable.
+ *
+ * TICK_DRIVEN keeps the interval timer free-running with period
+ * (ITPERIOD + 1) * (ITSCALE + 1) / CPU_FREQ and counts ticks in software,
+ * the way it has to be done on the target. A timer never fires early: when
+ * it is armed outside the tick interrupt the phase of the tick is unknown,
+ * so one extra tick is waited. The price is up to one tick of lateness and
+ * one interrupt per tick, both are accounted in HwTimerStats.
+ */
+class HwTimer : public SimpleRefCount<HwTimer>, public ost::TimerDriver
+{
+    public:
+        typedef enum {
+            EVENT_DRIVEN = 0,
+            TICK_DRIVEN
+        } Backend;
+
+        HwTimer();
+        ~HwTimer();
+
+        void set_listener(ost::TimerDriver::Listener *l) override;
+
+        /**
+         * Use the one-shot (event driven) backend.
+         */
+        void init();
+
+        /**
+         * Use the periodic tick backend.
+         *
+         * \param itperiod value of the ITPERIOD register
+         * \param itscale value of the ITSCALE register
+         */
+        void init_tick(uint32_t itperiod, uint8_t itscale);
+
+        Backend get_backend() const;
+        uint64_t get_tick_period_ns() const override;
+
+        /**
+         * Arm the timer, the previous one (if any) is dropped.
+         *
+         * \param duration in microseconds
+         */
+        void start(micros_t duration) override;
+
+        /**
+         * Arm the timer to expire on the n-th tick counted from the last one,
+         * tick backend only. Unlike start() no extra tick is added for the
+         * unknown phase, the caller counts in ticks itself.
+         */
+        void start_ticks(uint32_t ticks) override;
+        void stop() override;
+        bool is_running() const override;
+        micros_t get_duration() const override;
+
+        /**
+         * Time left before expiration as the software sees it. In tick mode
+         * it is a lower bound, the position inside the current tick is unknown.
+         */
+        micros_t get_left_time() const override;
+
+        /**
+         * Ticks since init_tick(), the counter the tick interrupt keeps on the target.
+         */
+        uint64_t get_ticks() const override;
+
+        const HwTimerStats& get_stats() const;
+
+        /**
+         * Interrupts taken including idle ticks up to now.
+         */
+        uint64_t get_interrupts() const;
+        double get_interrupt_rate() const;
+        double get_mean_lateness_us() const;
+        void reset_stats();
+
+    private:
+        void expire();
+        void tick_interrupt_handler();
+        void schedule_next_tick();
+        uint64_t get_tick_index(Time t) const;
+
+        Backend backend;
+        HardwareTimer hw;
+        uint64_t tick_ns;
+        Time tick_origin;
+        Time last_tick;
+        Time stats_since;
+        EventId e_id;
+        bool running;
+        bool ticking;
+        micros_t val;
+        uint32_t ticks_passed;
+        uint32_t ticks_to_expire;
+        Time deadline;
+        HwTimerStats stats;
+        ost::TimerDriver::Listener *listener;
+};
+
+}
+#endif
@@ -23,86 +23,111 @@ namespace ns3
     void
     OstHeader::Print(std::ostream& os) const
     {
-        os << "flags: " << std::to_string(flags) <<  ", seq_n: " << std::to_string(seq_number)<< ", payload_length: " << std::to_string(payload_length)  << ", src arddr: " << std::to_string(source_addr);
+        os << "flags: " << std::to_string(hdr.flags) <<  ", seq_n: " << std::to_string(hdr.seq_number)<< ", payload_length: " << std::to_string(hdr.payload_length)  << ", src arddr: " << std::to_string(hdr.source_addr);
     }
 
     uint32_t
     OstHeader::GetSerializedSize() const
     {
-        return 5;
+        return ost::SegmentHeader::SIZE;
     }
 
     void
     OstHeader::Serialize(Buffer::Iterator start) const
     {
-        Buffer::Iterator i = start;
-
-        i.WriteU8(flags);
-        i.WriteU8(source_addr);
-        i.WriteU8(seq_number);
-        i.WriteU16(payload_length);
+        uint8_t buffer[ost::SegmentHeader::SIZE];
+        hdr.write(buffer);
+        start.Write(buffer, ost::SegmentHeader::SIZE);
     }
 
     uint32_t
     OstHeader::Deserialize(Buffer::Iterator start)
     {
-        Buffer::Iterator i = start;
-        flags = i.ReadU8();
-        source_addr = i.ReadU8();
-        seq_number = i.ReadU8();
-        payload_length = i.ReadU16();
+        uint8_t buffer[ost::SegmentHeader::SIZE];
+        start.Read(buffer, ost::SegmentHeader::SIZE);
+        hdr.read(buffer);
         return GetSerializedSize();
     }
 
     void OstHeader::set_seq_number(uint8_t n) {
-        seq_number = n;
+        hdr.seq_number = n;
     }
     uint8_t OstHeader::get_seq_number() {
-        return seq_number;
+        return hdr.seq_number;
     }
 
     void OstHeader::set_src_addr(uint8_t addr) {
-        source_addr = addr;
+        hdr.source_addr = addr;
     }
     uint8_t OstHeader::get_src_addr() {
-        return source_addr;
+        return hdr.source_addr;
     }
 
     void OstHeader::set_payload_len(uint16_t l) {
-        payload_length = l;
+        hdr.payload_length = l;
     }
     uint16_t OstHeader::get_payload_len() {
-        return payload_length;
+        return hdr.payload_length;
     }
 
     void OstHeader::set_flag(SegmentFlag flag) {
-        switch (flag)
-        {
-        case ACK:
-            flags |= 0b00000001;
-            break;
-        case SYN:
-            flags |= 0b00000010;
-            break;
-        case RST:
-            flags |= 0b00000100;
-            break;
-        default:
-            flags &= 0b11111000;
-            break;
-        }
+        hdr.set_flag(flag);
     }
 
     bool OstHeader::is_ack() {
-        return flags & 0b00000001;
+        return hdr.is_ack();
     }
     bool OstHeader::is_syn() {
-        return flags & 0b00000010;
+        return hdr.is_syn();
     }
     bool OstHeader::is_rst() {
-        return flags & 0b00000100;
+        return hdr.is_rst();
     }
     bool OstHeader::is_dta() {
-        return (flags & 0b00000111) == 0;
+        return hdr.is_dta();
+    }
+
+    TypeId
+    OstTimestampTag::GetTypeId()
+    {
+        static TypeId tid = TypeId("ns3::OstTimestampTag")
+                                .SetParent<Tag>()
+                                .SetGroupName("Spw")
+                                .AddConstructor<OstTimestampTag>();
+        return tid;
+    }
+
+    TypeId
+    OstTimestampTag::GetInstanceTypeId() const
+    {
+        return GetTypeId();
+    }
+
+    uint32_t
+    OstTimestampTag::GetSerializedSize() const
+    {
+        return 8;
+    }
+
+    void
+    OstTimestampTag::Serialize(TagBuffer i) const
+    {
+        i.WriteU64(sent.GetTimeStep());
+    }
+
+    void
+    OstTimestampTag::Deserialize(TagBuffer i)
+    {
+        sent = TimeStep(i.ReadU64());
+    }
+
+    void
+    OstTimestampTag::Print(std::ostream& os) const
+    {
+        os << "sent: " << sent;
+    }
+
+    Time OstTimestampTag::get_sent() const {
+        return sent;
     }
 }
@@ -5,33 +5,30 @@
 #include <stdbool.h>
 
 #include "ns3/header.h"
+#include "ns3/nstime.h"
+#include "ns3/ost_segment.h"
+#include "ns3/tag.h"
 #include "spw_packet.h"
 
 namespace ns3
 {
 
-    typedef enum
-    {
-        ACK,
-        SYN,
-        RST,
-        DTA // virtual
-    } SegmentFlag;
+    using ost::SegmentFlag;
+    using ost::ACK;
+    using ost::SYN;
+    using ost::RST;
+    using ost::DTA;
 
+    /**
+     * \ingroup ost
+     * ns-3 view of ost::SegmentHeader, the byte layout is the same.
+     */
     class OstHeader : public Header
     {
-        typedef uint8_t FlagOctet;
-
     public:
-        OstHeader()
-            : flags(0),
-              seq_number(0),
-              source_addr(0),
-              payload_length(0){};
+        OstHeader(){};
         OstHeader(uint8_t seq_n, uint8_t addr, uint16_t len)
-            : seq_number(seq_n),
-              source_addr(addr),
-              payload_length(len){};
+            : hdr(seq_n, addr, len){};
         ~OstHeader(){};
 
         static TypeId GetTypeId();
@@ -59,10 +56,31 @@ namespace ns3
         bool is_dta();
 
     private:
-        FlagOctet flags;
-        uint8_t seq_number;
-        uint8_t source_addr;
-        uint16_t payload_length;
+        ost::SegmentHeader hdr;
+    };
+
+    /**
+     * \ingroup ost
+     * Time a frame was handed to the link, for the latency of the flows.
+     */
+    class OstTimestampTag : public Tag
+    {
+    public:
+        OstTimestampTag(){};
+        OstTimestampTag(Time sent)
+            : sent(sent){};
+
+        static TypeId GetTypeId();
+        TypeId GetInstanceTypeId() const override;
+        uint32_t GetSerializedSize() const override;
+        void Serialize(TagBuffer i) const override;
+        void Deserialize(TagBuffer i) override;
+        void Print(std::ostream &os) const override;
+
+        Time get_sent() const;
+
+    private:
+        Time sent;
     };
 
 }
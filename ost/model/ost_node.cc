@@ -1,10 +1,15 @@
 #include "ost_node.h"
 #include "ost_socket.h"
 
+#include "ns3/abort.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/enum.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/spw-address-tag.h"
 #include "ns3/spw-channel.h"
-#include "ns3/drop-tail-queue.h"
+#include "ns3/spw-codel-queue.h"
+#include "ns3/uinteger.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -14,113 +19,177 @@ namespace ns3
 
     NS_LOG_COMPONENT_DEFINE("OstNode");
 
+    NS_OBJECT_ENSURE_REGISTERED(OstNode);
+
+    TypeId
+    OstNode::GetTypeId()
+    {
+        const ost::SocketOptions defaults = ost::Socket::default_options();
+        static TypeId tid =
+            TypeId("ns3::OstNode")
+                .SetParent<Object>()
+                .SetGroupName("Ost")
+                .AddAttribute("Window",
+                              "Segments a socket keeps in flight",
+                              UintegerValue(defaults.window),
+                              MakeUintegerAccessor(&OstNode::SetWindow, &OstNode::GetWindow),
+                              MakeUintegerChecker<uint16_t>(1, ost::Socket::WINDOW_SZ))
+                .AddAttribute("TransmitFifoSize",
+                              "Messages a socket queues before its window",
+                              UintegerValue(defaults.transmit_fifo_sz),
+                              MakeUintegerAccessor(&OstNode::SetTransmitFifoSize,
+                                                   &OstNode::GetTransmitFifoSize),
+                              MakeUintegerChecker<uint16_t>(1, ost::Socket::TRANSMIT_FIFO_SZ))
+                .AddAttribute("Mtu",
+                              "Largest frame a socket sends, segment header included",
+                              UintegerValue(defaults.mtu),
+                              MakeUintegerAccessor(&OstNode::SetMtu, &OstNode::GetMtu),
+                              MakeUintegerChecker<uint32_t>(ost::SegmentHeader::SIZE + 1,
+                                                            ost::config::MTU))
+                .AddAttribute("InitialRto",
+                              "Retransmission timeout before a round trip is measured",
+                              TimeValue(MicroSeconds(defaults.rto_initial)),
+                              MakeTimeAccessor(&OstNode::SetInitialRto, &OstNode::GetInitialRto),
+                              MakeTimeChecker(Time(0), MicroSeconds(MAX_TIMER_DURATION)))
+                .AddAttribute("MinRto",
+                              "Lower bound of the retransmission timeout",
+                              TimeValue(MicroSeconds(defaults.rto_min)),
+                              MakeTimeAccessor(&OstNode::SetMinRto, &OstNode::GetMinRto),
+                              MakeTimeChecker(Time(0), MicroSeconds(MAX_TIMER_DURATION)))
+                .AddAttribute("MaxRto",
+                              "Upper bound of the retransmission timeout, "
+                              "equal to MinRto for a fixed one",
+                              TimeValue(MicroSeconds(defaults.rto_max)),
+                              MakeTimeAccessor(&OstNode::SetMaxRto, &OstNode::GetMaxRto),
+                              MakeTimeChecker(Time(0), MicroSeconds(MAX_TIMER_DURATION)))
+                .AddAttribute("AckPolicy",
+                              "ACK for each segment as it arrives, or held for AckDelay",
+                              EnumValue<ost::AckPolicy>(defaults.ack_policy),
+                              MakeEnumAccessor<ost::AckPolicy>(&OstNode::SetAckPolicy,
+                                                               &OstNode::GetAckPolicy),
+                              MakeEnumChecker(ost::ACK_EACH, "Each", ost::ACK_DELAYED, "Delayed"))
+                .AddAttribute("AckDelay",
+                              "Time a delayed ACK is held",
+                              TimeValue(MicroSeconds(defaults.ack_delay)),
+                              MakeTimeAccessor(&OstNode::SetAckDelay, &OstNode::GetAckDelay),
+                              MakeTimeChecker(Time(0), MicroSeconds(MAX_TIMER_DURATION)))
+                .AddAttribute("LinkDepth",
+                              "Frames kept in the SpW device once it reports departures",
+                              UintegerValue(ost::Node::LINK_DEPTH),
+                              MakeUintegerAccessor(&OstNode::SetLinkDepth, &OstNode::GetLinkDepth),
+                              MakeUintegerChecker<uint8_t>(1))
+                .AddAttribute("TimerTickPeriod",
+                              "ITPERIOD of a tick driven node timer, 0 for one-shot "
+                              "timers; read by start()",
+                              UintegerValue(0),
+                              MakeUintegerAccessor(&OstNode::tick_itperiod),
+                              MakeUintegerChecker<uint32_t>())
+                .AddAttribute("TimerTickScale",
+                              "ITSCALE of a tick driven node timer",
+                              UintegerValue(0),
+                              MakeUintegerAccessor(&OstNode::tick_itscale),
+                              MakeUintegerChecker<uint8_t>());
+        return tid;
+    }
+
     OstNode::OstNode(Ptr<SpWDevice> dev, int8_t mode)
-        : spw_layer(dev),
-          ports(std::vector<OstSocket*>()),
-          WINDOW_SZ(1)
+        : ports(std::vector<Ptr<OstSocket>>()),
+          spw_layer(dev),
+          hw_timer(Create<HwTimer>()),
+          link(dev),
+          link_reset(false),
+          tick_itperiod(0),
+          tick_itscale(0)
     {
-        spw_layer->GetAddress().CopyTo(&self_address);
-        spw_layer->SetReceiveCallback(MakeCallback(&OstNode::NetworkLayerReceive, this));
-        spw_layer->SetDeviceReadyCallback(MakeCallback(&OstNode::SpwReadyHandler, this));
+        Init();
     }
 
     OstNode::OstNode(Ptr<SpWDevice> dev, int8_t mode, uint16_t window_sz)
-        : spw_layer(dev),
-          ports(std::vector<OstSocket*>()),
-          WINDOW_SZ(window_sz)
+        : OstNode(dev, mode)
+    {
+        SetAttribute("Window", UintegerValue(window_sz));
+    }
+
+    OstNode::~OstNode()
+    {
+        delete core;
+    }
+
+    void
+    OstNode::Init()
     {
         spw_layer->GetAddress().CopyTo(&self_address);
         spw_layer->SetReceiveCallback(MakeCallback(&OstNode::NetworkLayerReceive, this));
         spw_layer->SetDeviceReadyCallback(MakeCallback(&OstNode::SpwReadyHandler, this));
+        spw_layer->SetPacketLostCallback(MakeCallback(&OstNode::SpwPacketLostHandler, this));
+        spw_layer->SetPacketSentCallback(MakeCallback(&OstNode::SpwPacketSentHandler, this));
+        spw_layer->AddLinkChangeCallback(MakeCallback(&OstNode::SpwLinkChangeHandler, this));
+        spw_layer->SetTimeCodeCallback(MakeCallback(&OstNode::SpwTimeCodeHandler, this));
+        link.SetLostCallback(MakeCallback(&OstNode::ReportFrameLost, this));
+        if (!spw_layer->GetControlQueue())
+        {
+            // ACKs must not wait behind the data frames of the other sockets
+            spw_layer->SetControlQueue(CreateObject<DropTailQueue<Packet>>());
+        }
+        Ptr<SpWCoDelQueue> aqm = DynamicCast<SpWCoDelQueue>(spw_layer->GetQueue());
+        if (aqm)
+            aqm->SetCongestionCallback(MakeCallback(&OstNode::SpwCongestionHandler, this));
+
+        ost::Platform platform;
+        platform.clock = &events;
+        platform.events = &events;
+        platform.timer = PeekPointer(hw_timer);
+        platform.link = &link;
+        platform.buffers = &buffers;
+        core = new ost::Node(self_address, platform);
+        core->set_listener(this);
     }
 
-    OstNode::~OstNode()
+    int8_t
+    OstNode::start(uint8_t hw_timer_id)
     {
+        return start_connection(1 - hw_timer_id);
     }
 
     int8_t
-    OstNode::start(uint8_t hw_timer_id)
+    OstNode::start_connection(uint8_t address)
     {
-        OstSocket* smth = new OstSocket(this);
-        ports.push_back(smth);
+        if (tick_itperiod)
+            hw_timer->init_tick(tick_itperiod, tick_itscale);
+        else
+            hw_timer->init();
+
+        if (core->start() != 0)
+            return -1;
+        uint8_t port = core->get_ports_count() - 1;
+        ports.push_back(CreateObject<OstSocket>(core->get_port(port)));
         spw_layer->ErrorResetSpWState();
-        open_connection(1 - hw_timer_id);
+        open_connection(address);
         return 0;
     }
 
     void
     OstNode::shutdown()
     {
-        for (int i = 0; i < ports.size(); ++i)
-        {
-            if (ports[i] && ports[i]->GetAddress() != self_address && ports[i]->GetState() != OstSocket::State::CLOSED)
-            {
-                ports[i]->close();
-            }
-        }
+        core->shutdown();
         spw_layer->Shutdown();
     }
 
     int8_t
     OstNode::open_connection(uint8_t addr)
     {
-        if (addr == self_address)
+        int8_t r = core->open_connection(addr);
+        if (r == -1)
         {
             NS_LOG_ERROR("bad address\n");
-            return -1;
-        }
-
-        Ptr<OstSocket> sk;
-        int8_t r = GetSocket(addr, sk);
-        if (r != 1) // create new
-        {
-            int8_t r = AggregateSocket(addr);
-            if (r != -1)
-                ports[r]->open(OstSocket::Mode::CONNECTIONLESS);
         }
-        else
-        {
-            if (sk->GetState() == OstSocket::OPEN)
-                return 0; // already opened
-            sk->open(OstSocket::Mode::CONNECTIONLESS);
-        }
-        return 1;
+        return r;
     }
 
     int8_t
     OstNode::close_connection(uint8_t addr)
     {
-        if (addr == self_address)
-            return -1;
-
-        for (int i = 0; i < ports.size(); ++i)
-        {
-            if (ports[i]->GetAddress() == addr)
-            {
-                ports[i]->close();
-                return 1;
-            }
-        }
-        return 0;
-    }
-
-    int8_t
-    OstNode::event_handler(const TransportLayerEvent e)
-    {
-        switch (e)
-        {
-        case PACKET_ARRIVED_FROM_NETWORK:
-            if (that_arrived)
-            {
-                ports[0]->socket_event_handler(OstSocket::Event::PACKET_ARRIVED_FROM_NETWORK, that_arrived, 0);
-            }
-            break;
-        case APPLICATION_PACKET_READY:
-            break;
-        default:
-            break;
-        }
-        return 0;
+        return core->close_connection(addr);
     }
 
     int8_t
@@ -140,16 +209,7 @@ namespace ns3
     int8_t
     OstNode::AggregateSocket(uint8_t address)
     {
-        for (int i = 0; i < ports.size(); ++i)
-        {
-            if (!ports[i]->IsAggregated())
-            {
-                ports[i]->SetAddress(address);
-                ports[i]->SetAggregated(true);
-                return i;
-            }
-        }
-        return -1;
+        return core->aggregate_socket(address);
     }
 
     int8_t
@@ -171,8 +231,14 @@ namespace ns3
         return spw_layer;
     }
 
+    ost::TimerService &
+    OstNode::GetTimerService() const
+    {
+        return core->get_timer_service();
+    }
+
     uint8_t
-    OstNode::GetAddress() const { 
+    OstNode::GetAddress() const {
         return self_address;
     }
 
@@ -182,60 +248,387 @@ namespace ns3
         rx_cb = cb;
     }
 
+    void
+    OstNode::SetHwTimerTick(uint32_t itperiod, uint8_t itscale)
+    {
+        tick_itperiod = itperiod;
+        tick_itscale = itscale;
+    }
+
+    bool
+    OstNode::GetHwTimerTick(uint32_t &itperiod, uint8_t &itscale) const
+    {
+        itperiod = tick_itperiod;
+        itscale = tick_itscale;
+        return tick_itperiod != 0;
+    }
+
+    void
+    OstNode::SetSocketOptions(const ost::SocketOptions &options)
+    {
+        NS_ABORT_MSG_IF(core->set_socket_options(options) != 1, "socket options out of range");
+    }
+
+    const ost::SocketOptions &
+    OstNode::GetSocketOptions() const
+    {
+        return core->get_socket_options();
+    }
+
+    void
+    OstNode::SetWindow(uint16_t window)
+    {
+        ost::SocketOptions o = GetSocketOptions();
+        o.window = window;
+        SetSocketOptions(o);
+    }
+
+    uint16_t
+    OstNode::GetWindow() const
+    {
+        return GetSocketOptions().window;
+    }
+
+    void
+    OstNode::SetTransmitFifoSize(uint16_t size)
+    {
+        ost::SocketOptions o = GetSocketOptions();
+        o.transmit_fifo_sz = size;
+        SetSocketOptions(o);
+    }
+
+    uint16_t
+    OstNode::GetTransmitFifoSize() const
+    {
+        return GetSocketOptions().transmit_fifo_sz;
+    }
+
+    void
+    OstNode::SetMtu(uint32_t mtu)
+    {
+        ost::SocketOptions o = GetSocketOptions();
+        o.mtu = mtu;
+        SetSocketOptions(o);
+    }
+
+    uint32_t
+    OstNode::GetMtu() const
+    {
+        return GetSocketOptions().mtu;
+    }
+
+    void
+    OstNode::SetInitialRto(Time rto)
+    {
+        ost::SocketOptions o = GetSocketOptions();
+        o.rto_initial = rto.GetMicroSeconds();
+        SetSocketOptions(o);
+    }
+
+    Time
+    OstNode::GetInitialRto() const
+    {
+        return MicroSeconds(GetSocketOptions().rto_initial);
+    }
+
+    void
+    OstNode::SetMinRto(Time rto)
+    {
+        ost::SocketOptions o = GetSocketOptions();
+        o.rto_min = rto.GetMicroSeconds();
+        SetSocketOptions(o);
+    }
+
+    Time
+    OstNode::GetMinRto() const
+    {
+        return MicroSeconds(GetSocketOptions().rto_min);
+    }
+
+    void
+    OstNode::SetMaxRto(Time rto)
+    {
+        ost::SocketOptions o = GetSocketOptions();
+        o.rto_max = rto.GetMicroSeconds();
+        SetSocketOptions(o);
+    }
+
+    Time
+    OstNode::GetMaxRto() const
+    {
+        return MicroSeconds(GetSocketOptions().rto_max);
+    }
+
+    void
+    OstNode::SetAckPolicy(ost::AckPolicy policy)
+    {
+        ost::SocketOptions o = GetSocketOptions();
+        o.ack_policy = policy;
+        SetSocketOptions(o);
+    }
+
+    ost::AckPolicy
+    OstNode::GetAckPolicy() const
+    {
+        return GetSocketOptions().ack_policy;
+    }
+
+    void
+    OstNode::SetAckDelay(Time delay)
+    {
+        ost::SocketOptions o = GetSocketOptions();
+        o.ack_delay = delay.GetMicroSeconds();
+        SetSocketOptions(o);
+    }
+
+    Time
+    OstNode::GetAckDelay() const
+    {
+        return MicroSeconds(GetSocketOptions().ack_delay);
+    }
+
+    void
+    OstNode::SetLinkDepth(uint8_t depth)
+    {
+        NS_ABORT_MSG_IF(core->set_link_depth(depth) != 1, "link depth must be positive");
+    }
+
+    uint8_t
+    OstNode::GetLinkDepth() const
+    {
+        return core->get_link_depth();
+    }
+
+    HwTimerStats
+    OstNode::GetTimerStats() const
+    {
+        HwTimerStats total = hw_timer->get_stats();
+        total.interrupts = hw_timer->get_interrupts();
+        return total;
+    }
+
+    void
+    OstNode::AssignSlot(uint8_t address, uint8_t slot)
+    {
+        link.AssignSlot(address, slot);
+    }
+
+    void
+    OstNode::SetSlotDuration(Time duration)
+    {
+        link.SetSlotDuration(duration);
+    }
+
+    uint32_t
+    OstNode::GetHeldFrames() const
+    {
+        return link.GetHeldFrames();
+    }
+
+    OstFlowStats
+    OstNode::GetFlowStats(uint8_t address) const
+    {
+        auto it = flows.find(address);
+        return it == flows.end() ? OstFlowStats() : it->second;
+    }
+
+    void
+    OstNode::segment_received(uint8_t src_addr, uint8_t port, const uint8_t *payload, uint16_t len)
+    {
+        Ptr<Packet> p = Create<Packet>(payload, len);
+        NS_LOG_LOGIC("NODE[" << std::to_string(self_address) << ":" << std::to_string(port)
+                             << "] received " << std::to_string(len) << " bytes from " << std::to_string(src_addr));
+        if (port < ports.size())
+            ports[port]->Deliver(src_addr, p);
+        if (!rx_cb.IsNull())
+            rx_cb(src_addr, p);
+    }
+
     bool
     OstNode::NetworkLayerReceive(Ptr<NetDevice> dev,
                                  Ptr<const Packet> pkt,
                                  uint16_t mode,
                                  const Address &sender)
     {
-        Simulator::ScheduleNow(&OstSocket::socket_event_handler, ports[0], OstSocket::Event::PACKET_ARRIVED_FROM_NETWORK, pkt->Copy(), 0);
+        if (ports.size() == 0)
+            return false;
+
+        Simulator::ScheduleNow(&OstNode::ReceiveFrame, this, pkt->Copy());
         return true;
     }
 
+    void
+    OstNode::ReceiveFrame(Ptr<Packet> pkt)
+    {
+        uint32_t len = pkt->GetSize();
+        if (len > ost::SegmentHeader::SIZE + ost::Socket::MAX_PAYLOAD)
+        {
+            NS_LOG_ERROR("frame of " << std::to_string(len) << " bytes dropped");
+            return;
+        }
+        std::vector<uint8_t> frame(len);
+        pkt->CopyData(frame.data(), len);
+        NS_LOG_LOGIC("NODE[" << std::to_string(self_address) << "] " << GetSegmentTypeName(len > 0 && (frame[0] & 1) ? ost::ACK : ost::DTA)
+                             << " segment of " << std::to_string(len) << " bytes arrived");
+        OstTimestampTag sent;
+        if (len >= ost::SegmentHeader::SIZE && pkt->PeekPacketTag(sent))
+        {
+            ost::SegmentHeader header;
+            header.read(frame.data());
+            if (header.is_dta())
+            {
+                Time latency = Simulator::Now() - sent.get_sent();
+                OstFlowStats &flow = flows[header.source_addr];
+                if (flow.frames == 0 || latency < flow.latency_min)
+                    flow.latency_min = latency;
+                if (latency > flow.latency_max)
+                    flow.latency_max = latency;
+                flow.latency_sum += latency;
+                flow.frames++;
+            }
+        }
+        core->receive_frame(frame.data(), len);
+    }
+
     void
     OstNode::SpwReadyHandler()
     {
-        if(ports.size())
-            Simulator::ScheduleNow(&OstSocket::peek_from_transmit_fifo, ports[0]);
-        return;
+        Simulator::ScheduleNow(&OstNode::LinkReady, this);
     }
 
-    std::string
-    OstNode::GetSegmentTypeName(SegmentFlag t)
+    void
+    OstNode::LinkReady()
     {
-        switch (t)
+        if (link_reset)
         {
-        case ACK:
-            return "ACK";
-        default:
-            return "DATA";
+            link_reset = false;
+            link.DropHeldFrames();
         }
+        core->link_ready();
+    }
+
+    void
+    OstNode::SpwPacketLostHandler(Ptr<const Packet> pkt)
+    {
+        Simulator::ScheduleNow(&OstNode::FrameLost, this, pkt->Copy());
+    }
+
+    void
+    OstNode::FrameLost(Ptr<Packet> pkt)
+    {
+        ReportFrameLost(GetPeerAddress(pkt), pkt);
+    }
+
+    void
+    OstNode::ReportFrameLost(uint8_t peer_address, Ptr<const Packet> pkt)
+    {
+        uint32_t len = pkt->GetSize();
+        if (len > ost::SegmentHeader::SIZE + ost::Socket::MAX_PAYLOAD)
+            return;
+        std::vector<uint8_t> frame(len);
+        pkt->CopyData(frame.data(), len);
+        NS_LOG_LOGIC("NODE[" << std::to_string(self_address) << "] " << GetSegmentTypeName(len > 0 && (frame[0] & 1) ? ost::ACK : ost::DTA)
+                             << " segment of " << std::to_string(len) << " bytes lost in the link");
+        core->frame_lost(peer_address, frame.data(), len);
+    }
+
+    void
+    OstNode::SpwPacketSentHandler(Ptr<const Packet> pkt)
+    {
+        // the header is all the socket looks at
+        uint32_t len = pkt->GetSize();
+        if (len < ost::SegmentHeader::SIZE || len > ost::SegmentHeader::SIZE + ost::Socket::MAX_PAYLOAD)
+            return;
+        std::vector<uint8_t> header(ost::SegmentHeader::SIZE);
+        pkt->CopyData(header.data(), header.size());
+        Simulator::ScheduleNow(&OstNode::FrameSent, this, GetPeerAddress(pkt), header, len);
+    }
+
+    void
+    OstNode::FrameSent(uint8_t peer_address, std::vector<uint8_t> header, uint16_t len)
+    {
+        core->frame_sent(peer_address, header.data(), len);
+    }
+
+    void
+    OstNode::SpwCongestionHandler(Ptr<const Packet> pkt, bool dropped)
+    {
+        Simulator::ScheduleNow(&OstNode::Congestion, this, pkt->Copy(), dropped);
+    }
+
+    void
+    OstNode::Congestion(Ptr<Packet> pkt, bool dropped)
+    {
+        uint32_t len = pkt->GetSize();
+        if (len > ost::SegmentHeader::SIZE + ost::Socket::MAX_PAYLOAD)
+            return;
+        std::vector<uint8_t> frame(len);
+        pkt->CopyData(frame.data(), len);
+        uint8_t peer_address = GetPeerAddress(pkt);
+        NS_LOG_LOGIC("NODE[" << std::to_string(self_address) << "] " << GetSegmentTypeName(len > 0 && (frame[0] & 1) ? ost::ACK : ost::DTA)
+                             << " segment of " << std::to_string(len) << " bytes " << (dropped ? "dropped" : "marked") << " by the device queue");
+        core->congestion(peer_address, frame.data(), len);
+        if (dropped)
+            core->frame_lost(peer_address, frame.data(), len);
+    }
+
+    void
+    OstNode::SpwTimeCodeHandler(Ptr<SpWDevice> dev, uint8_t time_code)
+    {
+        Simulator::ScheduleNow(&OstNode::SlotStart, this, time_code);
+    }
+
+    void
+    OstNode::SlotStart(uint8_t time_code)
+    {
+        link.SlotStart(time_code);
+    }
+
+    void
+    OstNode::SpwLinkChangeHandler()
+    {
+        // coming up is reported by the device ready callback
+        if (!spw_layer->IsReadyToTransmit())
+            Simulator::ScheduleNow(&OstNode::LinkDown, this);
+    }
+
+    void
+    OstNode::LinkDown()
+    {
+        NS_LOG_LOGIC("NODE[" << std::to_string(self_address) << "] link down");
+        // frames held for a slot belong to the link that is being reset
+        link_reset = true;
+        link.DropHeldFrames();
+        core->link_down();
+    }
+
+    uint8_t
+    OstNode::GetPeerAddress(Ptr<const Packet> pkt) const
+    {
+        // behind routers the frame names its node, otherwise it is for the peer
+        SpWAddressTag tag;
+        if (pkt->PeekPacketTag(tag))
+            return tag.GetLogicalAddress();
+        uint8_t peer_address;
+        spw_layer->GetRemote().CopyTo(&peer_address);
+        return peer_address;
     }
 
     std::string
-    OstNode::GetTransportEventName(TransportLayerEvent e)
+    OstNode::GetSegmentTypeName(SegmentFlag t)
     {
-        switch (e)
+        switch (t)
         {
-        case PACKET_ARRIVED_FROM_NETWORK:
-            return "PACKET_ARRIVED_FROM_NETWORK";
-        case APPLICATION_PACKET_READY:
-            return "APPLICATION_PACKET_READY";
-        case RETRANSMISSION_INTERRUPT:
-            return "RETRANSMISSION_INTERRUPT";
-        case SPW_READY:
-            return "SPW_READY";
+        case ACK:
+            return "ACK";
         default:
-            return "unknown event";
+            return "DATA";
         }
     }
 
     int8_t
     OstNode::send_packet(uint8_t address, const uint8_t *buffer, uint32_t size)
     {
-        std::cout << "to send\n";
-        if (ports.size() == 0 || ports[0]->GetAddress() != address || ports[0]->GetState() != OstSocket::State::OPEN)
-            return -1;
-        return ports[0]->send(buffer, size);
+        return core->send_packet(address, buffer, size);
     }
-} // namespace ns3
\ No newline at end of file
+} // namespace ns3
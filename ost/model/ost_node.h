@@ -1,15 +1,22 @@
 #ifndef OST_NODE_H
 #define OST_NODE_H
 
-#include "timer_fifo.h"
+#include "hw_timer.h"
+#include "ost_ns3_platform.h"
 
 #include "ns3/callback.h"
+#include "ns3/deprecated.h"
+#include "ns3/nstime.h"
 #include "ns3/object.h"
 #include "ns3/ost-header.h"
+#include "ns3/ost_core_node.h"
+#include "ns3/ost_static_pool.h"
 #include "ns3/ptr.h"
 #include "ns3/spw-device.h"
 
 #include <inttypes.h>
+#include <map>
+#include <vector>
 
 /**
  * \defgroup ost Open SpaceWire Transport Layer Node
@@ -20,62 +27,194 @@ namespace ns3
 
     class OstSocket;
 
-    typedef enum
+    /**
+     * \ingroup ost
+     * Latency of the data frames of a flow, from the time the sending node
+     * handed them to its link to their arrival at the receiving node.
+     * Retransmissions count as frames of their own. The jitter is
+     * latency_max - latency_min.
+     */
+    struct OstFlowStats
     {
-        PACKET_ARRIVED_FROM_NETWORK = 0,
-        APPLICATION_PACKET_READY,
-        RETRANSMISSION_INTERRUPT,
-        SPW_READY,
-    } TransportLayerEvent;
+        uint32_t frames;
+        Time latency_sum;
+        Time latency_min;
+        Time latency_max;
+    };
 
-    class OstNode : public Object
+    /**
+     * \ingroup ost
+     * OST node attached to a SpWDevice.
+     *
+     * The protocol is ost::Node from ost/core, this class only provides it
+     * with the ns-3 platform: HwTimer, Simulator events and the SpWDevice
+     * as the link.
+     *
+     * The attributes are the ost::SocketOptions of its sockets, the depth
+     * of the link and the timer tick. They stay within the capacities
+     * ost_config.h builds the engine for, so Config::SetDefault and
+     * CommandLine sweep them without a rebuild.
+     */
+    class OstNode : public Object, public ost::Node::Listener
     {
-        static const uint8_t PORTS_NUMBER = 3;
-        static const micros_t DURATION_RETRANSMISSON = 300000;
+        static const uint8_t PORTS_NUMBER = ost::Node::PORTS_NUMBER;
 
     public:
+        /**
+         * \brief Get the type ID.
+         * \return the object TypeId
+         */
+        static TypeId GetTypeId();
+
         int8_t start(uint8_t hw_timer_id);
+
+        /**
+         * Start the node with a new socket open to address and reset the
+         * link. start(hw_timer_id) opens it to 1 - hw_timer_id.
+         */
+        int8_t start_connection(uint8_t address);
         void shutdown();
         int8_t open_connection(uint8_t address);
         int8_t close_connection(uint8_t address);
-        int8_t event_handler(const TransportLayerEvent e);
         int8_t send_packet(uint8_t address, const uint8_t *buffer, uint32_t size);
 
         /*
         *  NS-3 Specific
         */
         OstNode(Ptr<SpWDevice>, int8_t mode);
+
+        /**
+         * The window used to be ignored here, it now sets the Window
+         * attribute.
+         */
+        NS_DEPRECATED("set the Window attribute instead")
         OstNode(Ptr<SpWDevice>, int8_t mode, uint16_t window_sz);
         ~OstNode();
 
+        /**
+         * Settings of the sockets, the ones open already take them as
+         * well. The attributes change one setting at a time.
+         */
+        void SetSocketOptions(const ost::SocketOptions &options);
+        const ost::SocketOptions &GetSocketOptions() const;
+
         int8_t GetSocket(uint8_t address, Ptr<OstSocket> &socket);
         int8_t AggregateSocket(uint8_t address);
         int8_t DeleteSocket(uint8_t address);
         Ptr<SpWDevice> GetSpWLayer();
+        ost::TimerService &GetTimerService() const;
         uint8_t GetAddress() const;
         typedef Callback<void, uint8_t, Ptr<Packet>> ReceiveCallback;
         void SetReceiveCallback(OstNode::ReceiveCallback cb);
 
+        /**
+         * Emulate the node timer with a periodic tick interrupt
+         * (see HwTimer::TICK_DRIVEN). Takes effect on the next start().
+         *
+         * \param itperiod value of the ITPERIOD register, 0 returns to one-shot timers
+         * \param itscale value of the ITSCALE register
+         */
+        void SetHwTimerTick(uint32_t itperiod, uint8_t itscale);
+        bool GetHwTimerTick(uint32_t &itperiod, uint8_t &itscale) const;
+
+        /**
+         * \return counters of the node hardware timer
+         */
+        HwTimerStats GetTimerStats() const;
+
+        /**
+         * Let the frames for address go out only in a time slot: while the
+         * last time-code received by the SpWDevice is slot, see
+         * SpWTimeCodeGenerator. A destination may have several slots, one
+         * without slots is not restricted. ACKs for address wait for its
+         * slots as well.
+         *
+         * \param address the destination
+         * \param slot the time-code, 0 to 63
+         */
+        void AssignSlot(uint8_t address, uint8_t slot);
+
+        /**
+         * Frames must be off the link before their slot ends, 0 lets them
+         * start at any time of the slot.
+         *
+         * \param duration the time between time-codes
+         */
+        void SetSlotDuration(Time duration);
+
+        /**
+         * \return frames waiting for their slot
+         */
+        uint32_t GetHeldFrames() const;
+
+        /**
+         * \param address the sending node
+         * \return latency of the data frames received from it
+         */
+        OstFlowStats GetFlowStats(uint8_t address) const;
+
+        void segment_received(uint8_t src_addr, uint8_t port, const uint8_t *payload, uint16_t len) override;
+
     private:
 
         uint8_t self_address;
-        std::vector<OstSocket*> ports;
+        std::vector<Ptr<OstSocket>> ports;
         Ptr<SpWDevice> spw_layer;
-        Ptr<Packet> that_arrived;
+        Ptr<HwTimer> hw_timer;
+        Ns3EventQueue events;
+        SpWLinkDriver link;
+        ost::NodeBufferPool buffers;
+        ost::Node *core;
+        bool link_reset; // down since the last LinkReady
 
         /*
         *  NS-3 Specific
         */
-        uint16_t WINDOW_SZ;
+        uint32_t tick_itperiod;
+        uint8_t tick_itscale;
         ReceiveCallback rx_cb;
+        void Init();
+        void SetWindow(uint16_t window);
+        uint16_t GetWindow() const;
+        void SetTransmitFifoSize(uint16_t size);
+        uint16_t GetTransmitFifoSize() const;
+        void SetMtu(uint32_t mtu);
+        uint32_t GetMtu() const;
+        void SetInitialRto(Time rto);
+        Time GetInitialRto() const;
+        void SetMinRto(Time rto);
+        Time GetMinRto() const;
+        void SetMaxRto(Time rto);
+        Time GetMaxRto() const;
+        void SetAckPolicy(ost::AckPolicy policy);
+        ost::AckPolicy GetAckPolicy() const;
+        void SetAckDelay(Time delay);
+        Time GetAckDelay() const;
+        void SetLinkDepth(uint8_t depth);
+        uint8_t GetLinkDepth() const;
         bool NetworkLayerReceive(Ptr<NetDevice> dev,
                                    Ptr<const Packet> pkt,
                                    uint16_t mode,
                                    const Address &sender);
+        void ReceiveFrame(Ptr<Packet> pkt);
         std::string GetSegmentTypeName(SegmentFlag t);
-        std::string GetTransportEventName(TransportLayerEvent e);
         void SpwReadyHandler();
+        void LinkReady();
+        void SpwPacketLostHandler(Ptr<const Packet> pkt);
+        void FrameLost(Ptr<Packet> pkt);
+        void ReportFrameLost(uint8_t peer_address, Ptr<const Packet> pkt);
+        void SpwLinkChangeHandler();
+        void LinkDown();
+        void SpwPacketSentHandler(Ptr<const Packet> pkt);
+        void FrameSent(uint8_t peer_address, std::vector<uint8_t> header, uint16_t len);
+        uint8_t GetPeerAddress(Ptr<const Packet> pkt) const;
+        void SpwCongestionHandler(Ptr<const Packet> pkt, bool dropped);
+        void Congestion(Ptr<Packet> pkt, bool dropped);
+        void SpwTimeCodeHandler(Ptr<SpWDevice> dev, uint8_t time_code);
+        void SlotStart(uint8_t time_code);
+
+        std::map<uint8_t, OstFlowStats> flows;
     };
 } // namespace ns3
 
-#endif
\ No newline at end of file
+#endif
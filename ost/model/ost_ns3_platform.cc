@@ -0,0 +1,184 @@
+#include "ost_ns3_platform.h"
+
+#include "ns3/abort.h"
+#include "ns3/mac8-address.h"
+#include "ns3/ost-header.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+    Ns3EventQueue::~Ns3EventQueue()
+    {
+        for (auto &p : pending)
+            Simulator::Cancel(p.second);
+    }
+
+    uint64_t
+    Ns3EventQueue::now_us() const
+    {
+        return Simulator::Now().GetMicroSeconds();
+    }
+
+    void
+    Ns3EventQueue::post(ost::Task &task, micros_t delay)
+    {
+        EventId &e_id = pending[&task];
+        Simulator::Cancel(e_id);
+        e_id = Simulator::Schedule(MicroSeconds(delay), &Ns3EventQueue::Run, &task);
+    }
+
+    void
+    Ns3EventQueue::cancel(ost::Task &task)
+    {
+        auto it = pending.find(&task);
+        if (it == pending.end())
+            return;
+        Simulator::Cancel(it->second);
+        pending.erase(it);
+    }
+
+    void
+    Ns3EventQueue::Run(ost::Task *task)
+    {
+        task->run();
+    }
+
+    SpWLinkDriver::SpWLinkDriver(Ptr<SpWDevice> dev)
+        : spw_layer(dev),
+          slot_started(false),
+          slot(0)
+    {
+    }
+
+    bool
+    SpWLinkDriver::is_ready() const
+    {
+        return spw_layer->IsReadyToTransmit();
+    }
+
+    bool
+    SpWLinkDriver::transmit(uint8_t dst_addr, const uint8_t *frame, uint16_t len)
+    {
+        Ptr<Packet> p = Create<Packet>(frame, len);
+        p->AddPacketTag(OstTimestampTag(Simulator::Now()));
+        if (slots.find(dst_addr) == slots.end())
+            return Send(dst_addr, p);
+
+        // behind the frames already waiting for the destination
+        for (auto &h : held)
+        {
+            if (h.first == dst_addr)
+            {
+                held.emplace_back(dst_addr, p);
+                return true;
+            }
+        }
+        if (TakeSlot(dst_addr, p))
+            return Send(dst_addr, p);
+        held.emplace_back(dst_addr, p);
+        return true;
+    }
+
+    void
+    SpWLinkDriver::AssignSlot(uint8_t dst_addr, uint8_t slot)
+    {
+        NS_ABORT_MSG_IF(slot >= 64, "time slot " << +slot << " is not a time-code");
+        slots[dst_addr] |= uint64_t(1) << slot;
+    }
+
+    void
+    SpWLinkDriver::SetSlotDuration(Time duration)
+    {
+        slot_duration = duration;
+    }
+
+    void
+    SpWLinkDriver::SlotStart(uint8_t s)
+    {
+        slot_started = true;
+        slot = s;
+        slot_end = Simulator::Now() + slot_duration;
+        slot_free = Simulator::Now();
+
+        // a destination that has to wait keeps its later frames waiting too
+        uint64_t waiting[4] = {0, 0, 0, 0};
+        for (auto it = held.begin(); it != held.end();)
+        {
+            uint8_t dst = it->first;
+            if (!(waiting[dst / 64] & (uint64_t(1) << dst % 64)) && TakeSlot(dst, it->second))
+            {
+                Ptr<Packet> p = it->second;
+                it = held.erase(it);
+                if (!Send(dst, p) && !lost_cb.IsNull())
+                    lost_cb(dst, p);
+            }
+            else
+            {
+                waiting[dst / 64] |= uint64_t(1) << dst % 64;
+                ++it;
+            }
+        }
+    }
+
+    uint32_t
+    SpWLinkDriver::GetHeldFrames() const
+    {
+        return held.size();
+    }
+
+    uint16_t
+    SpWLinkDriver::frames_held() const
+    {
+        return held.size() < 0xffff ? held.size() : 0xffff;
+    }
+
+    void
+    SpWLinkDriver::SetLostCallback(LostCallback cb)
+    {
+        lost_cb = cb;
+    }
+
+    void
+    SpWLinkDriver::DropHeldFrames()
+    {
+        std::deque<std::pair<uint8_t, Ptr<Packet>>> dropped;
+        dropped.swap(held);
+        if (lost_cb.IsNull())
+            return;
+        for (auto &h : dropped)
+            lost_cb(h.first, h.second);
+    }
+
+    bool
+    SpWLinkDriver::TakeSlot(uint8_t dst_addr, Ptr<const Packet> p)
+    {
+        if (!slot_started || !(slots[dst_addr] & (uint64_t(1) << slot)))
+            return false;
+        if (slot_duration.IsZero())
+            return true;
+        Time start = Max(slot_free, Simulator::Now());
+        Time end = start + spw_layer->GetLineTime(p->GetSize());
+        if (end > slot_end)
+            return false;
+        slot_free = end;
+        return true;
+    }
+
+    bool
+    SpWLinkDriver::Send(uint8_t dst_addr, Ptr<Packet> p)
+    {
+        Mac8Address addr;
+        addr.CopyFrom(&dst_addr);
+        return spw_layer->Send(p, addr, 0);
+    }
+
+    bool
+    SpWLinkDriver::reports_sent() const
+    {
+        // OstNode forwards the packet sent callback of the device
+        return true;
+    }
+
+} // namespace ns3
@@ -0,0 +1,120 @@
+#ifndef OST_NS3_PLATFORM_H
+#define OST_NS3_PLATFORM_H
+
+#include "ns3/callback.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/ost_platform.h"
+#include "ns3/ptr.h"
+#include "ns3/spw-device.h"
+
+#include <deque>
+#include <map>
+
+namespace ns3
+{
+
+    /**
+     * \ingroup ost
+     * ost::Clock and ost::EventQueue on top of the Simulator.
+     */
+    class Ns3EventQueue : public ost::Clock, public ost::EventQueue
+    {
+    public:
+        ~Ns3EventQueue();
+
+        uint64_t now_us() const override;
+        void post(ost::Task &task, micros_t delay) override;
+        void cancel(ost::Task &task) override;
+
+    private:
+        static void Run(ost::Task *task);
+
+        std::map<ost::Task *, EventId> pending;
+    };
+
+    /**
+     * \ingroup ost
+     * ost::LinkDriver on top of a SpWDevice.
+     *
+     * Frames carry an OstTimestampTag with the time they were handed to
+     * the link. Frames for a destination with time slots assigned are held
+     * until a time-code starts one of its slots, in order, and go out
+     * while the slot lasts; with a slot duration set a frame goes out only
+     * if its line time fits in what is left of the slot. Destinations
+     * without slots are not restricted. Held frames that are dropped, or
+     * refused by the device when their slot comes, are reported to the
+     * lost callback.
+     */
+    class SpWLinkDriver : public ost::LinkDriver
+    {
+    public:
+        /**
+         * Gets the destination and the frame.
+         */
+        typedef Callback<void, uint8_t, Ptr<const Packet>> LostCallback;
+
+        SpWLinkDriver(Ptr<SpWDevice> dev);
+
+        bool is_ready() const override;
+        bool transmit(uint8_t dst_addr, const uint8_t *frame, uint16_t len) override;
+        bool reports_sent() const override;
+        uint16_t frames_held() const override;
+
+        /**
+         * \param cb called for every frame taken by transmit() that never
+         * reaches the device
+         */
+        void SetLostCallback(LostCallback cb);
+
+        /**
+         * \param dst_addr the destination
+         * \param slot a time-code in which its frames may go out, 0 to 63
+         */
+        void AssignSlot(uint8_t dst_addr, uint8_t slot);
+
+        /**
+         * \param duration length of a slot, 0 lets a frame start at any
+         * time of its slot
+         */
+        void SetSlotDuration(Time duration);
+
+        /**
+         * A time-code has started a slot.
+         *
+         * \param slot the time-code
+         */
+        void SlotStart(uint8_t slot);
+
+        /**
+         * \return frames waiting for a slot
+         */
+        uint32_t GetHeldFrames() const;
+
+        /**
+         * Drop the frames waiting for a slot, the link is being reset.
+         */
+        void DropHeldFrames();
+
+    private:
+        /**
+         * \return true if the frame for dst_addr may go out now, it then
+         * takes its line time from the slot
+         */
+        bool TakeSlot(uint8_t dst_addr, Ptr<const Packet> p);
+        bool Send(uint8_t dst_addr, Ptr<Packet> p);
+
+        Ptr<SpWDevice> spw_layer;
+        LostCallback lost_cb;
+        std::map<uint8_t, uint64_t> slots;                 // bit per time-code, by destination
+        std::deque<std::pair<uint8_t, Ptr<Packet>>> held; // frames waiting for a slot
+        bool slot_started;                                 // a time-code has been received
+        uint8_t slot;                                      // the current slot
+        Time slot_duration;
+        Time slot_end;  // with slot_duration
+        Time slot_free; // end of the frames sent in the slot
+    };
+
+} // namespace ns3
+
+#endif
@@ -280,11 +280,10 @@ void OstCompareTestCase::DoRun()
     em->SetUnit(RateErrorModel::ERROR_UNIT_PACKET);
     file = "/home/danandla/BOTAY/space/develop/NS3OST/payloads/255kb";
     em->SetRate(0.8);
-    uint16_t window = 2;
 
-    userA = CreateObject<OstUser>(CreateObject<OstNode>(devA, 0, window), "A");
+    userA = CreateObject<OstUser>(CreateObject<OstNode>(devA, 0), "A");
     userA->GetOst()->SetReceiveCallback(MakeCallback(&OstUser::Receive, userA));
-    userB = CreateObject<OstUser>(CreateObject<OstNode>(devB, 0, window), "B");
+    userB = CreateObject<OstUser>(CreateObject<OstNode>(devB, 0), "B");
     userB->GetOst()->SetReceiveCallback(MakeCallback(&OstUser::Receive, userB));
 
     userA->GetOst()->GetSpWLayer()->SetCharacterParityErrorModel(em);
@@ -0,0 +1,661 @@
+#include "ns3/hw_timer.h"
+#include "ns3/log.h"
+#include "ns3/ost_core_node.h"
+#include "ns3/ost_ns3_platform.h"
+#include "ns3/simulator.h"
+#include "ns3/sliding_window.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <string.h>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("OstCoreTest");
+
+namespace
+{
+
+/**
+ * \ingroup ost-tests
+ * Link between two ost::Node that delivers frames after a fixed delay
+ * and drops every loss_period-th of them. With report set, the sender
+ * learns about every drop as if the link had been reset and comes back
+ * ready shortly after. While down is set the link is not ready and
+ * counts the frames it is still given. Every mark_period-th data frame
+ * is delivered and reported to the sender as congested a little later.
+ * With paced set the link sends one frame every 20 us and reports each
+ * departure.
+ */
+class TestLink : public ost::LinkDriver
+{
+  public:
+    TestLink(uint32_t loss, bool report)
+        : peer(nullptr),
+          self(nullptr),
+          loss_period(loss),
+          report(report),
+          down(false),
+          mark_period(0),
+          data_frames(0),
+          paced(false),
+          in_link(0),
+          max_in_link(0),
+          frames(0),
+          dropped(0),
+          down_frames(0)
+    {
+    }
+
+    bool is_ready() const override
+    {
+        return !down;
+    }
+
+    bool reports_sent() const override
+    {
+        return paced;
+    }
+
+    bool transmit(uint8_t dst_addr, const uint8_t *frame, uint16_t len) override
+    {
+        if (down)
+        {
+            down_frames++;
+            return false;
+        }
+        frames++;
+        if (loss_period && frames % loss_period == 0)
+        {
+            dropped++;
+            if (report)
+            {
+                Simulator::ScheduleNow(&TestLink::Lost, self, dst_addr, std::vector<uint8_t>(frame, frame + len));
+                Simulator::Schedule(MicroSeconds(20), &ost::Node::link_ready, self);
+            }
+            return true;
+        }
+        if (mark_period && (frame[0] & 1) == 0 && ++data_frames % mark_period == 0)
+        {
+            // as if marked when leaving a queue behind the next frames
+            Simulator::Schedule(MicroSeconds(40), &TestLink::Marked, self, dst_addr, std::vector<uint8_t>(frame, frame + len));
+        }
+        Time sent;
+        if (paced)
+        {
+            busy_until = Max(Simulator::Now(), busy_until) + MicroSeconds(20);
+            sent = busy_until - Simulator::Now();
+            in_link++;
+            max_in_link = std::max(max_in_link, in_link);
+            Simulator::Schedule(sent, &TestLink::Sent, this, dst_addr, std::vector<uint8_t>(frame, frame + len));
+        }
+        Simulator::Schedule(sent + MicroSeconds(50), &TestLink::Deliver, peer, std::vector<uint8_t>(frame, frame + len));
+        return true;
+    }
+
+    void Sent(uint8_t dst_addr, std::vector<uint8_t> frame)
+    {
+        in_link--;
+        self->frame_sent(dst_addr, frame.data(), frame.size());
+    }
+
+    static void Deliver(ost::Node *node, std::vector<uint8_t> frame)
+    {
+        node->receive_frame(frame.data(), frame.size());
+    }
+
+    static void Lost(ost::Node *node, uint8_t dst_addr, std::vector<uint8_t> frame)
+    {
+        node->frame_lost(dst_addr, frame.data(), frame.size());
+    }
+
+    static void Marked(ost::Node *node, uint8_t dst_addr, std::vector<uint8_t> frame)
+    {
+        node->congestion(dst_addr, frame.data(), frame.size());
+    }
+
+    ost::Node *peer;
+    ost::Node *self;
+    uint32_t loss_period;
+    bool report;
+    bool down;
+    uint32_t mark_period;
+    uint32_t data_frames;
+    bool paced;
+    Time busy_until;
+    uint32_t in_link;
+    uint32_t max_in_link;
+    uint32_t frames;
+    uint32_t dropped;
+    uint32_t down_frames;
+};
+
+} // namespace
+
+/**
+ * \ingroup ost-tests
+ * Runs ost::Node over the ns-3 platform and checks that a stream longer
+ * than the sequence space arrives complete and in order, and that
+ * congestion marks shrink the congestion window without costing a
+ * retransmission and that a link reporting departures is kept only one
+ * frame ahead.
+ */
+class OstCoreTestCase : public TestCase, public ost::Node::Listener
+{
+  public:
+    OstCoreTestCase(uint32_t loss_period, bool report = false, uint32_t mark_period = 0, bool paced = false);
+    void DoRun() override;
+    void segment_received(uint8_t src_addr, uint8_t port, const uint8_t *payload, uint16_t len) override;
+
+  private:
+    void Run();
+    void Send();
+
+    static const uint32_t SEGMENTS = 600;
+
+    uint32_t m_loss;
+    bool m_report;
+    uint32_t m_mark;
+    bool m_paced;
+    uint16_t m_minWindow;
+    ost::Node *m_sender;
+    uint32_t m_sent;
+    std::vector<uint32_t> m_received;
+    Time m_lastReceived;
+};
+
+OstCoreTestCase::OstCoreTestCase(uint32_t loss_period, bool report, uint32_t mark_period, bool paced)
+    : TestCase(report        ? "ost::Node stream with reported loss"
+               : loss_period ? "ost::Node stream with loss"
+               : mark_period ? "ost::Node stream with congestion marks"
+               : paced       ? "ost::Node stream over a link reporting departures"
+                             : "ost::Node stream"),
+      m_loss(loss_period),
+      m_report(report),
+      m_mark(mark_period),
+      m_paced(paced),
+      m_minWindow(ost::Socket::WINDOW_SZ),
+      m_sender(nullptr),
+      m_sent(0)
+{
+}
+
+void
+OstCoreTestCase::segment_received(uint8_t src_addr, uint8_t port, const uint8_t *payload, uint16_t len)
+{
+    NS_TEST_EXPECT_MSG_EQ(+src_addr, 0, "source address");
+    NS_TEST_EXPECT_MSG_EQ(len, 100, "payload length");
+    uint32_t n;
+    memcpy(&n, payload, sizeof(n));
+    m_received.push_back(n);
+    m_lastReceived = Simulator::Now();
+    ost::Socket *sk;
+    if (m_sender->get_socket(1, sk) == 1)
+        m_minWindow = std::min(m_minWindow, sk->get_congestion_window());
+}
+
+void
+OstCoreTestCase::Send()
+{
+    uint8_t payload[100] = {0};
+    while (m_sent < SEGMENTS)
+    {
+        memcpy(payload, &m_sent, sizeof(m_sent));
+        if (m_sender->send_packet(1, payload, sizeof(payload)) < 0)
+            break;
+        m_sent++;
+    }
+    if (m_sent < SEGMENTS)
+        Simulator::Schedule(MilliSeconds(1), &OstCoreTestCase::Send, this);
+}
+
+void
+OstCoreTestCase::DoRun()
+{
+    Run();
+    // the engine and its platform are gone, nothing is left to cancel
+    Simulator::Destroy();
+}
+
+void
+OstCoreTestCase::Run()
+{
+    Ns3EventQueue events;
+    Ptr<HwTimer> timerA = Create<HwTimer>();
+    Ptr<HwTimer> timerB = Create<HwTimer>();
+    timerA->init();
+    timerB->init();
+    TestLink linkA(m_loss, m_report), linkB(m_loss, m_report);
+    ost::HeapBufferPool buffersA, buffersB;
+
+    ost::Node a(0, ost::Platform{&events, &events, PeekPointer(timerA), &linkA, &buffersA});
+    ost::Node b(1, ost::Platform{&events, &events, PeekPointer(timerB), &linkB, &buffersB});
+    linkA.peer = &b;
+    linkB.peer = &a;
+    linkA.self = &a;
+    linkB.self = &b;
+    linkA.mark_period = m_mark;
+    linkA.paced = m_paced;
+    linkB.paced = m_paced;
+    b.set_listener(this);
+    m_sender = &a;
+
+    NS_TEST_ASSERT_MSG_EQ(a.start(), 0, "start");
+    NS_TEST_ASSERT_MSG_EQ(b.start(), 0, "start");
+    uint8_t payload[100] = {0};
+    NS_TEST_EXPECT_MSG_EQ(a.send_packet(1, payload, sizeof(payload)), -1, "send before open");
+    NS_TEST_ASSERT_MSG_EQ(a.open_connection(1), 1, "open");
+    NS_TEST_ASSERT_MSG_EQ(b.open_connection(0), 1, "open");
+    std::vector<uint8_t> big(ost::Socket::MAX_PAYLOAD + 1);
+    NS_TEST_EXPECT_MSG_EQ(a.send_packet(1, big.data(), big.size()), -2, "too long message");
+
+    Simulator::Schedule(MicroSeconds(0), &OstCoreTestCase::Send, this);
+    Simulator::Stop(Seconds(600));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_received.size(), SEGMENTS, "every segment delivered once");
+    for (uint32_t i = 0; i < SEGMENTS; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_received[i], i, "delivered in order");
+    }
+
+    ost::Socket *sk;
+    NS_TEST_ASSERT_MSG_EQ(a.get_socket(1, sk), 1, "socket of the connection");
+    const ost::SocketStats &st = sk->get_stats();
+    NS_TEST_EXPECT_MSG_EQ(st.segments_sent, SEGMENTS, "segments sent");
+    NS_TEST_EXPECT_MSG_EQ(st.acks_received, SEGMENTS, "segments acknowledged");
+    NS_TEST_EXPECT_MSG_EQ(sk->get_segments_in_flight(), 0, "window drained");
+    if (m_report)
+    {
+        NS_TEST_EXPECT_MSG_GT(st.frames_lost, 0, "losses reported");
+        NS_TEST_EXPECT_MSG_GT(st.retransmissions, 0, "lost segments retransmitted");
+        // nothing waits for a retransmission timer
+        NS_TEST_EXPECT_MSG_LT(m_lastReceived, MicroSeconds(ost::Socket::DURATION_RETRANSMISSON),
+                              "lost segments sent again at once");
+    }
+    else if (m_loss)
+    {
+        NS_TEST_EXPECT_MSG_GT(st.retransmissions, 0, "lost segments retransmitted");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(st.retransmissions, 0, "no retransmissions without loss");
+    }
+    if (m_mark)
+    {
+        NS_TEST_EXPECT_MSG_EQ(st.congestion_signals, SEGMENTS / m_mark, "every mark reported");
+        NS_TEST_EXPECT_MSG_GT(st.window_reductions, 0, "window reduced");
+        NS_TEST_EXPECT_MSG_LT(st.window_reductions, st.congestion_signals, "one reduction per window");
+        NS_TEST_EXPECT_MSG_LT(m_minWindow, ost::Socket::WINDOW_SZ, "fewer segments in flight");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(st.congestion_signals, 0, "no congestion signals");
+    }
+    if (m_paced)
+    {
+        NS_TEST_EXPECT_MSG_EQ(linkA.max_in_link, ost::Node::LINK_DEPTH, "one frame queued behind the one on the wire");
+        NS_TEST_EXPECT_MSG_LT(linkB.max_in_link, ost::Node::LINK_DEPTH + 1, "ACKs not piled up");
+    }
+    NS_TEST_EXPECT_MSG_EQ(a.get_timer_service().get_number_of_timers(), 0, "no timers left");
+    NS_TEST_EXPECT_MSG_EQ(buffersA.get_in_use(), 0, "sender buffers released");
+    NS_TEST_EXPECT_MSG_EQ(buffersB.get_in_use(), 0, "receiver buffers released");
+}
+
+/**
+ * \ingroup ost-tests
+ * Streams with SocketOptions other than the defaults: a smaller window,
+ * transmit fifo and MTU and a bounded RTO on the sender, delayed ACKs on
+ * the receiver, set once its socket is open.
+ */
+class OstSocketOptionsTestCase : public TestCase, public ost::Node::Listener
+{
+  public:
+    OstSocketOptionsTestCase();
+    void DoRun() override;
+    void segment_received(uint8_t src_addr, uint8_t port, const uint8_t *payload, uint16_t len) override;
+
+  private:
+    void Run();
+    void Send();
+
+    static const uint32_t SEGMENTS = 40;
+    static const uint16_t WINDOW = 3;
+    static const uint16_t FIFO = 5;
+    static const micros_t ACK_DELAY = 300;
+
+    ost::Socket *m_socket;
+    uint32_t m_sent;
+    uint32_t m_full;
+    uint16_t m_maxInFlight;
+    std::vector<uint32_t> m_received;
+};
+
+OstSocketOptionsTestCase::OstSocketOptionsTestCase()
+    : TestCase("ost::Node stream with socket options"),
+      m_socket(nullptr),
+      m_sent(0),
+      m_full(0),
+      m_maxInFlight(0)
+{
+}
+
+void
+OstSocketOptionsTestCase::segment_received(uint8_t src_addr, uint8_t port, const uint8_t *payload, uint16_t len)
+{
+    uint32_t n;
+    memcpy(&n, payload, sizeof(n));
+    m_received.push_back(n);
+    m_maxInFlight = std::max(m_maxInFlight, m_socket->get_segments_in_flight());
+}
+
+void
+OstSocketOptionsTestCase::Send()
+{
+    uint8_t payload[50] = {0};
+    while (m_sent < SEGMENTS)
+    {
+        memcpy(payload, &m_sent, sizeof(m_sent));
+        int8_t r = m_socket->send(payload, sizeof(payload));
+        if (r == -3)
+            m_full++;
+        if (r < 0)
+            break;
+        m_sent++;
+    }
+    if (m_sent < SEGMENTS)
+        Simulator::Schedule(MilliSeconds(1), &OstSocketOptionsTestCase::Send, this);
+}
+
+void
+OstSocketOptionsTestCase::DoRun()
+{
+    Run();
+    Simulator::Destroy();
+}
+
+void
+OstSocketOptionsTestCase::Run()
+{
+    Ns3EventQueue events;
+    Ptr<HwTimer> timerA = Create<HwTimer>();
+    Ptr<HwTimer> timerB = Create<HwTimer>();
+    timerA->init();
+    timerB->init();
+    TestLink linkA(0, false), linkB(0, false);
+    ost::HeapBufferPool buffersA, buffersB;
+
+    ost::Node a(0, ost::Platform{&events, &events, PeekPointer(timerA), &linkA, &buffersA});
+    ost::Node b(1, ost::Platform{&events, &events, PeekPointer(timerB), &linkB, &buffersB});
+    linkA.peer = &b;
+    linkB.peer = &a;
+    linkA.self = &a;
+    linkB.self = &b;
+    b.set_listener(this);
+
+    ost::SocketOptions o = ost::Socket::default_options();
+    NS_TEST_EXPECT_MSG_EQ(o.window, ost::Socket::WINDOW_SZ, "full window by default");
+    NS_TEST_EXPECT_MSG_EQ(o.rto_min, o.rto_max, "fixed timeout by default");
+    o.window = 0;
+    int8_t r = a.set_socket_options(o);
+    NS_TEST_EXPECT_MSG_EQ(r, -1, "empty window");
+    o.window = ost::Socket::WINDOW_SZ + 1;
+    r = a.set_socket_options(o);
+    NS_TEST_EXPECT_MSG_EQ(r, -1, "window over the capacity");
+    r = a.set_link_depth(0);
+    NS_TEST_EXPECT_MSG_EQ(r, -1, "empty link");
+
+    o.window = WINDOW;
+    o.transmit_fifo_sz = FIFO;
+    o.mtu = ost::SegmentHeader::SIZE + 50;
+    o.rto_initial = 20000;
+    o.rto_min = 1000;
+    o.rto_max = 50000;
+    r = a.set_socket_options(o);
+    NS_TEST_ASSERT_MSG_EQ(r, 1, "sender options");
+
+    NS_TEST_ASSERT_MSG_EQ(a.start(), 0, "start");
+    NS_TEST_ASSERT_MSG_EQ(b.start(), 0, "start");
+    NS_TEST_ASSERT_MSG_EQ(a.open_connection(1), 1, "open");
+    NS_TEST_ASSERT_MSG_EQ(b.open_connection(0), 1, "open");
+    NS_TEST_ASSERT_MSG_EQ(a.get_socket(1, m_socket), 1, "socket of the connection");
+    NS_TEST_EXPECT_MSG_EQ(m_socket->get_congestion_window(), WINDOW, "window of the options");
+    NS_TEST_EXPECT_MSG_EQ(m_socket->get_retransmission_timeout(), 20000, "initial timeout");
+    uint8_t big[51] = {0};
+    r = m_socket->send(big, sizeof(big));
+    NS_TEST_EXPECT_MSG_EQ(r, -2, "message over the MTU");
+
+    ost::SocketOptions delayed = b.get_socket_options();
+    delayed.ack_policy = ost::ACK_DELAYED;
+    delayed.ack_delay = ACK_DELAY;
+    r = b.set_socket_options(delayed);
+    NS_TEST_ASSERT_MSG_EQ(r, 1, "receiver options");
+    ost::Socket *receiver;
+    NS_TEST_ASSERT_MSG_EQ(b.get_socket(0, receiver), 1, "socket of the receiver");
+    NS_TEST_EXPECT_MSG_EQ(receiver->get_options().ack_policy, ost::ACK_DELAYED, "open socket takes the options");
+
+    Simulator::Schedule(MicroSeconds(0), &OstSocketOptionsTestCase::Send, this);
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_received.size(), SEGMENTS, "every segment delivered once");
+    for (uint32_t i = 0; i < SEGMENTS; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_received[i], i, "delivered in order");
+    }
+    NS_TEST_EXPECT_MSG_GT(m_full, 0, "transmit fifo filled up");
+    NS_TEST_EXPECT_MSG_EQ(m_maxInFlight, WINDOW, "window filled and no more");
+
+    const ost::SocketStats &st = m_socket->get_stats();
+    NS_TEST_EXPECT_MSG_EQ(st.retransmissions, 0, "ACKs back before the timeout");
+    NS_TEST_EXPECT_MSG_EQ(linkB.frames, SEGMENTS, "an ACK for each segment");
+    NS_TEST_EXPECT_MSG_GT(st.rtt_sum_us / st.rtt_samples, ACK_DELAY, "ACKs held");
+    micros_t rto = m_socket->get_retransmission_timeout();
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(rto, 1000, "timeout from the round trip, at least the minimum");
+    NS_TEST_EXPECT_MSG_LT(rto, 20000, "timeout from the round trip, below the initial one");
+    NS_TEST_EXPECT_MSG_EQ(a.get_timer_service().get_number_of_timers(), 0, "no timers left");
+    NS_TEST_EXPECT_MSG_EQ(b.get_timer_service().get_number_of_timers(), 0, "no delayed ACK left");
+}
+
+/**
+ * \ingroup ost-tests
+ * Takes the link down in the middle of a stream for longer than the
+ * retransmission timeout and checks that nothing is handed to it, that no
+ * timer expires meanwhile and that the stream completes once it is back.
+ */
+class OstLinkDownTestCase : public TestCase, public ost::Node::Listener
+{
+  public:
+    OstLinkDownTestCase();
+    void DoRun() override;
+    void segment_received(uint8_t src_addr, uint8_t port, const uint8_t *payload, uint16_t len) override;
+
+  private:
+    void Run();
+    void SetLink(bool up);
+
+    static const uint32_t SEGMENTS = 50;
+
+    ost::Node *m_nodes[2];
+    TestLink *m_links[2];
+    std::vector<uint32_t> m_received;
+    uint32_t m_receivedBeforeUp;
+    Time m_lastReceived;
+};
+
+OstLinkDownTestCase::OstLinkDownTestCase()
+    : TestCase("ost::Node stream across a link outage"),
+      m_receivedBeforeUp(0)
+{
+}
+
+void
+OstLinkDownTestCase::segment_received(uint8_t src_addr, uint8_t port, const uint8_t *payload, uint16_t len)
+{
+    uint32_t n;
+    memcpy(&n, payload, sizeof(n));
+    m_received.push_back(n);
+    m_lastReceived = Simulator::Now();
+}
+
+void
+OstLinkDownTestCase::SetLink(bool up)
+{
+    for (uint8_t i = 0; i < 2; ++i)
+    {
+        m_links[i]->down = !up;
+    }
+    if (up)
+    {
+        m_receivedBeforeUp = m_received.size();
+    }
+    for (uint8_t i = 0; i < 2; ++i)
+    {
+        if (up)
+            m_nodes[i]->link_ready();
+        else
+            m_nodes[i]->link_down();
+    }
+}
+
+void
+OstLinkDownTestCase::DoRun()
+{
+    Run();
+    Simulator::Destroy();
+}
+
+void
+OstLinkDownTestCase::Run()
+{
+    Ns3EventQueue events;
+    Ptr<HwTimer> timerA = Create<HwTimer>();
+    Ptr<HwTimer> timerB = Create<HwTimer>();
+    timerA->init();
+    timerB->init();
+    TestLink linkA(0, false), linkB(0, false);
+    ost::HeapBufferPool buffersA, buffersB;
+
+    ost::Node a(0, ost::Platform{&events, &events, PeekPointer(timerA), &linkA, &buffersA});
+    ost::Node b(1, ost::Platform{&events, &events, PeekPointer(timerB), &linkB, &buffersB});
+    linkA.peer = &b;
+    linkB.peer = &a;
+    linkA.self = &a;
+    linkB.self = &b;
+    m_nodes[0] = &a;
+    m_nodes[1] = &b;
+    m_links[0] = &linkA;
+    m_links[1] = &linkB;
+    b.set_listener(this);
+
+    NS_TEST_ASSERT_MSG_EQ(a.start(), 0, "start");
+    NS_TEST_ASSERT_MSG_EQ(b.start(), 0, "start");
+    NS_TEST_ASSERT_MSG_EQ(a.open_connection(1), 1, "open");
+    NS_TEST_ASSERT_MSG_EQ(b.open_connection(0), 1, "open");
+    uint8_t payload[100] = {0};
+    for (uint32_t i = 0; i < SEGMENTS; ++i)
+    {
+        memcpy(payload, &i, sizeof(i));
+        NS_TEST_ASSERT_MSG_EQ(a.send_packet(1, payload, sizeof(payload)), 1, "queued");
+    }
+
+    Time up = MicroSeconds(3 * ost::Socket::DURATION_RETRANSMISSON);
+    Simulator::Schedule(MicroSeconds(200), &OstLinkDownTestCase::SetLink, this, false);
+    Simulator::Schedule(up, &OstLinkDownTestCase::SetLink, this, true);
+    Simulator::Stop(Seconds(60));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(linkA.down_frames + linkB.down_frames, 0, "nothing handed to a link that is down");
+    NS_TEST_EXPECT_MSG_LT(m_receivedBeforeUp, SEGMENTS, "outage in the middle of the stream");
+    NS_TEST_EXPECT_MSG_GT(m_lastReceived, up, "stream resumed when the link came back");
+    NS_TEST_ASSERT_MSG_EQ(m_received.size(), SEGMENTS, "every segment delivered once");
+    for (uint32_t i = 0; i < SEGMENTS; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_received[i], i, "delivered in order");
+    }
+
+    ost::Socket *sk;
+    NS_TEST_ASSERT_MSG_EQ(a.get_socket(1, sk), 1, "socket of the connection");
+    NS_TEST_EXPECT_MSG_EQ(sk->get_stats().retransmissions, 0, "no timer expired during the outage");
+    NS_TEST_EXPECT_MSG_EQ(sk->get_stats().acks_received, SEGMENTS, "segments acknowledged");
+    NS_TEST_EXPECT_MSG_EQ(a.get_timer_service().get_number_of_timers(), 0, "no timers left");
+    NS_TEST_EXPECT_MSG_EQ(buffersA.get_in_use(), 0, "sender buffers released");
+    NS_TEST_EXPECT_MSG_EQ(buffersB.get_in_use(), 0, "receiver buffers released");
+}
+
+/**
+ * \ingroup ost-tests
+ * Checks the window bitmaps over one and two machine words.
+ */
+class OstWindowBitmapTestCase : public TestCase
+{
+  public:
+    OstWindowBitmapTestCase();
+    void DoRun() override;
+};
+
+OstWindowBitmapTestCase::OstWindowBitmapTestCase()
+    : TestCase("ost::WindowBitmap")
+{
+}
+
+void
+OstWindowBitmapTestCase::DoRun()
+{
+    typedef ost::WindowBitmap<8> Small;
+    NS_TEST_EXPECT_MSG_EQ(Small::SLOTS, 8, "slots of a power of two window");
+    NS_TEST_EXPECT_MSG_EQ(Small::contains(250, 1), true, "window wraps around 255");
+    NS_TEST_EXPECT_MSG_EQ(Small::contains(250, 2), false, "end of the window");
+    NS_TEST_EXPECT_MSG_EQ(Small::contains(250, 249), false, "before the window");
+    NS_TEST_EXPECT_MSG_EQ(+Small::slot(250), 2, "slot of a sequence number");
+
+    Small small;
+    small.set(1);
+    small.set(2);
+    NS_TEST_EXPECT_MSG_EQ(small.advance(), 0, "bottom edge not acknowledged");
+    small.set(0);
+    NS_TEST_EXPECT_MSG_EQ(small.advance(), 3, "run at the bottom edge");
+    NS_TEST_EXPECT_MSG_EQ(small.test(0), false, "flags shifted with the window");
+
+    typedef ost::WindowBitmap<100> Large;
+    NS_TEST_EXPECT_MSG_EQ(Large::SLOTS, 128, "slots rounded up to a power of two");
+    Large large;
+    for (uint8_t i = 1; i < 90; ++i)
+    {
+        large.set(i);
+    }
+    large.set(95);
+    NS_TEST_EXPECT_MSG_EQ(large.advance(), 0, "bottom edge not acknowledged");
+    large.set(0);
+    NS_TEST_EXPECT_MSG_EQ(large.advance(), 90, "run across the word boundary");
+    NS_TEST_EXPECT_MSG_EQ(large.test(5), true, "flag moved down from the second word");
+    NS_TEST_EXPECT_MSG_EQ(large.test(4), false, "gap kept");
+    large.reset();
+    NS_TEST_EXPECT_MSG_EQ(large.test(5), false, "reset");
+}
+
+/**
+ * \ingroup ost-tests
+ * TestSuite for the portable protocol engine
+ */
+class OstCoreTestSuite : public TestSuite
+{
+  public:
+    OstCoreTestSuite();
+};
+
+OstCoreTestSuite::OstCoreTestSuite()
+    : TestSuite("ost-core", Type::UNIT)
+{
+    AddTestCase(new OstCoreTestCase(0), Duration::QUICK);
+    AddTestCase(new OstCoreTestCase(7), Duration::QUICK);
+    AddTestCase(new OstCoreTestCase(7, true), Duration::QUICK);
+    AddTestCase(new OstCoreTestCase(0, false, 2), Duration::QUICK);
+    AddTestCase(new OstCoreTestCase(0, false, 0, true), Duration::QUICK);
+    AddTestCase(new OstSocketOptionsTestCase(), Duration::QUICK);
+    AddTestCase(new OstLinkDownTestCase(), Duration::QUICK);
+    AddTestCase(new OstWindowBitmapTestCase(), Duration::QUICK);
+}
+
+static OstCoreTestSuite sOstCoreTestSuite;
@@ -0,0 +1,119 @@
+#include "ns3/log.h"
+#include "ns3/node-container.h"
+#include "ns3/ost-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/spw-helper.h"
+#include "ns3/test.h"
+
+#include <map>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("OstHelperTest");
+
+namespace
+{
+
+/**
+ * \ingroup ost-tests
+ * Links installed by SpWHelper between two NodeContainers, an OstNode on
+ * every device by OstHelper, and a message over each link.
+ */
+class OstHelperTestCase : public TestCase
+{
+  public:
+    OstHelperTestCase(uint32_t links);
+    void DoRun() override;
+
+  private:
+    void Receive(uint8_t address, Ptr<Packet> p);
+    void Send(Ptr<OstNode> node, uint8_t address);
+
+    uint32_t links;
+    std::map<uint8_t, uint32_t> received; //!< Messages by sending node
+};
+
+OstHelperTestCase::OstHelperTestCase(uint32_t links)
+    : TestCase("OST stack installed on " + std::to_string(links) + " links"),
+      links(links)
+{
+}
+
+void
+OstHelperTestCase::Receive(uint8_t address, Ptr<Packet> p)
+{
+    received[address]++;
+}
+
+void
+OstHelperTestCase::Send(Ptr<OstNode> node, uint8_t address)
+{
+    uint8_t buffer[100] = {0};
+    int8_t r = node->send_packet(address, buffer, sizeof(buffer));
+    NS_TEST_EXPECT_MSG_GT(r, 0, "message accepted");
+}
+
+void
+OstHelperTestCase::DoRun()
+{
+    NodeContainer a;
+    NodeContainer b;
+    a.Create(links);
+    b.Create(links);
+
+    SpWHelper spw;
+    spw.SetDeviceAttribute("DataRate", DataRateValue(DataRate("100Mbps")));
+    NetDeviceContainer devices = spw.Install(a, b);
+    NS_TEST_ASSERT_MSG_EQ(devices.GetN(), 2 * links, "a device at each end");
+
+    OstHelper ost;
+    ost.SetWindow(4);
+    ost.SetReceiveCallback(MakeCallback(&OstHelperTestCase::Receive, this));
+    std::vector<Ptr<OstNode>> nodes = ost.Install(devices);
+    NS_TEST_ASSERT_MSG_EQ(nodes.size(), 2 * links, "a node per device");
+
+    ost.Start(nodes, MilliSeconds(1));
+    for (uint32_t i = 0; i < links; ++i)
+    {
+        Ptr<SpWDevice> from = DynamicCast<SpWDevice>(devices.Get(2 * i));
+        Ptr<SpWDevice> to = DynamicCast<SpWDevice>(devices.Get(2 * i + 1));
+        NS_TEST_EXPECT_MSG_EQ(from->GetSpWChannel(), to->GetSpWChannel(), "linked pairwise");
+        NS_TEST_EXPECT_MSG_EQ(from->GetNode(), a.Get(i), "device on the first node");
+        NS_TEST_EXPECT_MSG_EQ(to->GetNode(), b.Get(i), "device on the second node");
+
+        Ptr<OstNode> sender = nodes[2 * i];
+        Ptr<OstNode> receiver = nodes[2 * i + 1];
+        Simulator::Schedule(MilliSeconds(2), &OstHelperTestCase::Send, this, sender, receiver->GetAddress());
+    }
+    Simulator::Stop(Seconds(3));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(received.size(), links, "every sender heard from");
+    for (auto &r : received)
+    {
+        NS_TEST_EXPECT_MSG_EQ(r.second, 1, "one message from " << +r.first);
+    }
+
+    Simulator::Destroy();
+}
+
+} // namespace
+
+/**
+ * \ingroup ost-tests
+ * TestSuite for OstHelper and SpWHelper
+ */
+class OstHelperTestSuite : public TestSuite
+{
+  public:
+    OstHelperTestSuite();
+};
+
+OstHelperTestSuite::OstHelperTestSuite()
+    : TestSuite("ost-helper", Type::UNIT)
+{
+    AddTestCase(new OstHelperTestCase(100), Duration::QUICK);
+}
+
+static OstHelperTestSuite sOstHelperTestSuite;
@@ -0,0 +1,276 @@
+#include "ns3/drop-tail-queue.h"
+#include "ns3/log.h"
+#include "ns3/ost-header.h"
+#include "ns3/ost_node.h"
+#include "ns3/ost_socket.h"
+#include "ns3/simulator.h"
+#include "ns3/spw-channel.h"
+#include "ns3/spw-device.h"
+#include "ns3/spw-time-code-generator.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("OstSlotTest");
+
+namespace
+{
+
+/**
+ * \ingroup ost-tests
+ * Two OstNode on a link with a time master at the first one. The data
+ * frames may only go out in slot 5, the ACKs in slot 6: every data frame
+ * must arrive within slot 5 and the latency of the flow is reported.
+ */
+class OstSlotTestCase : public TestCase
+{
+  public:
+    OstSlotTestCase();
+    void DoRun() override;
+
+  private:
+    void Send(Ptr<OstNode> node, uint8_t address, uint32_t size);
+    void Receive(uint8_t address, Ptr<Packet> p);
+    void PhyRxEnd(Ptr<const Packet> p);
+
+    std::vector<Time> data_arrivals; //!< Data frames at the receiving device
+    uint32_t received;               //!< Messages delivered
+};
+
+OstSlotTestCase::OstSlotTestCase()
+    : TestCase("OST frames scheduled in time-code slots"),
+      received(0)
+{
+}
+
+void
+OstSlotTestCase::Send(Ptr<OstNode> node, uint8_t address, uint32_t size)
+{
+    std::vector<uint8_t> buffer(size, 0x5a);
+    int8_t r = node->send_packet(address, buffer.data(), size);
+    NS_TEST_EXPECT_MSG_GT(r, 0, "message accepted");
+}
+
+void
+OstSlotTestCase::Receive(uint8_t address, Ptr<Packet> p)
+{
+    received++;
+}
+
+void
+OstSlotTestCase::PhyRxEnd(Ptr<const Packet> p)
+{
+    uint8_t flags;
+    p->CopyData(&flags, 1);
+    if ((flags & 0b111) == 0)
+        data_arrivals.push_back(Simulator::Now());
+}
+
+void
+OstSlotTestCase::DoRun()
+{
+    Ptr<SpWChannel> channel = CreateObject<SpWChannel>();
+    channel->SetProcessingModel(nullptr);
+    Ptr<SpWDevice> dev[2];
+    Ptr<OstNode> node[2];
+    for (uint8_t i = 0; i < 2; ++i)
+    {
+        dev[i] = CreateObject<SpWDevice>();
+        dev[i]->SetDataRate(DataRate("100Mbps"));
+        dev[i]->Attach(channel);
+        dev[i]->SetAddress(Mac8Address(i));
+        dev[i]->SetQueue(CreateObject<DropTailQueue<Packet>>());
+        node[i] = CreateObject<OstNode>(dev[i], 0);
+        node[i]->SetSlotDuration(MicroSeconds(100));
+        Simulator::Schedule(MilliSeconds(1), &OstNode::start, node[i], i);
+    }
+    node[0]->AssignSlot(1, 5);
+    node[1]->AssignSlot(0, 6);
+    node[1]->SetReceiveCallback(MakeCallback(&OstSlotTestCase::Receive, this));
+    dev[1]->TraceConnectWithoutContext("PhyRxEnd", MakeCallback(&OstSlotTestCase::PhyRxEnd, this));
+
+    // time-code n starts at t0 + (n - 1) * period, slot 5 is [t0 + 4 period, t0 + 5 period)
+    const Time t0 = MilliSeconds(2);
+    const Time period = MicroSeconds(100);
+    Ptr<SpWTimeCodeGenerator> generator = CreateObject<SpWTimeCodeGenerator>();
+    generator->SetPeriod(period);
+    generator->AddDevice(dev[0]);
+    Simulator::Schedule(t0, &SpWTimeCodeGenerator::Start, generator);
+
+    const uint32_t messages = 20;
+    for (uint32_t i = 0; i < messages; ++i)
+    {
+        Simulator::Schedule(t0 + MicroSeconds(2000 + 10 * i), &OstSlotTestCase::Send, this, node[0], 1, 200);
+    }
+    Simulator::Stop(MilliSeconds(60));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(received, messages, "every message delivered");
+    NS_TEST_EXPECT_MSG_EQ(node[0]->GetHeldFrames(), 0, "nothing left waiting");
+    NS_TEST_ASSERT_MSG_GT(data_arrivals.size(), 0, "data frames seen");
+    for (Time t : data_arrivals)
+    {
+        Time phase = TimeStep((t - t0).GetTimeStep() % (period * 64).GetTimeStep());
+        NS_TEST_EXPECT_MSG_GT(phase, period * 4, "data frame after its slot started");
+        NS_TEST_EXPECT_MSG_LT(phase, period * 5 + MicroSeconds(1), "data frame before its slot ended");
+    }
+
+    OstFlowStats flow = node[1]->GetFlowStats(0);
+    NS_TEST_EXPECT_MSG_EQ(flow.frames, data_arrivals.size(), "every data frame measured");
+    NS_TEST_EXPECT_MSG_GT(flow.latency_max, flow.latency_min, "frames wait for their slot");
+    // the link holds LinkDepth (2) frames at most and four fit in a slot, so
+    // whatever the window a frame goes out in the first slot 5 after it is
+    // handed to the link: within a cycle of 64 time-codes and the slot
+    NS_TEST_EXPECT_MSG_LT(flow.latency_max, period * 65, "a frame goes out in the next slot");
+    NS_TEST_EXPECT_MSG_EQ(node[0]->GetFlowStats(1).frames, 0, "no data the other way");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup ost-tests
+ * As above, but the link is reset while data frames wait for slot 5. The
+ * held frames must be dropped and reported lost, not sent in the next
+ * slot after the reset, and the messages still get through.
+ */
+class OstSlotResetTestCase : public TestCase
+{
+  public:
+    OstSlotResetTestCase();
+    void DoRun() override;
+
+  private:
+    void Send(Ptr<OstNode> node, uint8_t address, uint32_t size);
+    void Receive(uint8_t address, Ptr<Packet> p);
+    void PhyRxEnd(Ptr<const Packet> p);
+    void Reset(Ptr<SpWDevice> a, Ptr<SpWDevice> b, Ptr<OstNode> node);
+    void CheckHeld(Ptr<OstNode> node);
+
+    Time reset_at;     //!< When the link was reset
+    uint32_t held;     //!< Frames waiting for their slot at the reset
+    uint32_t stale;    //!< Data frames handed to the link before the reset arriving after it
+    uint32_t received; //!< Messages delivered
+};
+
+OstSlotResetTestCase::OstSlotResetTestCase()
+    : TestCase("OST frames held for a slot dropped by a link reset"),
+      held(0),
+      stale(0),
+      received(0)
+{
+}
+
+void
+OstSlotResetTestCase::Send(Ptr<OstNode> node, uint8_t address, uint32_t size)
+{
+    std::vector<uint8_t> buffer(size, 0x5a);
+    int8_t r = node->send_packet(address, buffer.data(), size);
+    NS_TEST_EXPECT_MSG_GT(r, 0, "message accepted");
+}
+
+void
+OstSlotResetTestCase::Receive(uint8_t address, Ptr<Packet> p)
+{
+    received++;
+}
+
+void
+OstSlotResetTestCase::PhyRxEnd(Ptr<const Packet> p)
+{
+    uint8_t flags;
+    p->CopyData(&flags, 1);
+    OstTimestampTag sent;
+    if ((flags & 0b111) == 0 && !reset_at.IsZero() && p->PeekPacketTag(sent) &&
+        sent.get_sent() < reset_at)
+        stale++;
+}
+
+void
+OstSlotResetTestCase::Reset(Ptr<SpWDevice> a, Ptr<SpWDevice> b, Ptr<OstNode> node)
+{
+    reset_at = Simulator::Now();
+    held = node->GetHeldFrames();
+    a->ErrorResetSpWState();
+    b->ErrorResetSpWState();
+    Simulator::Schedule(MicroSeconds(1), &OstSlotResetTestCase::CheckHeld, this, node);
+}
+
+void
+OstSlotResetTestCase::CheckHeld(Ptr<OstNode> node)
+{
+    NS_TEST_EXPECT_MSG_EQ(node->GetHeldFrames(), 0, "held frames dropped by the reset");
+}
+
+void
+OstSlotResetTestCase::DoRun()
+{
+    Ptr<SpWChannel> channel = CreateObject<SpWChannel>();
+    channel->SetProcessingModel(nullptr);
+    Ptr<SpWDevice> dev[2];
+    Ptr<OstNode> node[2];
+    for (uint8_t i = 0; i < 2; ++i)
+    {
+        dev[i] = CreateObject<SpWDevice>();
+        dev[i]->SetDataRate(DataRate("100Mbps"));
+        dev[i]->Attach(channel);
+        dev[i]->SetAddress(Mac8Address(i));
+        dev[i]->SetQueue(CreateObject<DropTailQueue<Packet>>());
+        node[i] = CreateObject<OstNode>(dev[i], 0);
+        node[i]->SetSlotDuration(MicroSeconds(100));
+        Simulator::Schedule(MilliSeconds(1), &OstNode::start, node[i], i);
+    }
+    node[0]->AssignSlot(1, 5);
+    node[1]->AssignSlot(0, 6);
+    node[1]->SetReceiveCallback(MakeCallback(&OstSlotResetTestCase::Receive, this));
+    dev[1]->TraceConnectWithoutContext("PhyRxEnd", MakeCallback(&OstSlotResetTestCase::PhyRxEnd, this));
+
+    const Time t0 = MilliSeconds(2);
+    Ptr<SpWTimeCodeGenerator> generator = CreateObject<SpWTimeCodeGenerator>();
+    generator->SetPeriod(MicroSeconds(100));
+    generator->AddDevice(dev[0]);
+    Simulator::Schedule(t0, &SpWTimeCodeGenerator::Start, generator);
+
+    // sent in time-code 21, slot 5 of the next cycle is 4 ms away
+    const uint32_t messages = 20;
+    for (uint32_t i = 0; i < messages; ++i)
+    {
+        Simulator::Schedule(t0 + MicroSeconds(2000 + 10 * i), &OstSlotResetTestCase::Send, this, node[0], 1, 200);
+    }
+    Simulator::Schedule(t0 + MicroSeconds(3000), &OstSlotResetTestCase::Reset, this, dev[0], dev[1], node[0]);
+    Simulator::Stop(MilliSeconds(200));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_GT(held, 0, "frames waiting for their slot at the reset");
+    NS_TEST_EXPECT_MSG_EQ(stale, 0, "no frame from before the reset sent after it");
+    Ptr<OstSocket> socket;
+    NS_TEST_ASSERT_MSG_EQ(node[0]->GetSocket(1, socket), 1, "socket to the receiver");
+    uint32_t lost = socket->GetStats().frames_lost;
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(lost, held, "held frames reported lost");
+    NS_TEST_EXPECT_MSG_EQ(received, messages, "every message delivered");
+    NS_TEST_EXPECT_MSG_EQ(node[0]->GetHeldFrames(), 0, "nothing left waiting");
+
+    Simulator::Destroy();
+}
+
+} // namespace
+
+/**
+ * \ingroup ost-tests
+ * TestSuite for the slot schedule of OstNode
+ */
+class OstSlotTestSuite : public TestSuite
+{
+  public:
+    OstSlotTestSuite();
+};
+
+OstSlotTestSuite::OstSlotTestSuite()
+    : TestSuite("ost-slot", Type::UNIT)
+{
+    AddTestCase(new OstSlotTestCase(), Duration::QUICK);
+    AddTestCase(new OstSlotResetTestCase(), Duration::QUICK);
+}
+
+static OstSlotTestSuite sOstSlotTestSuite;
@@ -0,0 +1,281 @@
+#include "ns3/hw_timer.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/timer_fifo.h"
+#include "ns3/timer_service.h"
+
+#include <vector>
+
+using namespace ns3;
+using ost::TimerFifo;
+using ost::TimerService;
+
+NS_LOG_COMPONENT_DEFINE("OstTimerTest");
+
+/**
+ * \ingroup ost-tests
+ * Checks expiration order and time of the FIFO timers for both HwTimer backends.
+ */
+class TimerFifoTestCase : public TestCase, public TimerFifo::Listener
+{
+  public:
+    TimerFifoTestCase(bool tick);
+    void DoRun() override;
+
+  private:
+    bool timer_expired(uint8_t seq_n) override;
+    void Add(uint8_t seq_n, micros_t duration);
+    void Cancel(uint8_t seq_n);
+
+    bool m_tick;
+    Ptr<HwTimer> m_hw;
+    TimerFifo *m_fifo;
+    std::vector<std::pair<uint8_t, Time>> m_expired;
+};
+
+TimerFifoTestCase::TimerFifoTestCase(bool tick)
+    : TestCase(tick ? "TimerFifo over tick driven HwTimer" : "TimerFifo over event driven HwTimer"),
+      m_tick(tick)
+{
+}
+
+bool
+TimerFifoTestCase::timer_expired(uint8_t seq_n)
+{
+    m_expired.push_back(std::make_pair(seq_n, Simulator::Now()));
+    return true;
+}
+
+void
+TimerFifoTestCase::Add(uint8_t seq_n, micros_t duration)
+{
+    NS_TEST_EXPECT_MSG_EQ(m_fifo->add_new_timer(seq_n, duration), 1, "timer not added");
+}
+
+void
+TimerFifoTestCase::Cancel(uint8_t seq_n)
+{
+    NS_TEST_EXPECT_MSG_EQ(m_fifo->cancel_timer(seq_n), 1, "timer not canceled");
+}
+
+void
+TimerFifoTestCase::DoRun()
+{
+    m_hw = Create<HwTimer>();
+    if (m_tick)
+        m_hw->init_tick(4095, 0); // 4096 / 32768 kHz = 125 us
+    else
+        m_hw->init();
+    m_fifo = new TimerFifo(*m_hw);
+    m_fifo->set_listener(this);
+
+    Simulator::Schedule(MicroSeconds(0), &TimerFifoTestCase::Add, this, 1, 1000);
+    Simulator::Schedule(MicroSeconds(100), &TimerFifoTestCase::Add, this, 2, 1000);
+    Simulator::Schedule(MicroSeconds(300), &TimerFifoTestCase::Add, this, 3, 1000);
+    Simulator::Schedule(MicroSeconds(500), &TimerFifoTestCase::Cancel, this, 2);
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_expired.size(), 2, "two timers must expire");
+    NS_TEST_EXPECT_MSG_EQ(+m_expired[0].first, 1, "first timer");
+    NS_TEST_EXPECT_MSG_EQ(+m_expired[1].first, 3, "canceled timer fired");
+
+    Ptr<HwTimer> hw = m_hw;
+    NS_TEST_EXPECT_MSG_EQ(hw->get_stats().expirations, 2, "expirations");
+    if (m_tick)
+    {
+        Time tick = NanoSeconds(hw->get_tick_period_ns());
+        NS_TEST_EXPECT_MSG_EQ(tick, MicroSeconds(125), "tick period");
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(m_expired[1].second, MicroSeconds(1300), "fired early");
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(m_expired[1].second, MicroSeconds(1300) + tick, "fired late");
+        NS_TEST_EXPECT_MSG_EQ(hw->get_stats().interrupts,
+                              m_expired[1].second.GetMicroSeconds() / 125,
+                              "every tick is an interrupt");
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(hw->get_stats().lateness_max_ns,
+                                    int64_t(hw->get_tick_period_ns()),
+                                    "lateness bounded by a tick");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_expired[0].second, MicroSeconds(1000), "first timer time");
+        NS_TEST_EXPECT_MSG_EQ(m_expired[1].second, MicroSeconds(1300), "second timer time");
+        NS_TEST_EXPECT_MSG_EQ(hw->get_stats().lateness_max_ns, 0, "one-shot timer is exact");
+    }
+
+    delete m_fifo;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup ost-tests
+ * Checks that timers of several sockets share one HwTimer correctly.
+ */
+class TimerServiceTestCase : public TestCase, public TimerService::Listener
+{
+  public:
+    TimerServiceTestCase(bool tick);
+    void DoRun() override;
+
+  private:
+    struct Expiration
+    {
+        uint8_t port;
+        TimerService::TimerKind kind;
+        uint8_t seq_n;
+        Time at;
+    };
+
+    void timer_expired(uint8_t port, TimerService::TimerKind kind, uint8_t seq_n) override;
+    void Add(uint8_t port, TimerService::TimerKind kind, uint8_t seq_n, micros_t duration);
+    void Cancel(uint8_t port, TimerService::TimerKind kind, uint8_t seq_n);
+    void CancelPort(uint8_t port);
+    void Check(uint32_t i, uint8_t port, uint8_t seq_n, Time at);
+
+    bool m_tick;
+    Ptr<HwTimer> m_hw;
+    TimerService *m_timers;
+    std::vector<Expiration> m_expired;
+};
+
+TimerServiceTestCase::TimerServiceTestCase(bool tick)
+    : TestCase(tick ? "TimerService over tick driven HwTimer" : "TimerService over event driven HwTimer"),
+      m_tick(tick)
+{
+}
+
+void
+TimerServiceTestCase::timer_expired(uint8_t port, TimerService::TimerKind kind, uint8_t seq_n)
+{
+    Expiration e = {port, kind, seq_n, Simulator::Now()};
+    m_expired.push_back(e);
+}
+
+void
+TimerServiceTestCase::Add(uint8_t port, TimerService::TimerKind kind, uint8_t seq_n, micros_t duration)
+{
+    NS_TEST_EXPECT_MSG_EQ(m_timers->add_timer(port, kind, seq_n, duration), 1, "timer not added");
+}
+
+void
+TimerServiceTestCase::Cancel(uint8_t port, TimerService::TimerKind kind, uint8_t seq_n)
+{
+    NS_TEST_EXPECT_MSG_EQ(m_timers->cancel_timer(port, kind, seq_n), 1, "timer not canceled");
+}
+
+void
+TimerServiceTestCase::CancelPort(uint8_t port)
+{
+    NS_TEST_EXPECT_MSG_EQ(m_timers->cancel_port(port), 1, "timers of the port not canceled");
+}
+
+void
+TimerServiceTestCase::Check(uint32_t i, uint8_t port, uint8_t seq_n, Time at)
+{
+    NS_TEST_EXPECT_MSG_EQ(+m_expired[i].port, +port, "port of expiration " << i);
+    NS_TEST_EXPECT_MSG_EQ(+m_expired[i].seq_n, +seq_n, "seq_n of expiration " << i);
+    if (m_tick)
+    {
+        Time tick = NanoSeconds(m_hw->get_tick_period_ns());
+        NS_TEST_EXPECT_MSG_GT_OR_EQ(m_expired[i].at, at, "fired early " << i);
+        NS_TEST_EXPECT_MSG_LT_OR_EQ(m_expired[i].at, at + tick + tick, "fired late " << i);
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_expired[i].at, at, "time of expiration " << i);
+    }
+}
+
+void
+TimerServiceTestCase::DoRun()
+{
+    m_hw = Create<HwTimer>();
+    if (m_tick)
+        m_hw->init_tick(4095, 0);
+    else
+        m_hw->init();
+    m_timers = new TimerService(*m_hw);
+    m_timers->set_listener(this);
+
+    TimerService::TimerKind rt = TimerService::RETRANSMISSION;
+    Simulator::Schedule(MicroSeconds(0), &TimerServiceTestCase::Add, this, 0, rt, 1, 1000);
+    Simulator::Schedule(MicroSeconds(0), &TimerServiceTestCase::Add, this, 1, rt, 1, 500);
+    Simulator::Schedule(MicroSeconds(100), &TimerServiceTestCase::Add, this, 2, TimerService::DELAYED_ACK, 7, 400);
+    Simulator::Schedule(MicroSeconds(200), &TimerServiceTestCase::Cancel, this, 0, rt, 1);
+    Simulator::Schedule(MicroSeconds(200), &TimerServiceTestCase::Add, this, 0, rt, 2, 1000);
+    // restart of a pending timer
+    Simulator::Schedule(MicroSeconds(300), &TimerServiceTestCase::Add, this, 1, rt, 1, 1000);
+    Simulator::Schedule(MicroSeconds(400), &TimerServiceTestCase::Add, this, 3, TimerService::KEEPALIVE, 0, 100);
+    Simulator::Schedule(MicroSeconds(600), &TimerServiceTestCase::CancelPort, this, 0);
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_expired.size(), 3, "three timers must expire");
+    Check(0, 2, 7, MicroSeconds(500));
+    Check(1, 3, 0, MicroSeconds(500));
+    Check(2, 1, 1, MicroSeconds(1300));
+    NS_TEST_EXPECT_MSG_EQ(m_expired[0].kind, TimerService::DELAYED_ACK, "kind is kept");
+    NS_TEST_EXPECT_MSG_EQ(m_timers->get_number_of_timers(), 0, "no timers left");
+
+    delete m_timers;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup ost-tests
+ * Checks that the event driven HwTimer never reports more time left than
+ * there is, TimerService derives the current time from it.
+ */
+class HwTimerLeftTimeTestCase : public TestCase
+{
+  public:
+    HwTimerLeftTimeTestCase();
+    void DoRun() override;
+
+  private:
+    void Check(Ptr<HwTimer> hw, micros_t left);
+};
+
+HwTimerLeftTimeTestCase::HwTimerLeftTimeTestCase()
+    : TestCase("Time left of an event driven HwTimer")
+{
+}
+
+void
+HwTimerLeftTimeTestCase::Check(Ptr<HwTimer> hw, micros_t left)
+{
+    NS_TEST_EXPECT_MSG_EQ(hw->get_left_time(), left, "time left at " << Simulator::Now());
+}
+
+void
+HwTimerLeftTimeTestCase::DoRun()
+{
+    Ptr<HwTimer> hw = Create<HwTimer>();
+    hw->init();
+    hw->start(10);
+    Simulator::Schedule(NanoSeconds(3000), &HwTimerLeftTimeTestCase::Check, this, hw, 7);
+    Simulator::Schedule(NanoSeconds(3500), &HwTimerLeftTimeTestCase::Check, this, hw, 6);
+    Simulator::Schedule(NanoSeconds(9999), &HwTimerLeftTimeTestCase::Check, this, hw, 0);
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup ost-tests
+ * TestSuite for the retransmission timers
+ */
+class OstTimerTestSuite : public TestSuite
+{
+  public:
+    OstTimerTestSuite();
+};
+
+OstTimerTestSuite::OstTimerTestSuite()
+    : TestSuite("ost-timers", Type::UNIT)
+{
+    AddTestCase(new TimerFifoTestCase(false), Duration::QUICK);
+    AddTestCase(new TimerFifoTestCase(true), Duration::QUICK);
+    AddTestCase(new TimerServiceTestCase(false), Duration::QUICK);
+    AddTestCase(new TimerServiceTestCase(true), Duration::QUICK);
+    AddTestCase(new HwTimerLeftTimeTestCase(), Duration::QUICK);
+}
+
+static OstTimerTestSuite sOstTimerTestSuite;
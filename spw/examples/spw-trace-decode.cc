@@ -0,0 +1,47 @@
+/*
+ * Print a SpWTraceSink file as the SpWChannel log lines, each prefixed
+ * with its time like NS_LOG with LOG_PREFIX_TIME.
+ *
+ *   ./ns3 run "spw-trace-decode --file=spw.trace"
+ *   ./ns3 run "spw-trace-decode --file=spw.trace --time=0"
+ */
+
+#include "ns3/command-line.h"
+#include "ns3/spw-trace-sink.h"
+
+#include <cinttypes>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+int
+main(int argc, char* argv[])
+{
+    std::string fileName = "spw.trace";
+    bool withTime = true;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("file", "Trace file written by SpWTraceSink", fileName);
+    cmd.AddValue("time", "Prefix the lines with their time", withTime);
+    cmd.Parse(argc, argv);
+
+    std::vector<SpWTraceRecord> records;
+    if (!SpWTraceSink::Load(fileName, records))
+    {
+        std::cerr << fileName << " is not a SpW trace file\n";
+        return 1;
+    }
+
+    for (const auto& r : records)
+    {
+        if (withTime)
+        {
+            printf("+%" PRId64 ".%09" PRId64 "s ", r.timeNs / 1000000000, r.timeNs % 1000000000);
+        }
+        printf("%s\n", FormatSpWTraceRecord(r).c_str());
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+#include "spw-helper.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/mac8-address.h"
+#include "ns3/node.h"
+#include "ns3/queue.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SpWHelper");
+
+SpWHelper::SpWHelper()
+{
+    m_deviceFactory.SetTypeId("ns3::SpWDevice");
+    m_channelFactory.SetTypeId("ns3::SpWChannel");
+    m_queueFactory.SetTypeId("ns3::DropTailQueue<Packet>");
+}
+
+void
+SpWHelper::SetDeviceAttribute(std::string name, const AttributeValue& value)
+{
+    m_deviceFactory.Set(name, value);
+}
+
+void
+SpWHelper::SetChannelAttribute(std::string name, const AttributeValue& value)
+{
+    m_channelFactory.Set(name, value);
+}
+
+void
+SpWHelper::SetQueue(std::string type)
+{
+    m_queueFactory.SetTypeId(type);
+}
+
+void
+SpWHelper::SetQueueAttribute(std::string name, const AttributeValue& value)
+{
+    m_queueFactory.Set(name, value);
+}
+
+NetDeviceContainer
+SpWHelper::Install(Ptr<Node> a, Ptr<Node> b)
+{
+    NS_LOG_FUNCTION(this << a << b);
+    Ptr<SpWChannel> channel = m_channelFactory.Create<SpWChannel>();
+    NetDeviceContainer devices;
+    devices.Add(InstallDevice(a, channel));
+    devices.Add(InstallDevice(b, channel));
+    return devices;
+}
+
+NetDeviceContainer
+SpWHelper::Install(const NodeContainer& c)
+{
+    NS_ABORT_MSG_IF(c.GetN() != 2, "SpWHelper links exactly two nodes, not " << c.GetN());
+    return Install(c.Get(0), c.Get(1));
+}
+
+NetDeviceContainer
+SpWHelper::Install(const NodeContainer& a, const NodeContainer& b)
+{
+    NS_ABORT_MSG_IF(a.GetN() != b.GetN(),
+                    "SpWHelper cannot pair " << a.GetN() << " nodes with " << b.GetN());
+    NetDeviceContainer devices;
+    for (uint32_t i = 0; i < a.GetN(); ++i)
+    {
+        devices.Add(Install(a.Get(i), b.Get(i)));
+    }
+    return devices;
+}
+
+Ptr<SpWDevice>
+SpWHelper::InstallDevice(Ptr<Node> node, Ptr<SpWChannel> channel)
+{
+    Ptr<SpWDevice> device = m_deviceFactory.Create<SpWDevice>();
+    device->SetAddress(Mac8Address::Allocate());
+    node->AddDevice(device);
+    device->SetQueue(m_queueFactory.Create<Queue<Packet>>());
+    device->Attach(channel);
+    return device;
+}
+
+} // namespace ns3
@@ -0,0 +1,95 @@
+#ifndef SPW_HELPER_H
+#define SPW_HELPER_H
+
+#include "ns3/net-device-container.h"
+#include "ns3/node-container.h"
+#include "ns3/object-factory.h"
+#include "ns3/spw-channel.h"
+#include "ns3/spw-device.h"
+
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point
+ * \brief Builds SpW links: a channel and a device at each end.
+ *
+ * Devices, channels and transmit queues are made by factories set up once
+ * with SetDeviceAttribute, SetChannelAttribute and SetQueue, so a scenario
+ * with hundreds of links configures them in one place. An attribute that
+ * holds an object, such as the ProcessingModel or the TraceSink of the
+ * channels, is shared by every link installed.
+ *
+ * Every device gets the next Mac8Address. The addresses only have to be
+ * unique among the nodes that reach each other through routers, so links
+ * on their own may wrap around.
+ */
+class SpWHelper
+{
+  public:
+    SpWHelper();
+
+    /**
+     * \param name attribute of the SpWDevice
+     * \param value its value
+     */
+    void SetDeviceAttribute(std::string name, const AttributeValue& value);
+
+    /**
+     * \param name attribute of the SpWChannel
+     * \param value its value
+     */
+    void SetChannelAttribute(std::string name, const AttributeValue& value);
+
+    /**
+     * \param type TypeId of the transmit queue, ns3::DropTailQueue<Packet>
+     * by default
+     */
+    void SetQueue(std::string type);
+
+    /**
+     * \param name attribute of the transmit queue
+     * \param value its value
+     */
+    void SetQueueAttribute(std::string name, const AttributeValue& value);
+
+    /**
+     * Link two nodes.
+     *
+     * \param a the first node
+     * \param b the second node
+     * \return the device of a, then the device of b
+     */
+    NetDeviceContainer Install(Ptr<Node> a, Ptr<Node> b);
+
+    /**
+     * \param c exactly two nodes
+     * \return their devices
+     */
+    NetDeviceContainer Install(const NodeContainer& c);
+
+    /**
+     * Link every node of a to the node of b at the same index.
+     *
+     * \param a the first nodes
+     * \param b as many nodes
+     * \return the devices of each link in turn, the one of a first
+     */
+    NetDeviceContainer Install(const NodeContainer& a, const NodeContainer& b);
+
+  private:
+    /**
+     * \return a new device of node attached to channel
+     */
+    Ptr<SpWDevice> InstallDevice(Ptr<Node> node, Ptr<SpWChannel> channel);
+
+    ObjectFactory m_deviceFactory;  //!< Factory of the devices
+    ObjectFactory m_channelFactory; //!< Factory of the channels
+    ObjectFactory m_queueFactory;   //!< Factory of the transmit queues
+};
+
+} // namespace ns3
+
+#endif /* SPW_HELPER_H */
@@ -0,0 +1,51 @@
+#include "spw-pcap-helper.h"
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SpWPcapHelper");
+
+SpWPcapHelper::SpWPcapHelper()
+{
+    m_writerFactory.SetTypeId("ns3::SpWPcapWriter");
+}
+
+void
+SpWPcapHelper::SetWriterAttribute(std::string name, const AttributeValue& value)
+{
+    m_writerFactory.Set(name, value);
+}
+
+Ptr<SpWPcapWriter>
+SpWPcapHelper::EnablePcap(const std::string& fileName, Ptr<SpWDevice> device)
+{
+    NS_LOG_FUNCTION(this << fileName << device);
+    Ptr<SpWPcapWriter> writer = m_writerFactory.Create<SpWPcapWriter>();
+    writer->Open(fileName);
+    device->TraceConnectWithoutContext("PromiscSniffer",
+                                       MakeCallback(&SpWPcapWriter::Capture, writer));
+    Simulator::ScheduleDestroy(&SpWPcapWriter::Close, writer);
+    return writer;
+}
+
+void
+SpWPcapHelper::EnablePcap(const std::string& prefix, const NetDeviceContainer& devices)
+{
+    for (auto i = devices.Begin(); i != devices.End(); ++i)
+    {
+        Ptr<SpWDevice> device = DynamicCast<SpWDevice>(*i);
+        if (!device)
+        {
+            continue;
+        }
+        EnablePcap(prefix + "-" + std::to_string(device->GetNode()->GetId()) + "-" +
+                       std::to_string(device->GetIfIndex()) + ".pcap",
+                   device);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,57 @@
+#ifndef SPW_PCAP_HELPER_H
+#define SPW_PCAP_HELPER_H
+
+#include "ns3/net-device-container.h"
+#include "ns3/object-factory.h"
+#include "ns3/spw-device.h"
+#include "ns3/spw-pcap-writer.h"
+
+#include <string>
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point
+ * \brief Attaches a SpWPcapWriter to the sniffer of SpWDevices.
+ *
+ * Every device gets its own writer, set up with the attributes given to
+ * SetWriterAttribute. The writers are closed when the simulator is
+ * destroyed.
+ */
+class SpWPcapHelper
+{
+  public:
+    SpWPcapHelper();
+
+    /**
+     * \param name attribute of the SpWPcapWriter
+     * \param value its value
+     */
+    void SetWriterAttribute(std::string name, const AttributeValue& value);
+
+    /**
+     * Capture the frames of a device.
+     *
+     * \param fileName name of the first file
+     * \param device the device
+     * \return the writer
+     */
+    Ptr<SpWPcapWriter> EnablePcap(const std::string& fileName, Ptr<SpWDevice> device);
+
+    /**
+     * Capture the frames of every SpWDevice of the container to
+     * prefix-<node id>-<device index>.pcap.
+     *
+     * \param prefix start of the file names
+     * \param devices the devices
+     */
+    void EnablePcap(const std::string& prefix, const NetDeviceContainer& devices);
+
+  private:
+    ObjectFactory m_writerFactory; //!< Factory of the writers
+};
+
+} // namespace ns3
+
+#endif /* SPW_PCAP_HELPER_H */
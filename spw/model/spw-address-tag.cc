@@ -0,0 +1,116 @@
+#include "spw-address-tag.h"
+
+#include "ns3/abort.h"
+
+#include <cstring>
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(SpWAddressTag);
+
+SpWAddressTag::SpWAddressTag()
+    : m_pathSize(0),
+      m_logical(0)
+{
+}
+
+SpWAddressTag::SpWAddressTag(const std::vector<uint8_t>& path, uint8_t logical)
+    : m_pathSize(path.size()),
+      m_logical(logical)
+{
+    NS_ABORT_MSG_IF(path.size() > MAX_PATH,
+                    "SpWAddressTag holds " << +MAX_PATH << " path characters, not "
+                                           << path.size());
+    std::copy(path.begin(), path.end(), m_path);
+}
+
+TypeId
+SpWAddressTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::SpWAddressTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("PointToPoint")
+                            .AddConstructor<SpWAddressTag>();
+    return tid;
+}
+
+TypeId
+SpWAddressTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+SpWAddressTag::GetSerializedSize() const
+{
+    return 2 + m_pathSize;
+}
+
+void
+SpWAddressTag::Serialize(TagBuffer i) const
+{
+    i.WriteU8(m_pathSize);
+    for (uint8_t k = 0; k < m_pathSize; ++k)
+    {
+        i.WriteU8(m_path[k]);
+    }
+    i.WriteU8(m_logical);
+}
+
+void
+SpWAddressTag::Deserialize(TagBuffer i)
+{
+    m_pathSize = i.ReadU8();
+    for (uint8_t k = 0; k < m_pathSize; ++k)
+    {
+        m_path[k] = i.ReadU8();
+    }
+    m_logical = i.ReadU8();
+}
+
+void
+SpWAddressTag::Print(std::ostream& os) const
+{
+    os << "path:";
+    for (uint8_t k = 0; k < m_pathSize; ++k)
+    {
+        os << " " << std::to_string(m_path[k]);
+    }
+    os << ", logical: " << std::to_string(m_logical);
+}
+
+bool
+SpWAddressTag::HasPath() const
+{
+    return m_pathSize > 0;
+}
+
+uint8_t
+SpWAddressTag::GetPort() const
+{
+    NS_ASSERT(HasPath());
+    return m_path[0];
+}
+
+void
+SpWAddressTag::PopPath()
+{
+    NS_ASSERT(HasPath());
+    m_pathSize--;
+    memmove(m_path, m_path + 1, m_pathSize);
+}
+
+uint8_t
+SpWAddressTag::GetLogicalAddress() const
+{
+    return m_logical;
+}
+
+uint32_t
+SpWAddressTag::GetChars() const
+{
+    return m_pathSize + 1;
+}
+
+} // namespace ns3
@@ -0,0 +1,77 @@
+#ifndef SPW_ADDRESS_TAG_H
+#define SPW_ADDRESS_TAG_H
+
+#include "ns3/tag.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point
+ * \brief SpaceWire destination address of a frame crossing routers.
+ *
+ * A SpaceWire packet starts with its destination address: path address
+ * characters, one output port number per router, each router deleting
+ * the one it used, then the logical address the last routers look up in
+ * their routing tables and the destination receives. The tag carries the
+ * characters that are still in front of the frame, SpWDevice counts them
+ * in the line time of the frame and SpWRouter reads and deletes them, so
+ * the frame itself stays what the node above the device sent.
+ */
+class SpWAddressTag : public Tag
+{
+  public:
+    static const uint8_t MAX_PATH = 16; //!< Path characters a tag can hold
+
+    SpWAddressTag();
+
+    /**
+     * \param path output ports of the routers on the way, first router first
+     * \param logical the logical address of the destination
+     */
+    SpWAddressTag(const std::vector<uint8_t>& path, uint8_t logical);
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(TagBuffer i) const override;
+    void Deserialize(TagBuffer i) override;
+    void Print(std::ostream& os) const override;
+
+    /**
+     * \return true if a path address character is left
+     */
+    bool HasPath() const;
+
+    /**
+     * \return the output port of the first path address character
+     */
+    uint8_t GetPort() const;
+
+    /**
+     * Delete the first path address character, as the router does.
+     */
+    void PopPath();
+
+    uint8_t GetLogicalAddress() const;
+
+    /**
+     * \return address characters in front of the frame
+     */
+    uint32_t GetChars() const;
+
+  private:
+    uint8_t m_path[MAX_PATH]; //!< Path address characters left
+    uint8_t m_pathSize;       //!< Characters in m_path
+    uint8_t m_logical;        //!< Logical address
+};
+
+} // namespace ns3
+
+#endif /* SPW_ADDRESS_TAG_H */
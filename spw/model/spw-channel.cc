@@ -17,12 +17,15 @@
 
 #include "spw-channel.h"
 
+#include "spw-address-tag.h"
 #include "spw-device.h"
 
 #include "ns3/log.h"
 #include "ns3/ost-header.h"
 #include "ns3/packet.h"
+#include "ns3/pointer.h"
 #include "ns3/simulator.h"
+#include "ns3/string.h"
 #include "ns3/trace-source-accessor.h"
 
 namespace ns3
@@ -45,6 +48,17 @@ namespace ns3
                               TimeValue(NanoSeconds(48)),
                               MakeTimeAccessor(&SpWChannel::m_delay),
                               MakeTimeChecker())
+                .AddAttribute("ProcessingModel",
+                              "Time the receivers take for a frame before their "
+                              "device gets it, none if null",
+                              StringValue("ns3::SpWFixedProcessingModel"),
+                              MakePointerAccessor(&SpWChannel::m_processingModel),
+                              MakePointerChecker<SpWProcessingModel>())
+                .AddAttribute("TraceSink",
+                              "Records every transmission and reception, none if null",
+                              PointerValue(),
+                              MakePointerAccessor(&SpWChannel::m_traceSink),
+                              MakePointerChecker<SpWTraceSink>())
                 .AddTraceSource("TxRxPointToPoint",
                                 "Trace source indicating transmission of packet "
                                 "from the SpWChannel, used by the Animation "
@@ -62,6 +76,7 @@ namespace ns3
           m_delay(NanoSeconds(48)),
           m_nDevices(0),
           m_cnt_packets(0),
+          m_processingModel(CreateObject<SpWFixedProcessingModel>()),
           m_events(std::unordered_map<uint32_t, EventId>())
     {
         NS_LOG_FUNCTION_NOARGS();
@@ -92,103 +107,92 @@ namespace ns3
         }
     }
 
-    void SpWChannel::PrintTransmission(Address src,
-                                       uint8_t seq_n,
-                                       bool isAck,
-                                       uint32_t ch_packet_seq_n,
-                                       bool isReceiption,
-                                       uint32_t uid) const
+    uint8_t
+    SpWChannel::GetTraceFlags(Ptr<const Packet> p, uint8_t& seq_n)
     {
-        uint32_t wire = src == m_link[0].m_src->GetAddress() ? 0 : 1;
-        uint8_t senderAddress[Address::MAX_SIZE];
-        src.CopyTo(senderAddress);
-        uint8_t sender = senderAddress[0];
-
-        uint8_t recieverAddress[Address::MAX_SIZE];
-        m_link[wire].m_dst->GetAddress().CopyTo(recieverAddress);
-        uint8_t receiver = recieverAddress[0];
-        bool with_event = false;
-
-        char buff[500];
-        char format[100];
-        
-        if(wire == 0)
-        {
-            if(isAck)
-                if(isReceiption)
-                    strcpy(format, "         NODE[%2d] --(%2d)-> <SEQ.N=%3d><ACK> NODE[%2d] received");
-                else
-                    strcpy(format, "         NODE[%2d] --(%2d)-> <SEQ.N=%3d><ACK> NODE[%2d]         ");
-            else 
-                if(isReceiption)
-                    strcpy(format, "         NODE[%2d] --(%2d)-> <SEQ.N=%3d>      NODE[%2d] received");
-                else
-                    strcpy(format, "         NODE[%2d] --(%2d)-> <SEQ.N=%3d>      NODE[%2d]         ");
-            if(with_event)
-            {
-                std::strcat(format, " | event_id=%u");
-                sprintf(buff, format, sender, ch_packet_seq_n, seq_n, receiver, uid);
-            }
-            else{
-                sprintf(buff, format, sender, ch_packet_seq_n, seq_n, receiver);
-            }
-        }
-        else
+        OstHeader h;
+        p->PeekHeader(h);
+        NS_LOG_FUNCTION(h);
+        seq_n = h.get_seq_number();
+        return (h.is_ack() ? SpWTraceRecord::FLAG_ACK : 0) |
+               (h.is_syn() ? SpWTraceRecord::FLAG_SYN : 0) |
+               (h.is_rst() ? SpWTraceRecord::FLAG_RST : 0) |
+               (h.is_dta() ? SpWTraceRecord::FLAG_DTA : 0);
+    }
+
+    void
+    SpWChannel::TraceTransmission(Ptr<const Packet> p,
+                                  uint32_t wire,
+                                  uint8_t seq_n,
+                                  uint8_t flags,
+                                  uint32_t ch_packet_seq_n,
+                                  SpWTraceRecord::Kind kind) const
+    {
+        uint8_t address[Address::MAX_SIZE];
+        SpWTraceRecord r;
+        r.timeNs = Simulator::Now().GetNanoSeconds();
+        r.size = p->GetSize();
+        r.channelSeq = ch_packet_seq_n;
+        r.kind = kind;
+        r.wire = wire;
+        m_link[wire].m_src->GetAddress().CopyTo(address);
+        r.src = address[0];
+        m_link[wire].m_dst->GetAddress().CopyTo(address);
+        r.dst = address[0];
+        r.seq = seq_n;
+        r.flags = flags;
+        r.reserved = 0;
+
+        if (m_traceSink)
         {
-            if(isAck)
-                if(isReceiption)
-                    strcpy(format, "received NODE[%2d] <-(%2d)-- <SEQ.N=%3d><ACK> NODE[%2d]         ");
-                else
-                    strcpy(format, "         NODE[%2d] <-(%2d)-- <SEQ.N=%3d><ACK> NODE[%2d]         ");
-            else 
-                if(isReceiption)
-                    strcpy(format, "received NODE[%3d] <-(%2d)-- <SEQ.N=%3d>      NODE[%2d]         ");
-                else
-                    strcpy(format, "         NODE[%2d] <-(%2d)-- <SEQ.N=%3d>      NODE[%2d]         ");
-
-            if(with_event)
-            {
-                std::strcat(format, " | event_id=%u");
-                sprintf(buff, format, receiver, ch_packet_seq_n, seq_n, sender, uid);
-            }
-            else
-            {
-                sprintf(buff, format, receiver, ch_packet_seq_n, seq_n, sender);
-            }
+            m_traceSink->Record(r);
         }
-        NS_LOG_INFO(buff);
+        NS_LOG_INFO(FormatSpWTraceRecord(r));
     }
 
     void
     SpWChannel::TransmissionComplete(Ptr<const Packet> p,
                                      Address src,
                                      uint8_t seq_n,
-                                     bool isAck,
+                                     uint8_t flags,
                                      uint32_t ch_packet_seq_n,
                                      bool isReceiption)
     {
         uint32_t wire = src == m_link[0].m_src->GetAddress() ? 0 : 1;
         m_events[wire].erase(p->GetUid());
+        m_inFlight[wire].erase(p->GetUid());
         transmited[wire] += p->GetSize();
         packets[wire] ++;
+        if (m_link[wire].m_dst->IsCutThrough())
+        {
+            // the router has had the packet since its head came in
+            m_heads[wire].erase(p->GetUid());
+            TraceTransmission(p, wire, seq_n, flags, ch_packet_seq_n, SpWTraceRecord::RX_END);
+            return;
+        }
+        Time delay;
+        if (m_processingModel && !m_processingModel->Admit(p, wire, delay))
+        {
+            return;
+        }
         Simulator::Schedule(
-                        MilliSeconds(100),
+                        delay,
                         &SpWChannel::HandlingArrivedComplete,
                         this,
                         p,
-                        src,seq_n,isAck,ch_packet_seq_n,isReceiption);
+                        src,seq_n,flags,ch_packet_seq_n,isReceiption);
     }
 
     void
     SpWChannel::HandlingArrivedComplete(Ptr<const Packet> p,
                                      Address src,
                                      uint8_t seq_n,
-                                     bool isAck,
+                                     uint8_t flags,
                                      uint32_t ch_packet_seq_n,
                                      bool isReceiption)
     {
         uint32_t wire = src == m_link[0].m_src->GetAddress() ? 0 : 1;
-        PrintTransmission(src, seq_n, isAck, ch_packet_seq_n, isReceiption, m_events[wire][p->GetUid()].GetUid());
+        TraceTransmission(p, wire, seq_n, flags, ch_packet_seq_n, SpWTraceRecord::RX_END);
         Simulator::ScheduleNow(
                         &SpWDevice::Receive,
                         m_link[wire].m_dst,
@@ -206,29 +210,79 @@ namespace ns3
 
         uint32_t wire = src == m_link[0].m_src ? 0 : 1;
 
-        OstHeader h;
-        p->PeekHeader(h);
-        NS_LOG_FUNCTION(h);
+        uint8_t seq_n;
+        uint8_t flags = GetTraceFlags(p, seq_n);
         IncCntPackets();
-        bool isAck = h.is_ack();
-
-        uint8_t seq_n = h.get_seq_number();
         EventId event = Simulator::Schedule(txTime + m_delay,
                                             &SpWChannel::TransmissionComplete,
                                             this,
                                             p,
                                             src->GetAddress(),
                                             seq_n,
-                                            isAck,
+                                            flags,
                                             m_cnt_packets,
                                             true);
-        PrintTransmission(src->GetAddress(), seq_n, isAck, m_cnt_packets, false, event.GetUid());
+        TraceTransmission(p, wire, seq_n, flags, m_cnt_packets, SpWTraceRecord::TX_START);
         m_events[wire][p->GetUid()]=event;
+        m_inFlight[wire][p->GetUid()] = p;
+
+        Ptr<SpWDevice> dst = m_link[wire].m_dst;
+        if (dst->IsCutThrough())
+        {
+            // a router switches the packet once its address characters are in
+            SpWAddressTag tag;
+            uint32_t chars = p->PeekPacketTag(tag) ? tag.GetChars() : 1;
+            Time head = Min(src->GetLineTime(chars) - src->GetLineTime(0), txTime);
+            m_heads[wire][p->GetUid()] = Simulator::Schedule(head + m_delay,
+                                                             &SpWDevice::ReceiveHead,
+                                                             dst,
+                                                             p->Copy(),
+                                                             Simulator::Now() + txTime + m_delay);
+        }
 
         m_txrxPointToPoint(p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
         return true;
     }
 
+    void
+    SpWChannel::TransmitEep(Ptr<const Packet> p, uint32_t received, Ptr<SpWDevice> src, Time txTime)
+    {
+        NS_LOG_FUNCTION(this << p << received << src);
+
+        NS_ASSERT(m_link[0].m_state != INITIALIZING);
+        NS_ASSERT(m_link[1].m_state != INITIALIZING);
+
+        uint32_t wire = src == m_link[0].m_src ? 0 : 1;
+        uint8_t seq_n;
+        uint8_t flags = GetTraceFlags(p, seq_n);
+        IncCntPackets();
+        EventId event = Simulator::Schedule(txTime + m_delay,
+                                            &SpWChannel::EepArrived,
+                                            this,
+                                            p->CreateFragment(0, received),
+                                            wire,
+                                            seq_n,
+                                            flags,
+                                            m_cnt_packets);
+        TraceTransmission(p, wire, seq_n, flags, m_cnt_packets, SpWTraceRecord::TX_START);
+        m_events[wire][p->GetUid()] = event;
+        // lost in the reset the EEP starts
+        m_inFlight[wire][p->GetUid()] = p;
+
+        m_txrxPointToPoint(p, src, m_link[wire].m_dst, txTime, txTime + m_delay);
+    }
+
+    void
+    SpWChannel::EepArrived(Ptr<Packet> head,
+                           uint32_t wire,
+                           uint8_t seq_n,
+                           uint8_t flags,
+                           uint32_t ch_packet_seq_n)
+    {
+        TraceTransmission(head, wire, seq_n, flags, ch_packet_seq_n, SpWTraceRecord::RX_EEP);
+        m_link[wire].m_dst->ReceiveEep(head);
+    }
+
     void
     SpWChannel::NotifyError(Ptr<SpWDevice> caller)
     {
@@ -244,6 +298,18 @@ namespace ns3
                 Simulator::Cancel(it.second);
             }
             m_events[w].clear();
+            for (auto& it: m_heads[w]) {
+                Simulator::Cancel(it.second);
+            }
+            m_heads[w].clear();
+        }
+        for (int w = 0; w < 2; ++w)
+        {
+            std::unordered_map<uint32_t, Ptr<const Packet>> lost;
+            lost.swap(m_inFlight[w]);
+            for (auto& it: lost) {
+                m_link[w].m_src->NotifyPacketLost(it.second);
+            }
         }
 
         uint32_t wire = caller == m_link[0].m_src ? 0 : 1;
@@ -258,7 +324,7 @@ namespace ns3
         NS_ASSERT(m_link[1].m_state != INITIALIZING);
 
         uint32_t wire = caller == m_link[0].m_src ? 0 : 1;
-        Simulator::Schedule(NanoSeconds(11), &SpWDevice::ReceiveNull, m_link[wire].m_dst);
+        Simulator::Schedule(GetControlCharDelay(caller, NULL_BITS), &SpWDevice::ReceiveNull, m_link[wire].m_dst);
     }
 
     void
@@ -269,7 +335,54 @@ namespace ns3
         NS_ASSERT(m_link[1].m_state != INITIALIZING);
 
         uint32_t wire = caller == m_link[0].m_src ? 0 : 1;
-        Simulator::Schedule(NanoSeconds(11), &SpWDevice::ReceiveFCT, m_link[wire].m_dst);
+        Simulator::Schedule(GetControlCharDelay(caller, FCT_BITS), &SpWDevice::ReceiveFCT, m_link[wire].m_dst);
+    }
+
+    void
+    SpWChannel::TimeCodeInLink(Ptr<SpWDevice> caller, uint8_t timeCode, Time txTime)
+    {
+        NS_LOG_FUNCTION(this << caller << +timeCode);
+        uint32_t wire = caller == m_link[0].m_src ? 0 : 1;
+        Simulator::Schedule(txTime + m_delay, &SpWDevice::ReceiveTimeCode, m_link[wire].m_dst, timeCode);
+    }
+
+    void
+    SpWChannel::StartedInLink(Ptr<SpWDevice> caller)
+    {
+        NS_LOG_FUNCTION(this << caller);
+        if (m_nDevices < N_DEVICES)
+        {
+            return;
+        }
+
+        uint32_t wire = caller == m_link[0].m_src ? 0 : 1;
+        Ptr<SpWDevice> peer = m_link[wire].m_dst;
+        Time now = Simulator::Now();
+        Time peerAt;
+        Time callerAt;
+        // both must send NULLs at the same time, the caller only until it times out
+        if (!peer->GetNextStartedTime(now, peerAt) || !caller->GetNextStartedTime(peerAt, callerAt) ||
+            callerAt != peerAt)
+        {
+            return;
+        }
+        // the later of the NULLs, then the later of the FCTs
+        Time runDelay = peerAt - now +
+                        Max(GetControlCharDelay(caller, NULL_BITS), GetControlCharDelay(peer, NULL_BITS)) +
+                        Max(GetControlCharDelay(caller, FCT_BITS), GetControlCharDelay(peer, FCT_BITS));
+        caller->HandshakeSpWState(runDelay);
+        peer->HandshakeSpWState(runDelay);
+    }
+
+    Time
+    SpWChannel::GetControlCharDelay(Ptr<SpWDevice> src, uint32_t bits) const
+    {
+        DataRate rate = src->GetStartupDataRate();
+        if (rate.GetBitRate() == 0)
+        {
+            return CONTROL_CHAR_DELAY;
+        }
+        return rate.CalculateBitsTxTime(bits) + m_delay;
     }
 
     std::size_t
@@ -320,6 +433,30 @@ namespace ns3
         return true;
     }
 
+    void
+    SpWChannel::SetProcessingModel(Ptr<SpWProcessingModel> model)
+    {
+        m_processingModel = model;
+    }
+
+    Ptr<SpWProcessingModel>
+    SpWChannel::GetProcessingModel() const
+    {
+        return m_processingModel;
+    }
+
+    void
+    SpWChannel::SetTraceSink(Ptr<SpWTraceSink> sink)
+    {
+        m_traceSink = sink;
+    }
+
+    Ptr<SpWTraceSink>
+    SpWChannel::GetTraceSink() const
+    {
+        return m_traceSink;
+    }
+
     uint32_t
     SpWChannel::GetCntPackets() const
     {
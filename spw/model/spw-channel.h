@@ -18,6 +18,9 @@
 #ifndef SPW_CHANNEL_H
 #define SPW_CHANNEL_H
 
+#include "spw-processing-model.h"
+#include "spw-trace-sink.h"
+
 #include "ns3/channel.h"
 #include "ns3/data-rate.h"
 #include "ns3/nstime.h"
@@ -77,6 +80,11 @@ class SpWChannel : public Channel
 
     /**
      * \brief Transmit a packet over this channel
+     *
+     * A cut-through destination, see SpWDevice::SetHeadReceiveCallback,
+     * gets the packet once its address characters are in, without
+     * processing time.
+     *
      * \param p Packet to transmit
      * \param src Source PointToPointNetDevice
      * \param txTime Transmit time to apply
@@ -84,11 +92,20 @@ class SpWChannel : public Channel
      */
     virtual bool TransmitStart(Ptr<const Packet> p, Ptr<SpWDevice> src, Time txTime);
 
+    /**
+     * \brief Transmit the head of a packet cut short by a corrupt character
+     * \param p Packet to transmit
+     * \param received Characters received before the corrupt one
+     * \param src Source SpWDevice
+     * \param txTime Line time up to the corrupt character
+     */
+    void TransmitEep(Ptr<const Packet> p, uint32_t received, Ptr<SpWDevice> src, Time txTime);
+
     bool TransmitComplete(Ptr<const Packet> p, Ptr<SpWDevice> src, Time txTime);
     void HandlingArrivedComplete(Ptr<const Packet> p,
                                      Address src,
                                      uint8_t seq_n,
-                                     bool isAck,
+                                     uint8_t flags,
                                      uint32_t ch_packet_seq_n,
                                      bool isReceiption);
 
@@ -114,18 +131,62 @@ class SpWChannel : public Channel
 
     uint32_t GetCntPackets() const;
     uint32_t IncCntPackets();
+
+    /**
+     * \brief Set the time the receivers take for a frame
+     * \param model the model, nullptr to hand frames over as they arrive
+     */
+    void SetProcessingModel(Ptr<SpWProcessingModel> model);
+    Ptr<SpWProcessingModel> GetProcessingModel() const;
+
+    /**
+     * \brief Record the transmissions and receptions of the channel
+     * \param sink the sink, nullptr to stop recording
+     */
+    void SetTraceSink(Ptr<SpWTraceSink> sink);
+    Ptr<SpWTraceSink> GetTraceSink() const;
+
+    /**
+     * \brief The link is reset by caller
+     *
+     * Every packet still on the wires is lost and reported to the device
+     * that sent it, see SpWDevice::SetPacketLostCallback.
+     *
+     * \param caller device that detected the error
+     */
     void NotifyError(Ptr<SpWDevice> caller);
     void NullInLink(Ptr<SpWDevice> caller);
     void FCTInLink(Ptr<SpWDevice> caller);
 
+    /**
+     * \brief Carry a time-code to the peer of caller
+     * \param caller the sending device
+     * \param timeCode the time-code
+     * \param txTime time until its last bit is sent
+     */
+    void TimeCodeInLink(Ptr<SpWDevice> caller, uint8_t timeCode, Time txTime);
+
+    /**
+     * \brief Analytical link start-up, caller has just entered STARTED
+     *
+     * If the peer sends NULLs while caller does, both ends exchange NULL
+     * and then FCT and reach RUN two character delays after the later of
+     * them started. Otherwise nothing is scheduled: the peer completes the
+     * handshake when it starts in turn.
+     *
+     * \param caller the device in STARTED
+     */
+    void StartedInLink(Ptr<SpWDevice> caller);
+
     void PrintTransmitted();
-  protected:
+
     /**
      * \brief Get the delay associated with this channel
      * \returns Time delay
      */
     Time GetDelay() const;
 
+  protected:
     /**
      * \brief Check to make sure the link is initialized
      * \returns true if initialized, asserts otherwise
@@ -165,14 +226,64 @@ class SpWChannel : public Channel
                                           Time duration,
                                           Time lastBitTime);
 
-    void TransmissionComplete(Ptr<const Packet>, Address src, uint8_t seq_n, bool isAck, uint32_t ch_packet_seq_n, bool isReceiption); 
-    void PrintTransmission(Address src, uint8_t seq_n, bool isAck, uint32_t ch_packet_seq_n, bool isReceiption, uint32_t uid) const; 
+    void TransmissionComplete(Ptr<const Packet>, Address src, uint8_t seq_n, uint8_t flags, uint32_t ch_packet_seq_n, bool isReceiption); 
 
 
   private:
     /** Each point to point link has exactly two net devices. */
     static const std::size_t N_DEVICES = 2;
     const Time APPROACH_TIME = NanoSeconds(850); // so-called disconnect timeout window
+    const Time CONTROL_CHAR_DELAY = NanoSeconds(11); // NULL and FCT propagation
+    static const uint32_t NULL_BITS = 8; //!< ESC and FCT
+    static const uint32_t FCT_BITS = 4;  //!< Parity, flag and 2 control bits
+
+    /**
+     * \param src the sending device
+     * \param bits the length of the character
+     * \return time until a start-up character of src is at its peer: at the
+     * start-up rate of src if it has one, CONTROL_CHAR_DELAY otherwise
+     */
+    Time GetControlCharDelay(Ptr<SpWDevice> src, uint32_t bits) const;
+
+    /**
+     * \param p a packet starting with an OST header
+     * \param seq_n set to its OST sequence number
+     * \return its OST flags as SpWTraceRecord::FLAG_ bits
+     */
+    static uint8_t GetTraceFlags(Ptr<const Packet> p, uint8_t& seq_n);
+
+    /**
+     * Record the EEP that ends a packet and hand it to the receiver.
+     *
+     * \param head the characters received before the EEP
+     * \param wire the wire it travels on
+     * \param seq_n its OST sequence number
+     * \param flags its OST flags as SpWTraceRecord::FLAG_ bits
+     * \param ch_packet_seq_n its number on the channel
+     */
+    void EepArrived(Ptr<Packet> head,
+                    uint32_t wire,
+                    uint8_t seq_n,
+                    uint8_t flags,
+                    uint32_t ch_packet_seq_n);
+
+    /**
+     * Record a packet event to the trace sink and the log. Nothing is
+     * formatted unless logging is enabled.
+     *
+     * \param p the packet
+     * \param wire the wire it travels on
+     * \param seq_n its OST sequence number
+     * \param flags its OST flags as SpWTraceRecord::FLAG_ bits
+     * \param ch_packet_seq_n its number on the channel
+     * \param kind the event
+     */
+    void TraceTransmission(Ptr<const Packet> p,
+                           uint32_t wire,
+                           uint8_t seq_n,
+                           uint8_t flags,
+                           uint32_t ch_packet_seq_n,
+                           SpWTraceRecord::Kind kind) const;
 
     Time m_delay;           //!< Propagation delay
     std::size_t m_nDevices; //!< Devices of this channel
@@ -234,9 +345,13 @@ class SpWChannel : public Channel
 
     Link m_link[N_DEVICES]; //!< Link model
     uint32_t m_cnt_packets;
+    Ptr<SpWProcessingModel> m_processingModel; //!< Receiver processing time, may be null
     std::unordered_map<uint32_t, EventId> m_events[2];
+    std::unordered_map<uint32_t, EventId> m_heads[2]; //!< Heads due at cut-through devices by uid
+    std::unordered_map<uint32_t, Ptr<const Packet>> m_inFlight[2]; //!< Packets on the wires by uid
     size_t transmited[2];
     size_t packets[2];
+    Ptr<SpWTraceSink> m_traceSink; //!< Record of the packet events, may be null
 };
 
 } // namespace ns3
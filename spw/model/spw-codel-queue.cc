@@ -0,0 +1,251 @@
+#include "spw-codel-queue.h"
+
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+#include "ns3/queue-size.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/uinteger.h"
+
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SpWCoDelQueue");
+
+NS_OBJECT_ENSURE_REGISTERED(SpWCoDelQueue);
+
+TypeId
+SpWCoDelQueue::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SpWCoDelQueue")
+            .SetParent<Queue<Packet>>()
+            .SetGroupName("PointToPoint")
+            .AddConstructor<SpWCoDelQueue>()
+            .AddAttribute("MaxSize",
+                          "The max queue size",
+                          QueueSizeValue(QueueSize("100p")),
+                          MakeQueueSizeAccessor(&QueueBase::SetMaxSize, &QueueBase::GetMaxSize),
+                          MakeQueueSizeChecker())
+            .AddAttribute("Target",
+                          "Sojourn time the queue keeps to",
+                          TimeValue(MilliSeconds(5)),
+                          MakeTimeAccessor(&SpWCoDelQueue::m_target),
+                          MakeTimeChecker())
+            .AddAttribute("Interval",
+                          "Time the sojourn time may stay above Target before a drop",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&SpWCoDelQueue::m_interval),
+                          MakeTimeChecker())
+            .AddAttribute("MinBytes",
+                          "Nothing is dropped while the queue holds at most this many bytes",
+                          UintegerValue(1500),
+                          MakeUintegerAccessor(&SpWCoDelQueue::m_minBytes),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("UseMark",
+                          "Mark the packets instead of dropping them",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&SpWCoDelQueue::m_useMark),
+                          MakeBooleanChecker())
+            .AddTraceSource("Mark",
+                            "A packet has been marked instead of dropped",
+                            MakeTraceSourceAccessor(&SpWCoDelQueue::m_markTrace),
+                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+SpWCoDelQueue::SpWCoDelQueue()
+    : m_target(MilliSeconds(5)),
+      m_interval(MilliSeconds(100)),
+      m_minBytes(1500),
+      m_useMark(false),
+      m_dropping(false),
+      m_count(0),
+      m_lastCount(0),
+      m_drops(0),
+      m_marks(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SpWCoDelQueue::~SpWCoDelQueue()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+bool
+SpWCoDelQueue::Enqueue(Ptr<Packet> item)
+{
+    NS_LOG_FUNCTION(this << item);
+    if (!DoEnqueue(GetContainer().end(), item))
+    {
+        return false;
+    }
+    m_enqueueTimes.push_back(Simulator::Now());
+    return true;
+}
+
+Ptr<Packet>
+SpWCoDelQueue::Dequeue()
+{
+    NS_LOG_FUNCTION(this);
+    Time now = Simulator::Now();
+    Ptr<Packet> p = DequeueHead(now);
+    bool okToDrop = OkToDrop(p, now);
+
+    if (m_dropping)
+    {
+        if (!okToDrop)
+        {
+            m_dropping = false;
+        }
+        while (m_dropping && now >= m_dropNext)
+        {
+            m_count++;
+            m_dropNext = ControlLaw(m_dropNext);
+            if (m_useMark)
+            {
+                Mark(p);
+                break;
+            }
+            Drop(p);
+            p = DequeueHead(now);
+            if (!OkToDrop(p, now))
+            {
+                m_dropping = false;
+            }
+        }
+    }
+    else if (okToDrop)
+    {
+        // start over from the last drop rate if the previous dropping
+        // state ended recently
+        uint32_t delta = m_count - m_lastCount;
+        m_count = delta > 1 && now - m_dropNext < m_interval * 16 ? delta : 1;
+        m_lastCount = m_count;
+        m_dropNext = ControlLaw(now);
+        m_dropping = true;
+        if (m_useMark)
+        {
+            Mark(p);
+        }
+        else
+        {
+            Drop(p);
+            p = DequeueHead(now);
+            OkToDrop(p, now);
+        }
+    }
+    return p;
+}
+
+Ptr<Packet>
+SpWCoDelQueue::Remove()
+{
+    NS_LOG_FUNCTION(this);
+    Ptr<Packet> p = DoRemove(GetContainer().begin());
+    if (p)
+    {
+        m_enqueueTimes.pop_front();
+    }
+    return p;
+}
+
+Ptr<const Packet>
+SpWCoDelQueue::Peek() const
+{
+    NS_LOG_FUNCTION(this);
+    return DoPeek(GetContainer().begin());
+}
+
+void
+SpWCoDelQueue::SetCongestionCallback(CongestionCallback cb)
+{
+    m_congestionCb = cb;
+}
+
+uint32_t
+SpWCoDelQueue::GetDropCount() const
+{
+    return m_drops;
+}
+
+uint32_t
+SpWCoDelQueue::GetMarkCount() const
+{
+    return m_marks;
+}
+
+Time
+SpWCoDelQueue::GetTarget() const
+{
+    return m_target;
+}
+
+Time
+SpWCoDelQueue::GetInterval() const
+{
+    return m_interval;
+}
+
+Ptr<Packet>
+SpWCoDelQueue::DequeueHead(Time now)
+{
+    Ptr<Packet> p = DoDequeue(GetContainer().begin());
+    if (p)
+    {
+        m_sojourn = now - m_enqueueTimes.front();
+        m_enqueueTimes.pop_front();
+    }
+    return p;
+}
+
+bool
+SpWCoDelQueue::OkToDrop(Ptr<Packet> p, Time now)
+{
+    if (!p || m_sojourn < m_target || GetNBytes() <= m_minBytes)
+    {
+        m_firstAboveTime = Time();
+        return false;
+    }
+    if (m_firstAboveTime.IsZero())
+    {
+        m_firstAboveTime = now + m_interval;
+        return false;
+    }
+    return now >= m_firstAboveTime;
+}
+
+Time
+SpWCoDelQueue::ControlLaw(Time t) const
+{
+    return t + NanoSeconds(m_interval.GetNanoSeconds() / std::sqrt(m_count));
+}
+
+void
+SpWCoDelQueue::Drop(Ptr<Packet> p)
+{
+    NS_LOG_LOGIC("drop after " << m_sojourn.As(Time::MS) << ", count " << m_count);
+    m_drops++;
+    DropAfterDequeue(p);
+    if (!m_congestionCb.IsNull())
+    {
+        m_congestionCb(p, true);
+    }
+}
+
+void
+SpWCoDelQueue::Mark(Ptr<Packet> p)
+{
+    NS_LOG_LOGIC("mark after " << m_sojourn.As(Time::MS) << ", count " << m_count);
+    m_marks++;
+    m_markTrace(p);
+    if (!m_congestionCb.IsNull())
+    {
+        m_congestionCb(p, false);
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,111 @@
+#ifndef SPW_CODEL_QUEUE_H
+#define SPW_CODEL_QUEUE_H
+
+#include "ns3/callback.h"
+#include "ns3/nstime.h"
+#include "ns3/packet.h"
+#include "ns3/queue.h"
+#include "ns3/traced-callback.h"
+
+#include <deque>
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point
+ * \brief Transmit queue of a SpWDevice with CoDel active queue management.
+ *
+ * The sojourn time of a packet is taken when it leaves the queue. Once it
+ * has stayed above Target for a whole Interval the packet at the head is
+ * dropped, or only marked with UseMark, and so are the following ones at
+ * intervals shrinking with the square root of their count (RFC 8289),
+ * until the sojourn time falls below Target again. Nothing is dropped
+ * while the queue holds at most MinBytes.
+ *
+ * Drops and marks are reported to the congestion callback, OstNode uses
+ * it to slow its sockets down.
+ */
+class SpWCoDelQueue : public Queue<Packet>
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SpWCoDelQueue();
+    ~SpWCoDelQueue() override;
+
+    bool Enqueue(Ptr<Packet> item) override;
+    Ptr<Packet> Dequeue() override;
+    Ptr<Packet> Remove() override;
+    Ptr<const Packet> Peek() const override;
+
+    /**
+     * Called for every packet dropped or marked by the queue management,
+     * with true for a drop.
+     */
+    typedef Callback<void, Ptr<const Packet>, bool> CongestionCallback;
+    void SetCongestionCallback(CongestionCallback cb);
+
+    /**
+     * \return packets dropped for their sojourn time, overflows not included
+     */
+    uint32_t GetDropCount() const;
+
+    /**
+     * \return packets marked instead of dropped
+     */
+    uint32_t GetMarkCount() const;
+
+    Time GetTarget() const;
+    Time GetInterval() const;
+
+  private:
+    /**
+     * Take the head of the queue and its sojourn time.
+     *
+     * \param now current time
+     * \return the packet, 0 if the queue is empty
+     */
+    Ptr<Packet> DequeueHead(Time now);
+
+    /**
+     * \param p the packet just taken from the queue
+     * \param now current time
+     * \return true if the sojourn time has been above target for an interval
+     */
+    bool OkToDrop(Ptr<Packet> p, Time now);
+
+    /**
+     * \return time of the next drop after one at t
+     */
+    Time ControlLaw(Time t) const;
+
+    void Drop(Ptr<Packet> p);
+    void Mark(Ptr<Packet> p);
+
+    Time m_target;      //!< Acceptable sojourn time
+    Time m_interval;    //!< Time the sojourn time may stay above target
+    uint32_t m_minBytes; //!< Backlog under which nothing is dropped
+    bool m_useMark;     //!< Mark instead of dropping
+
+    std::deque<Time> m_enqueueTimes; //!< Arrival of the packets in queue order
+    Time m_sojourn;                  //!< Sojourn time of the last packet taken
+    bool m_dropping;                 //!< In the dropping state
+    uint32_t m_count;                //!< Drops since entering the dropping state
+    uint32_t m_lastCount;            //!< m_count when the dropping state was left
+    Time m_firstAboveTime;           //!< When the sojourn time may be acted upon, 0 if below target
+    Time m_dropNext;                 //!< Time of the next drop in the dropping state
+
+    uint32_t m_drops; //!< Packets dropped for their sojourn time
+    uint32_t m_marks; //!< Packets marked
+    CongestionCallback m_congestionCb;
+    TracedCallback<Ptr<const Packet>> m_markTrace; //!< Packet marked
+};
+
+} // namespace ns3
+
+#endif /* SPW_CODEL_QUEUE_H */
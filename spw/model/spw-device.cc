@@ -17,8 +17,12 @@
 
 #include "spw-device.h"
 
+#include "spw-address-tag.h"
 #include "spw-channel.h"
+#include "spw-link-header.h"
 
+#include "ns3/abort.h"
+#include "ns3/boolean.h"
 #include "ns3/error-model.h"
 #include "ns3/llc-snap-header.h"
 #include "ns3/log.h"
@@ -30,6 +34,7 @@
 #include "ns3/trace-source-accessor.h"
 #include "ns3/uinteger.h"
 
+#include <algorithm>
 
 namespace ns3
 {
@@ -54,8 +59,32 @@ SpWDevice::GetTypeId()
             .AddAttribute("DataRate",
                           "The default data rate for point to point links",
                           DataRateValue(DataRate("32768b/s")),
-                          MakeDataRateAccessor(&SpWDevice::m_bps),
+                          MakeDataRateAccessor(&SpWDevice::SetDataRate, &SpWDevice::GetDataRate),
                           MakeDataRateChecker())
+            .AddAttribute("StartupDataRate",
+                          "Rate of the NULLs and FCTs of the link start-up, "
+                          "0 for the fixed character delay of the channel",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&SpWDevice::SetStartupDataRate,
+                                               &SpWDevice::GetStartupDataRate),
+                          MakeDataRateChecker())
+            .AddAttribute("FallbackErrors",
+                          "Link resets for a parity error within FallbackWindow "
+                          "that halve the data rate, 0 to keep the rate",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&SpWDevice::m_fallbackErrors),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("FallbackWindow",
+                          "Time the link resets that halve the data rate fall in",
+                          TimeValue(Seconds(1)),
+                          MakeTimeAccessor(&SpWDevice::m_fallbackWindow),
+                          MakeTimeChecker())
+            .AddAttribute("FallbackCleanPeriod",
+                          "Time without a parity error after which a reduced "
+                          "data rate is doubled, up to DataRate",
+                          TimeValue(Seconds(10)),
+                          MakeTimeAccessor(&SpWDevice::m_fallbackCleanPeriod),
+                          MakeTimeChecker())
             .AddAttribute("ReceiveErrorModel",
                           "The receiver error model used to simulate spw character parity errors",
                           PointerValue(),
@@ -66,6 +95,23 @@ SpWDevice::GetTypeId()
                           TimeValue(Seconds(0.0)),
                           MakeTimeAccessor(&SpWDevice::m_tInterframeGap),
                           MakeTimeChecker())
+            .AddAttribute("RxBufferSize",
+                          "Receive buffer in N-chars; one FCT grants 8 of them",
+                          UintegerValue(SpWCreditModel::MAX_CREDIT),
+                          MakeUintegerAccessor(&SpWDevice::m_rxBufferSize),
+                          MakeUintegerChecker<uint32_t>(SpWCreditModel::FCT_CHARS))
+            .AddAttribute("RxReadRate",
+                          "Rate at which the host reads the receive buffer, "
+                          "0 if it keeps up with the link",
+                          DataRateValue(DataRate(0)),
+                          MakeDataRateAccessor(&SpWDevice::m_rxReadRate),
+                          MakeDataRateChecker())
+            .AddAttribute("AnalyticalHandshake",
+                          "Compute when the link start-up reaches RUN instead of "
+                          "exchanging every NULL and FCT character",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&SpWDevice::m_analyticalHandshake),
+                          MakeBooleanChecker())
 
             //
             // Transmit queueing discipline for the device which includes its own set
@@ -76,6 +122,11 @@ SpWDevice::GetTypeId()
                           PointerValue(),
                           MakePointerAccessor(&SpWDevice::m_queue),
                           MakePointerChecker<Queue<Packet>>())
+            .AddAttribute("ControlTxQueue",
+                          "A queue for the frames without data, served first.",
+                          PointerValue(),
+                          MakePointerAccessor(&SpWDevice::m_controlQueue),
+                          MakePointerChecker<Queue<Packet>>())
 
             //
             // Trace sources at the "top" of the net device, where packets transition
@@ -150,11 +201,18 @@ SpWDevice::GetTypeId()
                             "dropped by the device during reception",
                             MakeTraceSourceAccessor(&SpWDevice::m_phyRxDropTrace),
                             "ns3::Packet::TracedCallback")
+            .AddTraceSource("RxEep",
+                            "Trace source indicating a packet ended by an EEP "
+                            "after a corrupt character, with the characters "
+                            "received before it",
+                            MakeTraceSourceAccessor(&SpWDevice::m_rxEepTrace),
+                            "ns3::Packet::TracedCallback")
 
             //
             // Trace sources designed to simulate a packet sniffer facility (tcpdump).
             // Note that there is really no difference between promiscuous and
-            // non-promiscuous traces in a point-to-point link.
+            // non-promiscuous traces in a point-to-point link. The packets
+            // start with a SpWLinkHeader.
             //
             .AddTraceSource("Sniffer",
                             "Trace source simulating a non-promiscuous packet sniffer "
@@ -165,14 +223,40 @@ SpWDevice::GetTypeId()
                             "Trace source simulating a promiscuous packet sniffer "
                             "attached to the device",
                             MakeTraceSourceAccessor(&SpWDevice::m_promiscSnifferTrace),
-                            "ns3::Packet::TracedCallback");
+                            "ns3::Packet::TracedCallback")
+            .AddTraceSource("CreditStarvation",
+                            "A packet waits for flow control credit, "
+                            "with the time it waits",
+                            MakeTraceSourceAccessor(&SpWDevice::m_creditStarvationTrace),
+                            "ns3::SpWDevice::CreditStarvationCallback")
+            .AddTraceSource("TimeCode",
+                            "A time-code advances the time counter, "
+                            "with the new value",
+                            MakeTraceSourceAccessor(&SpWDevice::m_timeCodeTrace),
+                            "ns3::TracedValueCallback::Uint8")
+            .AddTraceSource("DataRateChange",
+                            "The data rate changes, with the old and the new rate",
+                            MakeTraceSourceAccessor(&SpWDevice::m_dataRateChangeTrace),
+                            "ns3::SpWDevice::DataRateChangeCallback");
     return tid;
 }
 
 SpWDevice::SpWDevice()
     : m_machineState(DOWN),
+      m_bps(DataRate("32768b/s")),
+      m_runRate(DataRate("32768b/s")),
+      m_startupRate(0),
+      m_fallbackErrors(0),
+      m_fallbackWindow(Seconds(1)),
+      m_fallbackCleanPeriod(Seconds(10)),
       m_channel(nullptr),
       m_linkUp(false),
+      m_analyticalHandshake(false),
+      m_rxBufferSize(SpWCreditModel::MAX_CREDIT),
+      m_rxReadRate(0),
+      m_rxChars(0),
+      m_fctsSent(0),
+      m_timeCode(0),
       m_currentPkt(nullptr),
       transmit_complete_events(std::unordered_map<uint64_t, EventId>())
 {
@@ -212,16 +296,134 @@ SpWDevice::DoDispose()
     m_characterParityErrorModel = nullptr;
     m_currentPkt = nullptr;
     m_queue = nullptr;
+    m_controlQueue = nullptr;
+    Simulator::Cancel(m_rateUpEvent);
     NetDevice::DoDispose();
 }
 
 void
 SpWDevice::SetDataRate(DataRate bps)
 {
-    NS_LOG_FUNCTION(this);
+    NS_LOG_FUNCTION(this << bps);
+    m_runRate = bps;
+    Simulator::Cancel(m_rateUpEvent);
+    m_errorResets.clear();
+    ChangeDataRate(bps);
+}
+
+DataRate
+SpWDevice::GetDataRate() const
+{
+    return m_runRate;
+}
+
+void
+SpWDevice::ChangeDataRate(DataRate bps)
+{
+    NS_LOG_FUNCTION(this << bps);
+    if (bps == m_bps)
+    {
+        return;
+    }
+    NS_LOG_INFO("SPW[" << std::to_string(address) << "] data rate " << m_bps << " -> " << bps);
+    UpdateRateTime();
+    m_dataRateChangeTrace(m_bps, bps);
     m_bps = bps;
 }
 
+DataRate
+SpWDevice::GetCurrentDataRate() const
+{
+    return m_bps;
+}
+
+void
+SpWDevice::SetStartupDataRate(DataRate bps)
+{
+    NS_LOG_FUNCTION(this << bps);
+    m_startupRate = bps;
+}
+
+DataRate
+SpWDevice::GetStartupDataRate() const
+{
+    return m_startupRate;
+}
+
+void
+SpWDevice::SetRateFallback(uint32_t errors, Time window, Time cleanPeriod)
+{
+    NS_LOG_FUNCTION(this << errors << window << cleanPeriod);
+    m_fallbackErrors = errors;
+    m_fallbackWindow = window;
+    m_fallbackCleanPeriod = cleanPeriod;
+}
+
+std::map<uint64_t, SpWRateStats>
+SpWDevice::GetRateStats() const
+{
+    std::map<uint64_t, SpWRateStats> stats = m_rateStats;
+    if (Simulator::Now() > m_rateSince)
+    {
+        stats[m_bps.GetBitRate()].time += Simulator::Now() - m_rateSince;
+    }
+    return stats;
+}
+
+void
+SpWDevice::UpdateRateTime()
+{
+    Time now = Simulator::Now();
+    if (now > m_rateSince)
+    {
+        m_rateStats[m_bps.GetBitRate()].time += now - m_rateSince;
+    }
+    m_rateSince = now;
+}
+
+void
+SpWDevice::ParityErrorReset()
+{
+    NS_LOG_FUNCTION(this);
+    m_rateStats[m_bps.GetBitRate()].errorResets++;
+    if (m_fallbackErrors == 0)
+    {
+        return;
+    }
+
+    Time now = Simulator::Now();
+    m_errorResets.push_back(now);
+    while (m_errorResets.front() + m_fallbackWindow < now)
+    {
+        m_errorResets.pop_front();
+    }
+    // never below the start-up rate, the link comes up at it anyway
+    uint64_t floor = m_startupRate.GetBitRate() ? m_startupRate.GetBitRate() : 10000000;
+    floor = std::min(floor, m_runRate.GetBitRate());
+    if (m_errorResets.size() >= m_fallbackErrors && m_bps.GetBitRate() > floor)
+    {
+        m_errorResets.clear();
+        ChangeDataRate(DataRate(std::max(m_bps.GetBitRate() / 2, floor)));
+    }
+
+    Simulator::Cancel(m_rateUpEvent);
+    if (m_bps.GetBitRate() < m_runRate.GetBitRate())
+    {
+        m_rateUpEvent = Simulator::Schedule(m_fallbackCleanPeriod, &SpWDevice::StepRateUp, this);
+    }
+}
+
+void
+SpWDevice::StepRateUp()
+{
+    NS_LOG_FUNCTION(this);
+    ChangeDataRate(DataRate(std::min(m_bps.GetBitRate() * 2, m_runRate.GetBitRate())));
+    if (m_bps.GetBitRate() < m_runRate.GetBitRate())
+    {
+        m_rateUpEvent = Simulator::Schedule(m_fallbackCleanPeriod, &SpWDevice::StepRateUp, this);
+    }
+}
+
 void
 SpWDevice::SetInterframeGap(Time t)
 {
@@ -240,8 +442,59 @@ SpWDevice::TransmitStart(Ptr<Packet> p)
     m_currentPkt = p;
     m_phyTxBeginTrace(m_currentPkt);
 
-    Time txTime = m_bps.CalculateBytesTxTime(p->GetSize());
-    Time txCompleteTime = txTime;
+    // FCTs for the N-chars received meanwhile go out ahead of the packet
+    uint64_t fcts = m_rxChars / SpWCreditModel::FCT_CHARS - m_fctsSent;
+    m_fctsSent += fcts;
+    Time fctTime = m_bps.CalculateBitsTxTime(fcts * CONTROL_CHAR_BITS);
+
+    // the address characters in front of a routed packet take line time too
+    uint32_t addressChars = 0;
+    SpWAddressTag addressTag;
+    if (p->PeekPacketTag(addressTag))
+    {
+        addressChars = addressTag.GetChars();
+    }
+    uint32_t size = p->GetSize() + addressChars;
+
+    // with a character error model at the peer the packet stops at its
+    // first corrupt character: one of the size characters or the EOP
+    uint32_t errorAt = size + 1;
+    Ptr<SpWCharacterErrorModel> em = GetPeer()->GetCharacterErrorModel();
+    if (em)
+    {
+        errorAt = em->GetErrorPosition(errorAt);
+    }
+
+    Time txTime = fctTime + GetLineTime(size);
+    Time stalled = m_txCredit.Transmit(Simulator::Now() + fctTime,
+                                       size,
+                                       m_bps.CalculateBitsTxTime(DATA_CHAR_BITS),
+                                       m_bps.CalculateBitsTxTime(CONTROL_CHAR_BITS));
+    if (stalled.IsStrictlyPositive())
+    {
+        m_creditStarvation += stalled;
+        m_creditStarvationTrace(p, stalled);
+        txTime += stalled;
+    }
+    if (m_tailAt > Simulator::Now())
+    {
+        // cut-through: the EOP goes out after it came in
+        txTime = Max(txTime,
+                     m_tailAt - Simulator::Now() + m_bps.CalculateBitsTxTime(CONTROL_CHAR_BITS));
+    }
+    m_tailAt = Time();
+    Time txCompleteTime = txTime + m_tInterframeGap;
+    // data characters the receiver has before the EEP
+    uint32_t received = p->GetSize();
+    if (errorAt < size)
+    {
+        // the receiver stops at the corrupt character, the transmitter
+        // carries on until the reset reaches it
+        txTime = fctTime + stalled + m_bps.CalculateBitsTxTime((errorAt + 1) * DATA_CHAR_BITS);
+        received = errorAt > addressChars ? errorAt - addressChars : 0;
+    }
+    // errorAt == size is a corrupt EOP: the whole packet is in, the EEP
+    // takes the place of the EOP at the end of the line time
 
     OstHeader header;
     p->PeekHeader(header);
@@ -253,6 +506,12 @@ SpWDevice::TransmitStart(Ptr<Packet> p)
     transmit_complete_events[p->GetUid()] = event;
     NS_LOG_LOGIC("SPW[" << std::to_string(address) <<"] start transmitting | uid " << std::to_string(event.GetUid()));
 
+    if (errorAt <= size)
+    {
+        m_channel->TransmitEep(p, received, this, txTime);
+        return true;
+    }
+
     bool result = m_channel->TransmitStart(p, this, txTime);
     if (!result)
     {
@@ -281,11 +540,18 @@ SpWDevice::TransmitComplete(uint64_t uint)
 
     transmit_complete_events.erase(uint);
 
+    SpWRateStats& stats = m_rateStats[m_bps.GetBitRate()];
+    stats.bytes += m_currentPkt->GetSize();
+    stats.packets++;
 
     m_phyTxEndTrace(m_currentPkt);
+    if (!packet_sent_cb.IsNull())
+    {
+        packet_sent_cb(m_currentPkt);
+    }
     m_currentPkt = nullptr;
 
-    Ptr<Packet> p = m_queue->Dequeue();
+    Ptr<Packet> p = DequeueNext();
     if (!p)
     {
         NS_LOG_LOGIC("No pending packets in device queue after tx complete");
@@ -296,8 +562,7 @@ SpWDevice::TransmitComplete(uint64_t uint)
     //
     // Got another packet off of the queue, so start the transmit process again.
     //
-    m_snifferTrace(p);
-    m_promiscSnifferTrace(p);
+    Sniff(p, 0);
     TransmitStart(p);
 }
 
@@ -326,6 +591,13 @@ SpWDevice::SetQueue(Ptr<Queue<Packet>> q)
     m_queue = q;
 }
 
+void
+SpWDevice::SetControlQueue(Ptr<Queue<Packet>> q)
+{
+    NS_LOG_FUNCTION(this << q);
+    m_controlQueue = q;
+}
+
 void
 SpWDevice::SetCharacterParityErrorModel(Ptr<ErrorModel> em)
 {
@@ -333,16 +605,36 @@ SpWDevice::SetCharacterParityErrorModel(Ptr<ErrorModel> em)
     m_characterParityErrorModel = em;
 }
 
+void
+SpWDevice::ReceiveEep(Ptr<Packet> packet)
+{
+    NS_LOG_FUNCTION(this << packet);
+    m_rxEepTrace(packet);
+    Sniff(packet, SpWLinkHeader::FLAG_RECEIVED | SpWLinkHeader::FLAG_EEP);
+    m_phyRxDropTrace(packet);
+    NS_LOG_INFO("SPW[" << std::to_string(address) << "] EEP after " << packet->GetSize() << " characters. Reconnecting.");
+    ParityErrorReset();
+    GetPeer()->ParityErrorReset();
+    m_channel->NotifyError(this);
+    ErrorResetSpWState();
+}
+
 void
 SpWDevice::Receive(Ptr<Packet> packet, uint32_t ch_packet_seq_n)
 {
     NS_LOG_FUNCTION(this << packet);
     uint16_t protocol = 0;
 
-    if (m_characterParityErrorModel && m_characterParityErrorModel->IsCorrupt(packet))
+    // characters are checked by the transmitter, see TransmitStart
+    if (m_characterParityErrorModel && !GetCharacterErrorModel() &&
+        m_characterParityErrorModel->IsCorrupt(packet))
     {
         m_phyRxDropTrace(packet);
         NS_LOG_INFO("SPW[" << std::to_string(address) << "] detected error. Reconnecting. planned to complete transmission: " << std::to_string(transmit_complete_events.size()));
+        // the corrupt packet has left the channel, the others are lost with the link
+        GetPeer()->NotifyPacketLost(packet);
+        ParityErrorReset();
+        GetPeer()->ParityErrorReset();
         m_channel->NotifyError(this);
         ErrorResetSpWState();
     }
@@ -353,8 +645,8 @@ SpWDevice::Receive(Ptr<Packet> packet, uint32_t ch_packet_seq_n)
         // device because it is so simple, but this is not usually the case in
         // more complicated devices.
         //
-        m_snifferTrace(packet);
-        m_promiscSnifferTrace(packet);
+        m_rxChars += packet->GetSize() + 1; // EOP
+        Sniff(packet, SpWLinkHeader::FLAG_RECEIVED);
         m_phyRxEndTrace(packet);
 
         //
@@ -387,6 +679,130 @@ SpWDevice::Receive(Ptr<Packet> packet, uint32_t ch_packet_seq_n)
     }
 }
 
+void
+SpWDevice::SetHeadReceiveCallback(HeadReceiveCallback cb)
+{
+    m_headRxCallback = cb;
+}
+
+bool
+SpWDevice::IsCutThrough() const
+{
+    return !m_headRxCallback.IsNull();
+}
+
+void
+SpWDevice::ReceiveHead(Ptr<Packet> packet, Time tail)
+{
+    NS_LOG_FUNCTION(this << packet << tail);
+    m_rxChars += packet->GetSize() + 1; // EOP
+    Sniff(packet, SpWLinkHeader::FLAG_RECEIVED);
+    m_phyRxEndTrace(packet);
+    m_headRxCallback(this, packet, tail);
+}
+
+bool
+SpWDevice::SendCutThrough(Ptr<Packet> packet, Time tail)
+{
+    NS_LOG_FUNCTION(this << packet << tail);
+    NS_ASSERT_MSG(m_machineState == RUN, "Must be RUN to switch a packet");
+    m_tailAt = tail;
+    return Send(packet, GetRemote(), 0);
+}
+
+void
+SpWDevice::SetTimeCodeCallback(TimeCodeCallback cb)
+{
+    m_timeCodeCallback = cb;
+}
+
+void
+SpWDevice::TickIn()
+{
+    NS_LOG_FUNCTION(this);
+    SendTimeCode((m_timeCode + 1) % TIME_CODES);
+    m_timeCodeTrace(m_timeCode);
+    if (!m_timeCodeCallback.IsNull())
+    {
+        m_timeCodeCallback(this, m_timeCode);
+    }
+}
+
+void
+SpWDevice::SendTimeCode(uint8_t timeCode)
+{
+    NS_LOG_FUNCTION(this << +timeCode);
+    m_timeCode = timeCode % TIME_CODES;
+    if (m_machineState != RUN && m_machineState != BUSY)
+    {
+        return;
+    }
+    // time-codes go out between characters, ahead of the rest of a packet
+    Time txTime = m_bps.CalculateBitsTxTime(TIME_CODE_BITS);
+    if (m_machineState == BUSY)
+    {
+        txTime += m_bps.CalculateBitsTxTime(DATA_CHAR_BITS);
+    }
+    m_channel->TimeCodeInLink(this, m_timeCode, txTime);
+}
+
+void
+SpWDevice::ReceiveTimeCode(uint8_t timeCode)
+{
+    NS_LOG_FUNCTION(this << +timeCode);
+    if (m_machineState != RUN && m_machineState != BUSY)
+    {
+        return;
+    }
+    bool tick = timeCode == (m_timeCode + 1) % TIME_CODES;
+    m_timeCode = timeCode;
+    if (!tick)
+    {
+        NS_LOG_LOGIC("SPW[" << std::to_string(address) << "] time-code " << +timeCode << " out of sequence");
+        return;
+    }
+    m_timeCodeTrace(m_timeCode);
+    if (!m_timeCodeCallback.IsNull())
+    {
+        m_timeCodeCallback(this, m_timeCode);
+    }
+}
+
+uint8_t
+SpWDevice::GetTimeCode() const
+{
+    return m_timeCode;
+}
+
+void
+SpWDevice::SetPath(uint8_t dst, const std::vector<uint8_t>& path)
+{
+    NS_LOG_FUNCTION(this << +dst);
+    NS_ABORT_MSG_IF(path.size() > SpWAddressTag::MAX_PATH,
+                    "Path to " << +dst << " longer than " << +SpWAddressTag::MAX_PATH);
+    m_paths[dst] = path;
+}
+
+void
+SpWDevice::AddAddress(Ptr<Packet> packet, const Address& dest) const
+{
+    if (m_paths.empty() && !GetPeer()->IsCutThrough())
+    {
+        return;
+    }
+    SpWAddressTag tag;
+    if (packet->PeekPacketTag(tag))
+    {
+        // switched by a router, already addressed
+        return;
+    }
+    uint8_t dst;
+    Mac8Address::ConvertFrom(dest).CopyTo(&dst);
+    auto it = m_paths.find(dst);
+    packet->AddPacketTag(
+        SpWAddressTag(it == m_paths.end() ? std::vector<uint8_t>() : it->second, dst));
+}
+
 Ptr<Queue<Packet>>
 SpWDevice::GetQueue() const
 {
@@ -394,6 +810,13 @@ SpWDevice::GetQueue() const
     return m_queue;
 }
 
+Ptr<Queue<Packet>>
+SpWDevice::GetControlQueue() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_controlQueue;
+}
+
 void
 SpWDevice::NotifyLinkUp()
 {
@@ -545,20 +968,21 @@ SpWDevice::Send(Ptr<Packet> packet, const Address& dest, uint16_t protocolNumber
     m_macTxTrace(packet);
 
     // packet->AddHeader(seqTs);
+    AddAddress(packet, dest);
 
     //
     // We should enqueue and dequeue the packet to hit the tracing hooks.
     //
-    if (m_queue->Enqueue(packet))
+    Ptr<Queue<Packet>> queue = IsControlFrame(packet) ? m_controlQueue : m_queue;
+    if (queue->Enqueue(packet))
     {
         //
         // If the channel is ready for transition we send the packet right now
         //
         if (m_machineState == RUN)
         {
-            packet = m_queue->Dequeue();
-            m_snifferTrace(packet);
-            m_promiscSnifferTrace(packet);
+            packet = DequeueNext();
+            Sniff(packet, 0);
             bool ret = TransmitStart(packet);
             return ret;
         }
@@ -578,11 +1002,14 @@ SpWDevice::CheckQueue()
         // m_queue->Flush();
         return;
     }
-    if (m_machineState == RUN && !m_queue->IsEmpty())
+    if (m_machineState != RUN)
     {
-        Ptr<Packet> packet = m_queue->Dequeue();
-        m_snifferTrace(packet);
-        m_promiscSnifferTrace(packet);
+        return;
+    }
+    Ptr<Packet> packet = DequeueNext();
+    if (packet)
+    {
+        Sniff(packet, 0);
         TransmitStart(packet);
     }
     return;
@@ -592,6 +1019,7 @@ void
 SpWDevice::ErrorResetSpWState()
 {
     NS_LOG_LOGIC("SPW[" << std::to_string(address) <<"] ERROR_RESET");
+    bool wasRunning = m_machineState == RUN || m_machineState == BUSY;
     m_machineState = ERROR_RESET;
     for (auto& it: transmit_complete_events) {
         NS_LOG_LOGIC("SPW[" << std::to_string(address) <<"] canceling receive | uid " << std::to_string(it.second.GetUid()));
@@ -600,8 +1028,20 @@ SpWDevice::ErrorResetSpWState()
     transmit_complete_events.clear();
     Simulator::Cancel(sendNull);
     Simulator::Cancel(sendFCT);
+    if (!linkUpEvent.IsExpired())
+    {
+        // the peer stops hearing from us in the middle of the handshake
+        Simulator::Cancel(linkUpEvent);
+        m_channel->NotifyError(this);
+    }
 
-    Simulator::Schedule(SPW_HALF_DELAY, &SpWDevice::ErrorWaitSpWState, this);
+    // a reset while the previous one is under way starts it over
+    Simulator::Cancel(resetEvent);
+    resetEvent = Simulator::Schedule(SPW_HALF_DELAY, &SpWDevice::ErrorWaitSpWState, this);
+    if (wasRunning)
+    {
+        m_linkChangeCallbacks();
+    }
 }
 
 void
@@ -609,7 +1049,7 @@ SpWDevice::ErrorWaitSpWState()
 {
     NS_LOG_LOGIC("SPW[" << std::to_string(address) <<"] ERROR_WAIT");
     m_machineState = ERROR_WAIT;
-    Simulator::Schedule(SPW_DELAY, &SpWDevice::ReadySpWState, this);
+    resetEvent = Simulator::Schedule(SPW_DELAY, &SpWDevice::ReadySpWState, this);
 }
 
 void
@@ -626,6 +1066,14 @@ SpWDevice::StartedSpWState()
     NS_LOG_LOGIC("SPW[" << std::to_string(address) <<"] STARTED");
     m_machineState = STARTED;
     Simulator::Cancel(stateChangeToErrorResetEventId);
+    if (m_analyticalHandshake)
+    {
+        // no timeout: while unanswered the device is taken to cycle through
+        // the reset states, see GetNextStartedTime
+        m_startedAt = Simulator::Now();
+        m_channel->StartedInLink(this);
+        return;
+    }
     stateChangeToErrorResetEventId = Simulator::Schedule(SPW_DELAY, &SpWDevice::ErrorResetSpWState, this);
     sendNull = Simulator::ScheduleNow(&SpWDevice::SendNull, this);
 }
@@ -640,6 +1088,36 @@ SpWDevice::ConnectingSpWState()
     sendFCT = Simulator::ScheduleNow(&SpWDevice::SendFCT, this);
 }
 
+void
+SpWDevice::HandshakeSpWState(Time runDelay)
+{
+    NS_LOG_LOGIC("SPW[" << std::to_string(address) <<"] CONNECTING, RUN in " << runDelay.As(Time::NS));
+    m_machineState = CONNECTING;
+    Simulator::Cancel(stateChangeToErrorResetEventId);
+    Simulator::Cancel(linkUpEvent);
+    linkUpEvent = Simulator::Schedule(runDelay, &SpWDevice::RunSpWState, this);
+}
+
+bool
+SpWDevice::GetNextStartedTime(Time t, Time& at) const
+{
+    if (!m_analyticalHandshake || m_machineState != STARTED || t < m_startedAt)
+    {
+        return false;
+    }
+    int64_t cycle = (SPW_DELAY + SPW_HALF_DELAY + SPW_DELAY).GetNanoSeconds();
+    int64_t phase = (t - m_startedAt).GetNanoSeconds() % cycle;
+    if (phase < SPW_DELAY.GetNanoSeconds())
+    {
+        at = t;
+    }
+    else
+    {
+        at = t + NanoSeconds(cycle - phase);
+    }
+    return true;
+}
+
 void
 SpWDevice::RunSpWState()
 {
@@ -648,26 +1126,75 @@ SpWDevice::RunSpWState()
     Simulator::Cancel(stateChangeToErrorResetEventId);
     Simulator::Cancel(sendFCT);
     Simulator::Cancel(sendNull);
+    ResetCredit();
 
     uint8_t addr;
     m_address.CopyTo(&addr);
     NS_LOG_INFO("SPW[" <<std::to_string(addr) << "] CONNECTED!");
+    m_linkChangeCallbacks();
     device_ready_cb();
     CheckQueue();
 }
 
 
+void
+SpWDevice::ResetCredit()
+{
+    Ptr<SpWDevice> peer = GetPeer();
+    Time fctDelay = peer->m_bps.CalculateBitsTxTime(CONTROL_CHAR_BITS) + m_channel->GetDelay();
+    m_rxChars = 0;
+    m_fctsSent = 0;
+    m_txCredit.Reset(Simulator::Now(),
+                     peer->GetRxBufferSize(),
+                     peer->GetRxReadTime(),
+                     fctDelay,
+                     m_channel->GetDelay());
+}
+
+Time
+SpWDevice::GetLineTime(uint32_t size) const
+{
+    return m_bps.CalculateBitsTxTime(size * DATA_CHAR_BITS + CONTROL_CHAR_BITS);
+}
+
+uint32_t
+SpWDevice::GetRxBufferSize() const
+{
+    return m_rxBufferSize;
+}
+
+Time
+SpWDevice::GetRxReadTime() const
+{
+    if (m_rxReadRate.GetBitRate() == 0)
+    {
+        return Time();
+    }
+    return m_rxReadRate.CalculateBytesTxTime(1);
+}
+
+Time
+SpWDevice::GetCreditStarvationTime() const
+{
+    return m_creditStarvation;
+}
+
 void
 SpWDevice::Shutdown()
 {
+    bool wasRunning = m_machineState == RUN || m_machineState == BUSY;
     m_machineState = DOWN;
+    if (wasRunning)
+    {
+        m_linkChangeCallbacks();
+    }
 }
 
 void SpWDevice::SendNull()
 {
     m_channel->NullInLink(this);
     if (m_machineState != ERROR_RESET) {
-        sendNull = Simulator::Schedule(NanoSeconds(50), &SpWDevice::SendNull, this);
+        sendNull = Simulator::Schedule(SPW_NULL_PERIOD, &SpWDevice::SendNull, this);
     }
 }
 
@@ -688,7 +1215,7 @@ void SpWDevice::SendFCT()
 {
     m_channel->FCTInLink(this);
     if (m_machineState != ERROR_RESET) {
-        sendFCT = Simulator::Schedule(NanoSeconds(50), &SpWDevice::SendFCT, this);
+        sendFCT = Simulator::Schedule(SPW_NULL_PERIOD, &SpWDevice::SendFCT, this);
     }
 }
 
@@ -712,10 +1239,16 @@ SpWDevice::ApproachLinkDisconnection()
     transmit_complete_events.clear();
     Simulator::Cancel(sendFCT);
     Simulator::Cancel(sendNull);
+    Simulator::Cancel(linkUpEvent);
 
+    bool wasRunning = m_machineState == RUN || m_machineState == BUSY;
     m_machineState = ERROR_RESET;
     Simulator::Cancel(stateChangeToErrorResetEventId);
     stateChangeToErrorResetEventId = Simulator::Schedule(EXCHANGE_OF_SILENCE, &SpWDevice::ErrorResetSpWState, this);
+    if (wasRunning)
+    {
+        m_linkChangeCallbacks();
+    }
 }
 
 bool
@@ -777,7 +1310,7 @@ SpWDevice::SetPromiscReceiveCallback(NetDevice::PromiscReceiveCallback cb)
 }
 
 void
-SpWDevice::SetPacketSentCallcback(PacketSentCallback cb)
+SpWDevice::SetPacketSentCallback(PacketSentCallback cb)
 {
     packet_sent_cb = cb;
 }
@@ -788,6 +1321,24 @@ SpWDevice::SetDeviceReadyCallback(DeviceReadyCallback cb)
     device_ready_cb = cb;
 }
 
+void
+SpWDevice::SetPacketLostCallback(PacketLostCallback cb)
+{
+    packet_lost_cb = cb;
+}
+
+void
+SpWDevice::NotifyPacketLost(Ptr<const Packet> p)
+{
+    NS_LOG_FUNCTION(this << p);
+    NS_LOG_LOGIC("SPW[" << std::to_string(address) << "] lost packet uid " << p->GetUid() << " in link reset");
+    m_phyTxDropTrace(p);
+    if (!packet_lost_cb.IsNull())
+    {
+        packet_lost_cb(p);
+    }
+}
+
 bool
 SpWDevice::SupportsSendFrom() const
 {
@@ -795,6 +1346,57 @@ SpWDevice::SupportsSendFrom() const
     return false;
 }
 
+Ptr<SpWCharacterErrorModel>
+SpWDevice::GetCharacterErrorModel() const
+{
+    return DynamicCast<SpWCharacterErrorModel>(m_characterParityErrorModel);
+}
+
+Ptr<SpWDevice>
+SpWDevice::GetPeer() const
+{
+    NS_ASSERT(m_channel->GetNDevices() == 2);
+    Ptr<SpWDevice> dev = m_channel->GetSpWDevice(0);
+    return dev == this ? m_channel->GetSpWDevice(1) : dev;
+}
+
+void
+SpWDevice::Sniff(Ptr<const Packet> packet, uint8_t flags)
+{
+    if (m_snifferTrace.IsEmpty() && m_promiscSnifferTrace.IsEmpty())
+    {
+        return;
+    }
+    uint8_t peer = GetPeer()->address;
+    bool received = flags & SpWLinkHeader::FLAG_RECEIVED;
+    Ptr<Packet> p = packet->Copy();
+    p->AddHeader(SpWLinkHeader(received ? address : peer, received ? peer : address, flags));
+    m_snifferTrace(p);
+    m_promiscSnifferTrace(p);
+}
+
+bool
+SpWDevice::IsControlFrame(Ptr<const Packet> packet) const
+{
+    OstHeader header;
+    if (!m_controlQueue || packet->GetSize() < header.GetSerializedSize())
+    {
+        return false;
+    }
+    packet->PeekHeader(header);
+    return !header.is_dta();
+}
+
+Ptr<Packet>
+SpWDevice::DequeueNext()
+{
+    if (m_controlQueue && !m_controlQueue->IsEmpty())
+    {
+        return m_controlQueue->Dequeue();
+    }
+    return m_queue->Dequeue();
+}
+
 Address
 SpWDevice::GetRemote() const
 {
@@ -18,9 +18,13 @@
 #ifndef SPW_DEVICE_H
 #define SPW_DEVICE_H
 
+#include "spw-error-model.h"
+#include "spw-flow-control.h"
+
 #include "ns3/address.h"
 #include "ns3/callback.h"
 #include "ns3/data-rate.h"
+#include "ns3/deprecated.h"
 #include "ns3/mac8-address.h"
 #include "ns3/net-device.h"
 #include "ns3/node.h"
@@ -31,7 +35,10 @@
 #include "ns3/traced-callback.h"
 
 #include <cstring>
+#include <deque>
+#include <map>
 #include <unordered_map>
+#include <vector>
 
 const uint16_t MAX_SPW_PACKET_SZ = 2000;
 
@@ -51,6 +58,21 @@ class ErrorModel;
  * Be sure to read the manual BEFORE going down to the API.
  */
 
+/**
+ * \ingroup point-to-point
+ * \brief What a SpWDevice did at one data rate.
+ *
+ * The time counts from the rate change, link resets included, so
+ * bytes * 8 / time is the goodput of the rate.
+ */
+struct SpWRateStats
+{
+    Time time;            //!< Time spent at the rate
+    uint64_t bytes;       //!< Bytes of the packets sent completely
+    uint32_t packets;     //!< Packets sent completely
+    uint32_t errorResets; //!< Link resets for a parity error
+};
+
 /**
  * \ingroup point-to-point
  * \class PointToPointNetDevice
@@ -103,6 +125,59 @@ class SpWDevice : public NetDevice
      */
     void SetDataRate(DataRate bps);
 
+    /**
+     * \return the run rate, as set with SetDataRate
+     */
+    DataRate GetDataRate() const;
+
+    /**
+     * Change the rate of the link without a reset, as the run rate does
+     * when the rate falls back. The packet on the wire keeps its rate, the
+     * next one goes at the new rate. The run rate stays the ceiling of the
+     * fallback policy.
+     *
+     * \param bps the new data rate
+     */
+    void ChangeDataRate(DataRate bps);
+
+    /**
+     * \return the rate packets are sent at now
+     */
+    DataRate GetCurrentDataRate() const;
+
+    /**
+     * \param bps rate of the NULLs and FCTs of the link start-up, 0 to
+     * use the fixed character delay of the channel
+     */
+    void SetStartupDataRate(DataRate bps);
+    DataRate GetStartupDataRate() const;
+
+    /**
+     * Step the rate down after parity errors and back up once the link is
+     * clean. Both ends count the link resets for a parity error, so they
+     * change rate together.
+     *
+     * \param errors resets within window that halve the rate, down to the
+     * start-up rate or 10 Mbps; 0 keeps the rate
+     * \param window time the resets must fall in
+     * \param cleanPeriod time without a reset that doubles the rate, up to
+     * the run rate
+     */
+    void SetRateFallback(uint32_t errors, Time window, Time cleanPeriod);
+
+    /**
+     * \return what the device did at each rate, by bit rate
+     */
+    std::map<uint64_t, SpWRateStats> GetRateStats() const;
+
+    /**
+     * TracedCallback signature for the DataRateChange trace source.
+     *
+     * \param [in] oldRate The rate before.
+     * \param [in] newRate The rate from now on.
+     */
+    typedef void (*DataRateChangeCallback)(DataRate oldRate, DataRate newRate);
+
     /**
      * Set the interframe gap used to separate packets.  The interframe gap
      * defines the minimum space required between packets sent by this device.
@@ -123,7 +198,8 @@ class SpWDevice : public NetDevice
      * Attach a queue to the PointToPointNetDevice.
      *
      * The PointToPointNetDevice "owns" a queue that implements a queueing
-     * method such as DropTailQueue or RedQueue
+     * method such as DropTailQueue or RedQueue, SpWCoDelQueue bounds the
+     * time packets wait in it
      *
      * \param queue Ptr to the new queue.
      */
@@ -136,6 +212,23 @@ class SpWDevice : public NetDevice
      */
     Ptr<Queue<Packet>> GetQueue() const;
 
+    /**
+     * Attach a queue for control frames.
+     *
+     * OST frames that carry no data (ACK, SYN, RST) go to this queue and
+     * are sent before anything in the transmit queue, so they do not wait
+     * behind full size data frames. Without it every frame shares the
+     * transmit queue.
+     *
+     * \param queue Ptr to the new queue.
+     */
+    void SetControlQueue(Ptr<Queue<Packet>> queue);
+
+    /**
+     * \returns the queue of the control frames, 0 if there is none
+     */
+    Ptr<Queue<Packet>> GetControlQueue() const;
+
     /**
      * Attach a receive ErrorModel to the SpW device.
      *
@@ -158,6 +251,106 @@ class SpWDevice : public NetDevice
      */
     void Receive(Ptr<Packet> p, uint32_t cnt);
 
+    /**
+     * Receive the head of a packet ended by an EEP.
+     *
+     * Used by the channel when a character of the packet is corrupt: the
+     * characters before it are handed to the RxEep trace and the link is
+     * reset as for any parity error.
+     *
+     * \param p the characters received before the corrupt one
+     */
+    void ReceiveEep(Ptr<Packet> p);
+
+    /**
+     * Called with the head of every packet received by a device that
+     * switches packets as their address comes in, see
+     * SetHeadReceiveCallback.
+     */
+    typedef Callback<void, Ptr<SpWDevice>, Ptr<Packet>, Time> HeadReceiveCallback;
+
+    /**
+     * Take packets as soon as their address characters are in, instead of
+     * when their EOP is, as a SpaceWire router port does. The callback
+     * gets the device, the packet and the time its EOP arrives; the
+     * receive callback is not called any more.
+     *
+     * \param cb the callback, null to receive whole packets again
+     */
+    void SetHeadReceiveCallback(HeadReceiveCallback cb);
+
+    /**
+     * \returns true if the device takes packets at their head
+     */
+    bool IsCutThrough() const;
+
+    /**
+     * Receive the head of a packet from the channel, cut-through devices
+     * only.
+     *
+     * \param p the packet
+     * \param tail time its EOP arrives
+     */
+    void ReceiveHead(Ptr<Packet> p, Time tail);
+
+    /**
+     * Start sending a packet that is still being received, the device
+     * must be ready to transmit. The transmission does not end before the
+     * EOP has arrived.
+     *
+     * \param p the packet
+     * \param tail time its EOP arrives
+     * \return true if the transmission started
+     */
+    bool SendCutThrough(Ptr<Packet> p, Time tail);
+
+    /**
+     * Set the path address of a node behind SpaceWire routers.
+     *
+     * Packets sent to dst carry a SpWAddressTag with the path in front of
+     * the logical address dst. Packets to nodes without a path carry the
+     * logical address alone if the peer is a router, see IsCutThrough, and
+     * no address otherwise.
+     *
+     * \param dst the logical address of the node
+     * \param path output port of every router on the way, first router first
+     */
+    void SetPath(uint8_t dst, const std::vector<uint8_t>& path);
+
+    /**
+     * Called with every time-code that advances the time counter of the
+     * device by one, sent with TickIn or received (TICK_OUT).
+     */
+    typedef Callback<void, Ptr<SpWDevice>, uint8_t> TimeCodeCallback;
+    void SetTimeCodeCallback(TimeCodeCallback cb);
+
+    /**
+     * Time master: advance the time counter and send it to the peer
+     * (TICK_IN). The time-code goes out after the character on the wire.
+     */
+    void TickIn();
+
+    /**
+     * Set the time counter and send it to the peer, as a router does with
+     * a time-code it distributes. The callback is not called.
+     *
+     * \param timeCode the time-code, 0 to 63
+     */
+    void SendTimeCode(uint8_t timeCode);
+
+    /**
+     * Receive a time-code from the channel. Only a time-code one more than
+     * the time counter is a tick, any other one just sets the counter.
+     *
+     * \param timeCode the time-code
+     */
+    void ReceiveTimeCode(uint8_t timeCode);
+
+    /**
+     * \returns the time counter, 0 to 63
+     */
+    uint8_t GetTimeCode() const;
+
     // The remaining methods are documented in ns3::NetDevice*
 
     void SetIfIndex(const uint32_t index) override;
@@ -174,6 +367,13 @@ class SpWDevice : public NetDevice
 
     bool IsLinkUp() const override;
 
+    /**
+     * The callbacks are also called when the link enters RUN and when it
+     * leaves RUN or BUSY for a reset or a shutdown, IsReadyToTransmit tells
+     * which.
+     *
+     * \param callback the callback to invoke
+     */
     void AddLinkChangeCallback(Callback<void> callback) override;
 
     bool IsBroadcast() const override;
@@ -220,26 +420,123 @@ class SpWDevice : public NetDevice
     void ConnectingSpWState();
     void RunSpWState();
 
-    typedef Callback<void> PacketSentCallback;
-    void SetPacketSentCallcback(SpWDevice::PacketSentCallback cb);
+    /**
+     * Analytical handshake: go CONNECTING and reach RUN after runDelay,
+     * without exchanging NULL and FCT characters.
+     *
+     * \param runDelay time until both ends of the link are in RUN
+     */
+    void HandshakeSpWState(Time runDelay);
+
+    /**
+     * Earliest time from t on at which this device sends NULLs while it
+     * waits in STARTED for its peer (analytical handshake only).
+     *
+     * An unanswered device times out after SPW_DELAY and is STARTED again
+     * SPW_HALF_DELAY + SPW_DELAY later, so its NULLs come in windows of
+     * SPW_DELAY repeating every cycle from the time it first started.
+     *
+     * \param t the time from which to look
+     * \param at set to the earliest time the device sends NULLs
+     * \return false if the device is not waiting for its peer
+     */
+    bool GetNextStartedTime(Time t, Time& at) const;
+
+    /**
+     * \brief Line time of a packet
+     *
+     * Data characters are 10 bits long, the EOP that ends the packet 4 bits.
+     *
+     * \param size data characters in the packet
+     * \return time to send the packet and its EOP at the current data rate
+     */
+    Time GetLineTime(uint32_t size) const;
+
+    /**
+     * \return receive buffer in N-chars, the credit this device grants
+     */
+    uint32_t GetRxBufferSize() const;
+
+    /**
+     * \return time the receiver takes to read one N-char out of its buffer
+     */
+    Time GetRxReadTime() const;
+
+    /**
+     * \return total time packets waited for credit since the device was created
+     */
+    Time GetCreditStarvationTime() const;
+
+    /**
+     * TracedCallback signature for the CreditStarvation trace source.
+     *
+     * \param [in] packet The packet waiting for credit.
+     * \param [in] stalled How long it waits.
+     */
+    typedef void (*CreditStarvationCallback)(Ptr<const Packet> packet, Time stalled);
+
+    /**
+     * Called for every packet whose last character has left the device,
+     * before the next one is taken from the queue.
+     */
+    typedef Callback<void, Ptr<const Packet>> PacketSentCallback;
+    void SetPacketSentCallback(SpWDevice::PacketSentCallback cb);
+
+    NS_DEPRECATED("use SetPacketSentCallback")
+    void SetPacketSentCallcback(SpWDevice::PacketSentCallback cb)
+    {
+        SetPacketSentCallback(cb);
+    }
 
     typedef Callback<void> DeviceReadyCallback;
     void SetDeviceReadyCallback(SpWDevice::DeviceReadyCallback cb);
 
+    /**
+     * \returns the address of the remote device connected to this device
+     * through the point to point channel.
+     */
+    Address GetRemote() const;
+
+    /**
+     * Called for every packet sent by the device and lost when the link is
+     * reset, once per reset. The device sends nothing again by itself.
+     */
+    typedef Callback<void, Ptr<const Packet>> PacketLostCallback;
+    void SetPacketLostCallback(SpWDevice::PacketLostCallback cb);
+
+    /**
+     * Used by the channel when it drops a packet of this device.
+     *
+     * \param p the packet lost
+     */
+    void NotifyPacketLost(Ptr<const Packet> p);
+
   private:
     const Time EXCHANGE_OF_SILENCE = NanoSeconds(850); // minimumtime needed to establish connection
     const Time SPW_DELAY = NanoSeconds(12800);
     const Time SPW_HALF_DELAY = NanoSeconds(6400);
+    const Time SPW_NULL_PERIOD = NanoSeconds(50);
+    static const uint32_t DATA_CHAR_BITS = 10;   //!< Parity, flag and 8 data bits
+    static const uint32_t CONTROL_CHAR_BITS = 4; //!< Parity, flag and 2 control bits (EOP, EEP, FCT)
+    static const uint32_t TIME_CODE_BITS = 14;   //!< ESC and a data character
+    static const uint8_t TIME_CODES = 64;        //!< Values of the time counter
+
     /**
-     * \brief Dispose of the object
+     * Count a link reset for a parity error, called at both ends of the
+     * link, and apply the fallback policy, see SetRateFallback.
      */
-    void DoDispose() override;
+    void ParityErrorReset();
+    void StepRateUp();
 
     /**
-     * \returns the address of the remote device connected to this device
-     * through the point to point channel.
+     * Add the time since the last rate change to the statistics of the
+     * current rate.
      */
-    Address GetRemote() const;
+    void UpdateRateTime();
+    /**
+     * \brief Dispose of the object
+     */
+    void DoDispose() override;
 
     /**
      * Adds the necessary headers and trailers to a packet of data in order to
@@ -291,6 +588,51 @@ class SpWDevice : public NetDevice
      */
     void CheckQueue();
 
+    /**
+     * Start of RUN: take the credit granted by the peer and forget the FCTs
+     * owed to it.
+     */
+    void ResetCredit();
+
+    /**
+     * \returns the receive error model if it samples single characters, 0
+     * otherwise
+     */
+    Ptr<SpWCharacterErrorModel> GetCharacterErrorModel() const;
+
+    /**
+     * \returns the device at the other end of the channel
+     */
+    Ptr<SpWDevice> GetPeer() const;
+
+    /**
+     * Fire the sniffer traces with a copy of the packet behind a
+     * SpWLinkHeader, if anything is connected to them.
+     *
+     * \param packet the frame
+     * \param flags SpWLinkHeader flags
+     */
+    void Sniff(Ptr<const Packet> packet, uint8_t flags);
+
+    /**
+     * Put the destination address on a packet bound for routers.
+     *
+     * \param packet the packet
+     * \param dest its destination
+     */
+    void AddAddress(Ptr<Packet> packet, const Address& dest) const;
+
+    /**
+     * \returns true if the packet goes to the control queue
+     */
+    bool IsControlFrame(Ptr<const Packet> packet) const;
+
+    /**
+     * \returns the next packet to transmit, control frames first, 0 if both
+     * queues are empty
+     */
+    Ptr<Packet> DequeueNext();
+
     /**
      * \brief Make the link up and running
      *
@@ -331,6 +673,21 @@ class SpWDevice : public NetDevice
      */
     DataRate m_bps;
 
+    DataRate m_runRate;                //!< Rate set by SetDataRate, the ceiling of the fallback
+    DataRate m_startupRate;            //!< Rate of the link start-up, 0 for the channel delay
+    uint32_t m_fallbackErrors;         //!< Parity-error resets that step the rate down, 0 never
+    Time m_fallbackWindow;             //!< Time the resets must fall in
+    Time m_fallbackCleanPeriod;        //!< Time without resets that steps the rate up
+    std::deque<Time> m_errorResets;    //!< Recent parity-error resets
+    EventId m_rateUpEvent;             //!< Pending step up
+    Time m_rateSince;                  //!< Last rate change
+    std::map<uint64_t, SpWRateStats> m_rateStats; //!< Statistics by bit rate
+
+    /**
+     * The trace source fired when the data rate changes.
+     */
+    TracedCallback<DataRate, DataRate> m_dataRateChangeTrace;
+
     /**
      * The interframe gap that the Net Device uses to throttle packet
      * transmission
@@ -351,6 +708,11 @@ class SpWDevice : public NetDevice
      */
     Ptr<Queue<Packet>> m_queue;
 
+    /**
+     * Queue of the control frames, served before m_queue.
+     */
+    Ptr<Queue<Packet>> m_controlQueue;
+
     /**
      * Error model for receive packet events
      */
@@ -428,6 +790,12 @@ class SpWDevice : public NetDevice
      */
     TracedCallback<Ptr<const Packet>> m_phyRxDropTrace;
 
+    /**
+     * The trace source fired when a packet is ended by an EEP, with the
+     * characters received before the corrupt one.
+     */
+    TracedCallback<Ptr<const Packet>> m_rxEepTrace;
+
     /**
      * A trace source that emulates a non-promiscuous protocol sniffer connected
      * to the device.  Unlike your average everyday sniffer, this trace source
@@ -464,6 +832,24 @@ class SpWDevice : public NetDevice
      */
     TracedCallback<Ptr<const Packet>> m_promiscSnifferTrace;
 
+    /**
+     * The trace source fired when a packet has to wait for credit before
+     * its transmission can complete, with the time it waits.
+     */
+    TracedCallback<Ptr<const Packet>, Time> m_creditStarvationTrace;
+
+    /**
+     * The trace source fired when a time-code advances the time counter.
+     */
+    TracedCallback<uint8_t> m_timeCodeTrace;
+
+    uint32_t m_rxBufferSize;      //!< Receive buffer in N-chars
+    DataRate m_rxReadRate;        //!< Rate at which the receive buffer is read
+    SpWCreditModel m_txCredit;    //!< Credit granted by the peer
+    Time m_creditStarvation;      //!< Total time spent waiting for credit
+    uint64_t m_rxChars;           //!< N-chars received since RUN
+    uint64_t m_fctsSent;          //!< FCTs sent since RUN for the N-chars received
+
     Ptr<Node> m_node;                                    //!< Node owning this NetDevice
     Mac8Address m_address;                               //!< Mac8Address of this NetDevice
     uint8_t address;                               
@@ -472,6 +858,10 @@ class SpWDevice : public NetDevice
                                                          //   (promisc data)
     PacketSentCallback packet_sent_cb;
     DeviceReadyCallback device_ready_cb;
+    PacketLostCallback packet_lost_cb;
+    HeadReceiveCallback m_headRxCallback;                //!< Receive callback of cut-through devices
+    TimeCodeCallback m_timeCodeCallback;                 //!< Tick callback
+    uint8_t m_timeCode;                                  //!< Time counter
     uint32_t m_ifIndex;                                  //!< Index of the interface
     bool m_linkUp;                                       //!< Identify if the link is up or not
     TracedCallback<> m_linkChangeCallbacks;              //!< Callback for the link change event
@@ -479,6 +869,14 @@ class SpWDevice : public NetDevice
     EventId stateChangeToErrorResetEventId;
     EventId sendNull;
     EventId sendFCT;
+
+    /**
+     * Compute link start-up instead of simulating every NULL and FCT.
+     */
+    bool m_analyticalHandshake;
+    Time m_startedAt;     //!< When the device entered STARTED, analytical handshake
+    EventId linkUpEvent;  //!< Pending RUN of the analytical handshake
+    EventId resetEvent;   //!< Pending ERROR_WAIT or READY of the reset sequence
     std::unordered_map<uint64_t, EventId> transmit_complete_events;
 
     static const uint16_t DEFAULT_MTU = MAX_SPW_PACKET_SZ; //!< Default MTU
@@ -494,6 +892,9 @@ class SpWDevice : public NetDevice
     uint32_t m_mtu;
 
     Ptr<Packet> m_currentPkt; //!< Current packet processed
+    Time m_tailAt;            //!< EOP arrival of the packet sent cut-through
+
+    std::unordered_map<uint8_t, std::vector<uint8_t>> m_paths; //!< Path addresses by node
 
     /**
      * \brief PPP to Ethernet protocol number mapping
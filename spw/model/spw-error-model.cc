@@ -0,0 +1,111 @@
+#include "spw-error-model.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/string.h"
+
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SpWCharacterErrorModel");
+
+NS_OBJECT_ENSURE_REGISTERED(SpWCharacterErrorModel);
+
+TypeId
+SpWCharacterErrorModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SpWCharacterErrorModel")
+            .SetParent<ErrorModel>()
+            .SetGroupName("PointToPoint")
+            .AddConstructor<SpWCharacterErrorModel>()
+            .AddAttribute("CharacterErrorRate",
+                          "Probability that a character is corrupt",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&SpWCharacterErrorModel::m_rate),
+                          MakeDoubleChecker<double>(0.0, 1.0))
+            .AddAttribute("RanVar",
+                          "The decision variable attached to this error model.",
+                          StringValue("ns3::UniformRandomVariable[Min=0.0|Max=1.0]"),
+                          MakePointerAccessor(&SpWCharacterErrorModel::m_ranvar),
+                          MakePointerChecker<RandomVariableStream>());
+    return tid;
+}
+
+SpWCharacterErrorModel::SpWCharacterErrorModel()
+    : m_rate(0.0),
+      m_ranvar(CreateObject<UniformRandomVariable>())
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+SpWCharacterErrorModel::SetRate(double rate)
+{
+    NS_LOG_FUNCTION(this << rate);
+    m_rate = rate;
+}
+
+double
+SpWCharacterErrorModel::GetRate() const
+{
+    return m_rate;
+}
+
+void
+SpWCharacterErrorModel::SetRandomVariable(Ptr<RandomVariableStream> ranvar)
+{
+    NS_LOG_FUNCTION(this << ranvar);
+    m_ranvar = ranvar;
+}
+
+int64_t
+SpWCharacterErrorModel::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_ranvar->SetStream(stream);
+    return 1;
+}
+
+uint32_t
+SpWCharacterErrorModel::GetErrorPosition(uint32_t nChars)
+{
+    NS_LOG_FUNCTION(this << nChars);
+    if (!IsEnabled() || m_rate <= 0.0 || nChars == 0)
+    {
+        return nChars;
+    }
+    if (m_rate >= 1.0)
+    {
+        return 0;
+    }
+    // one draw per packet: the number of good characters before the first
+    // corrupt one is geometric
+    double u = 1.0 - m_ranvar->GetValue(); // in (0, 1]
+    double good = std::floor(std::log(u) / std::log1p(-m_rate));
+    if (good >= nChars)
+    {
+        return nChars;
+    }
+    return static_cast<uint32_t>(good);
+}
+
+bool
+SpWCharacterErrorModel::DoCorrupt(Ptr<Packet> p)
+{
+    NS_LOG_FUNCTION(this << p);
+    uint32_t nChars = p->GetSize() + 1; // EOP
+    return GetErrorPosition(nChars) < nChars;
+}
+
+void
+SpWCharacterErrorModel::DoReset()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+} // namespace ns3
@@ -0,0 +1,71 @@
+#ifndef SPW_ERROR_MODEL_H
+#define SPW_ERROR_MODEL_H
+
+#include "ns3/error-model.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point
+ * \brief Parity errors of single SpW characters.
+ *
+ * Each N-char of a packet, its EOP included, is hit independently with
+ * probability CharacterErrorRate. Set as the ReceiveErrorModel of a
+ * SpWDevice, the peer samples the first failing character when it starts
+ * a packet and stops sending there: the receiver gets the characters
+ * before it ended by an EEP and resets the link.
+ *
+ * Used as a plain ErrorModel, a packet is corrupt if any character is.
+ */
+class SpWCharacterErrorModel : public ErrorModel
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SpWCharacterErrorModel();
+
+    /**
+     * \param rate probability that a character is corrupt
+     */
+    void SetRate(double rate);
+
+    /**
+     * \return probability that a character is corrupt
+     */
+    double GetRate() const;
+
+    /**
+     * \param ranvar uniform random variable the errors are drawn from
+     */
+    void SetRandomVariable(Ptr<RandomVariableStream> ranvar);
+
+    /**
+     * \brief Assign a fixed random variable stream number.
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams(int64_t stream);
+
+    /**
+     * \param nChars characters sent back to back
+     * \return index of the first corrupt one, nChars if none is
+     */
+    uint32_t GetErrorPosition(uint32_t nChars);
+
+  private:
+    bool DoCorrupt(Ptr<Packet> p) override;
+    void DoReset() override;
+
+    double m_rate;                      //!< Character error rate
+    Ptr<RandomVariableStream> m_ranvar; //!< Uniform random variable
+};
+
+} // namespace ns3
+
+#endif /* SPW_ERROR_MODEL_H */
@@ -0,0 +1,116 @@
+#include "spw-flow-control.h"
+
+#include "ns3/assert.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+SpWCreditModel::SpWCreditModel()
+    : m_rxBlocks(MAX_CREDIT / FCT_CHARS),
+      m_initialBlocks(MAX_CREDIT / FCT_CHARS),
+      m_sent(0)
+{
+}
+
+void
+SpWCreditModel::Reset(Time now, uint32_t rxBuffer, Time readTime, Time fctDelay, Time delay)
+{
+    m_rxBlocks = std::max<uint32_t>(rxBuffer / FCT_CHARS, 1);
+    m_initialBlocks = std::min<uint32_t>(m_rxBlocks, MAX_CREDIT / FCT_CHARS);
+    m_readTime = readTime;
+    m_fctDelay = fctDelay;
+    m_delay = delay;
+    m_runAt = now;
+    m_sent = 0;
+    m_grant = now;
+    m_lastRead = now;
+    m_lastArrive = now;
+    // blocks looked back at: the buffer for reads, the credit limit for arrivals
+    size_t history = std::max<size_t>(m_rxBlocks, MAX_CREDIT / FCT_CHARS) + 1;
+    m_arrive.assign(history, now);
+    m_read.assign(history, now);
+}
+
+Time
+SpWCreditModel::GetCreditTime(uint64_t block) const
+{
+    if (block < m_initialBlocks)
+    {
+        return m_runAt;
+    }
+    // the FCT for this block is sent once the buffer has room for it and
+    // the transmitter would hold no more than MAX_CREDIT with it
+    Time issue = m_runAt;
+    if (block >= m_rxBlocks)
+    {
+        issue = Max(issue, m_read[(block - m_rxBlocks) % m_read.size()]);
+    }
+    uint64_t limit = MAX_CREDIT / FCT_CHARS;
+    if (block >= limit)
+    {
+        issue = Max(issue, m_arrive[(block - limit) % m_arrive.size()]);
+    }
+    return Max(issue + m_fctDelay, m_grant);
+}
+
+void
+SpWCreditModel::Send(Time start, uint32_t n, Time charTime)
+{
+    NS_ASSERT_MSG(m_sent % FCT_CHARS + n <= FCT_CHARS, "N-chars of one block at most");
+    if (n == 0)
+    {
+        return;
+    }
+    // N-char i of n arrives at start + (i + 1) charTime + delay, or right
+    // behind the N-chars before it, and each is read readTime after it
+    // arrived or after the one before it was read, whichever is later.
+    // The arrivals grow linearly, so the last read follows from either
+    // end of the run: the first arrival, the last, or what was already
+    // arrived or read before it.
+    Time first = start + charTime + m_delay;
+    Time last = start + charTime * n + m_delay;
+    m_lastRead = Max(Max(m_lastRead, m_lastArrive) + m_readTime * n,
+                     Max(first + m_readTime * n, last + m_readTime));
+    m_lastArrive = Max(last, m_lastArrive);
+    m_sent += n;
+    if (m_sent % FCT_CHARS == 0)
+    {
+        uint64_t block = (m_sent - 1) / FCT_CHARS;
+        m_arrive[block % m_arrive.size()] = m_lastArrive;
+        m_read[block % m_read.size()] = m_lastRead;
+    }
+}
+
+Time
+SpWCreditModel::Transmit(Time start, uint32_t dataChars, Time charTime, Time eopTime)
+{
+    Time t = start;
+    Time stalled;
+    uint32_t left = dataChars + 1; // EOP
+    while (left != 0)
+    {
+        if (m_sent % FCT_CHARS == 0)
+        {
+            m_grant = GetCreditTime(m_sent / FCT_CHARS);
+        }
+        if (m_grant > t)
+        {
+            stalled += m_grant - t;
+            t = m_grant;
+        }
+        uint32_t n = std::min<uint32_t>(FCT_CHARS - m_sent % FCT_CHARS, left);
+        uint32_t data = n == left ? n - 1 : n;
+        Send(t, data, charTime);
+        t += charTime * data;
+        if (n == left)
+        {
+            Send(t, 1, eopTime);
+        }
+        left -= n;
+    }
+    return stalled;
+}
+
+} // namespace ns3
@@ -0,0 +1,86 @@
+#ifndef SPW_FLOW_CONTROL_H
+#define SPW_FLOW_CONTROL_H
+
+#include "ns3/nstime.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point
+ * \brief Credit of one direction of a SpW link.
+ *
+ * The receiver grants credit with FCTs of FCT_CHARS N-chars each, as long
+ * as its buffer has room for them and the transmitter holds no more than
+ * MAX_CREDIT; the transmitter stops when its credit runs out. The FCTs
+ * themselves are not simulated: the receiver buffer drains at a fixed read
+ * time per N-char, so when the FCT for every block of FCT_CHARS N-chars
+ * reaches the transmitter follows from when the earlier N-chars arrived
+ * and were read. The model is kept by the transmitter and only computes
+ * how long a packet waits for credit.
+ *
+ * At RUN the whole buffer, up to MAX_CREDIT, is granted.
+ */
+class SpWCreditModel
+{
+  public:
+    static const uint32_t FCT_CHARS = 8;   //!< N-chars granted by one FCT
+    static const uint32_t MAX_CREDIT = 56; //!< Largest credit a transmitter may hold
+
+    SpWCreditModel();
+
+    /**
+     * Start of RUN, nothing is in flight.
+     *
+     * \param now current time
+     * \param rxBuffer receiver buffer in N-chars, rounded down to whole FCTs
+     * \param readTime time the receiver takes to read one N-char, zero if
+     * the buffer is emptied as fast as it fills
+     * \param fctDelay from the FCT leaving the receiver to its arrival
+     * \param delay propagation delay of the data
+     */
+    void Reset(Time now, uint32_t rxBuffer, Time readTime, Time fctDelay, Time delay);
+
+    /**
+     * Send a packet of dataChars N-chars and its EOP.
+     *
+     * \param start when the transmitter starts the packet
+     * \param dataChars data N-chars of the packet
+     * \param charTime line time of one data N-char
+     * \param eopTime line time of the EOP
+     * \return time spent waiting for credit
+     */
+    Time Transmit(Time start, uint32_t dataChars, Time charTime, Time eopTime);
+
+  private:
+    /**
+     * \param block index of a block of FCT_CHARS N-chars since RUN
+     * \return when the FCT of the block reaches the transmitter
+     */
+    Time GetCreditTime(uint64_t block) const;
+
+    /**
+     * Account n N-chars leaving the transmitter back to back from start,
+     * no more than the rest of the current block.
+     */
+    void Send(Time start, uint32_t n, Time charTime);
+
+    uint32_t m_rxBlocks;      //!< Receiver buffer in FCTs
+    uint32_t m_initialBlocks; //!< FCTs granted at RUN
+    Time m_readTime;
+    Time m_fctDelay;
+    Time m_delay;
+    Time m_runAt;
+    uint64_t m_sent;   //!< N-chars sent since RUN
+    Time m_grant;      //!< Arrival of the FCT of the current block
+    Time m_lastRead;   //!< When the last N-char sent is read by the receiver
+    Time m_lastArrive; //!< When the last N-char sent arrives at the receiver
+    std::vector<Time> m_arrive; //!< Arrival of the last N-char of recent blocks
+    std::vector<Time> m_read;   //!< Read of the last N-char of recent blocks
+};
+
+} // namespace ns3
+
+#endif /* SPW_FLOW_CONTROL_H */
@@ -0,0 +1,96 @@
+#include "spw-link-header.h"
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(SpWLinkHeader);
+
+SpWLinkHeader::SpWLinkHeader()
+    : m_dst(0),
+      m_protocol(PROTOCOL_OST),
+      m_src(0),
+      m_flags(0)
+{
+}
+
+SpWLinkHeader::SpWLinkHeader(uint8_t dst, uint8_t src, uint8_t flags)
+    : m_dst(dst),
+      m_protocol(PROTOCOL_OST),
+      m_src(src),
+      m_flags(flags)
+{
+}
+
+TypeId
+SpWLinkHeader::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::SpWLinkHeader")
+                            .SetParent<Header>()
+                            .SetGroupName("PointToPoint")
+                            .AddConstructor<SpWLinkHeader>();
+    return tid;
+}
+
+TypeId
+SpWLinkHeader::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+void
+SpWLinkHeader::Print(std::ostream& os) const
+{
+    os << "dst: " << std::to_string(m_dst) << ", protocol: " << std::to_string(m_protocol)
+       << ", src: " << std::to_string(m_src) << ", flags: " << std::to_string(m_flags);
+}
+
+uint32_t
+SpWLinkHeader::GetSerializedSize() const
+{
+    return 4;
+}
+
+void
+SpWLinkHeader::Serialize(Buffer::Iterator start) const
+{
+    start.WriteU8(m_dst);
+    start.WriteU8(m_protocol);
+    start.WriteU8(m_src);
+    start.WriteU8(m_flags);
+}
+
+uint32_t
+SpWLinkHeader::Deserialize(Buffer::Iterator start)
+{
+    m_dst = start.ReadU8();
+    m_protocol = start.ReadU8();
+    m_src = start.ReadU8();
+    m_flags = start.ReadU8();
+    return GetSerializedSize();
+}
+
+uint8_t
+SpWLinkHeader::GetDestination() const
+{
+    return m_dst;
+}
+
+uint8_t
+SpWLinkHeader::GetProtocol() const
+{
+    return m_protocol;
+}
+
+uint8_t
+SpWLinkHeader::GetSource() const
+{
+    return m_src;
+}
+
+uint8_t
+SpWLinkHeader::GetFlags() const
+{
+    return m_flags;
+}
+
+} // namespace ns3
@@ -0,0 +1,61 @@
+#ifndef SPW_LINK_HEADER_H
+#define SPW_LINK_HEADER_H
+
+#include "ns3/header.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point
+ * \brief Link header SpWDevice puts in front of the frames it passes to
+ * its sniffer trace sources.
+ *
+ * The device does not send it, it only tells a capture which way the
+ * frame went and how it ended. 4 bytes:
+ *
+ *     offset field
+ *          0 destination address
+ *          1 protocol identifier, PROTOCOL_OST
+ *          2 source address
+ *          3 flags: bit 0 received by the device, bit 1 ended by an EEP
+ *
+ * The destination address and protocol identifier are where a SpaceWire
+ * packet carries them.
+ */
+class SpWLinkHeader : public Header
+{
+  public:
+    static const uint8_t PROTOCOL_OST = 0xf0;
+    static const uint8_t FLAG_RECEIVED = 0x01;
+    static const uint8_t FLAG_EEP = 0x02;
+
+    SpWLinkHeader();
+    SpWLinkHeader(uint8_t dst, uint8_t src, uint8_t flags);
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    void Print(std::ostream& os) const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+
+    uint8_t GetDestination() const;
+    uint8_t GetProtocol() const;
+    uint8_t GetSource() const;
+    uint8_t GetFlags() const;
+
+  private:
+    uint8_t m_dst;      //!< Destination address
+    uint8_t m_protocol; //!< Protocol identifier
+    uint8_t m_src;      //!< Source address
+    uint8_t m_flags;    //!< FLAG_ bits
+};
+
+} // namespace ns3
+
+#endif /* SPW_LINK_HEADER_H */
@@ -0,0 +1,197 @@
+#include "spw-pcap-writer.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SpWPcapWriter");
+
+NS_OBJECT_ENSURE_REGISTERED(SpWPcapWriter);
+
+TypeId
+SpWPcapWriter::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SpWPcapWriter")
+            .SetParent<Object>()
+            .SetGroupName("PointToPoint")
+            .AddConstructor<SpWPcapWriter>()
+            .AddAttribute("MaxFileSize",
+                          "Size in bytes a file may reach before the next one is "
+                          "started, 0 to keep one file",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&SpWPcapWriter::m_maxFileSize),
+                          MakeUintegerChecker<uint64_t>())
+            .AddAttribute("BufferSize",
+                          "Bytes of records collected before they are written",
+                          UintegerValue(1 << 20),
+                          MakeUintegerAccessor(&SpWPcapWriter::m_bufferSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("SnapLen",
+                          "Bytes of a frame kept in its record",
+                          UintegerValue(65535),
+                          MakeUintegerAccessor(&SpWPcapWriter::m_snapLen),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("LinkType",
+                          "PCAP link type of the files, DLT_USER0 by default",
+                          UintegerValue(147),
+                          MakeUintegerAccessor(&SpWPcapWriter::m_linkType),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+SpWPcapWriter::SpWPcapWriter()
+    : m_maxFileSize(0),
+      m_bufferSize(1 << 20),
+      m_snapLen(65535),
+      m_linkType(147),
+      m_fileBytes(0),
+      m_files(0),
+      m_records(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SpWPcapWriter::~SpWPcapWriter()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+void
+SpWPcapWriter::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+    Object::DoDispose();
+}
+
+void
+SpWPcapWriter::Open(const std::string& fileName)
+{
+    NS_LOG_FUNCTION(this << fileName);
+    Close();
+    m_fileName = fileName;
+    m_files = 0;
+    m_records = 0;
+    m_buffer.reserve(m_bufferSize);
+    StartFile();
+}
+
+void
+SpWPcapWriter::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_file.is_open())
+    {
+        return;
+    }
+    Flush();
+    m_file.close();
+}
+
+void
+SpWPcapWriter::Flush()
+{
+    if (m_buffer.empty())
+    {
+        return;
+    }
+    m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+    m_file.flush();
+    NS_ABORT_MSG_IF(!m_file, "SpWPcapWriter cannot write " << GetFileName(m_files - 1));
+    m_buffer.clear();
+}
+
+void
+SpWPcapWriter::Write(Time t, Ptr<const Packet> p)
+{
+    NS_ASSERT_MSG(m_file.is_open(), "SpWPcapWriter is not open");
+    uint32_t size = p->GetSize();
+    uint32_t captured = size < m_snapLen ? size : m_snapLen;
+    uint32_t length = RECORD_HEADER_SIZE + captured;
+
+    if (m_maxFileSize && m_fileBytes > PCAP_HEADER_SIZE && m_fileBytes + length > m_maxFileSize)
+    {
+        Flush();
+        m_file.close();
+        StartFile();
+    }
+    if (m_buffer.size() + length > m_bufferSize)
+    {
+        Flush();
+    }
+
+    int64_t ns = t.GetNanoSeconds();
+    Put<uint32_t>(ns / 1000000000);
+    Put<uint32_t>(ns % 1000000000);
+    Put<uint32_t>(captured);
+    Put<uint32_t>(size);
+    size_t offset = m_buffer.size();
+    m_buffer.resize(offset + captured);
+    p->CopyData(m_buffer.data() + offset, captured);
+
+    m_fileBytes += length;
+    m_records++;
+}
+
+void
+SpWPcapWriter::Capture(Ptr<const Packet> p)
+{
+    Write(Simulator::Now(), p);
+}
+
+uint64_t
+SpWPcapWriter::GetRecordCount() const
+{
+    return m_records;
+}
+
+uint32_t
+SpWPcapWriter::GetFileCount() const
+{
+    return m_files;
+}
+
+std::string
+SpWPcapWriter::GetFileName(uint32_t i) const
+{
+    if (i == 0)
+    {
+        return m_fileName;
+    }
+    std::string base = m_fileName;
+    std::string extension;
+    size_t dot = base.rfind(".pcap");
+    if (dot != std::string::npos && dot + 5 == base.size())
+    {
+        extension = base.substr(dot);
+        base.resize(dot);
+    }
+    return base + "." + std::to_string(i) + extension;
+}
+
+void
+SpWPcapWriter::StartFile()
+{
+    std::string fileName = GetFileName(m_files);
+    NS_LOG_INFO("capturing to " << fileName);
+    m_file.open(fileName, std::ios::binary | std::ios::trunc);
+    NS_ABORT_MSG_IF(!m_file, "SpWPcapWriter cannot create " << fileName);
+    m_files++;
+
+    Put<uint32_t>(0xa1b23c4d); // nanosecond timestamps
+    Put<uint16_t>(2);          // version 2.4
+    Put<uint16_t>(4);
+    Put<int32_t>(0);           // thiszone
+    Put<uint32_t>(0);          // sigfigs
+    Put<uint32_t>(m_snapLen);
+    Put<uint32_t>(m_linkType);
+    m_fileBytes = PCAP_HEADER_SIZE;
+}
+
+} // namespace ns3
@@ -0,0 +1,128 @@
+#ifndef SPW_PCAP_WRITER_H
+#define SPW_PCAP_WRITER_H
+
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/packet.h"
+
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point
+ * \brief Writes the frames of a SpWDevice sniffer to PCAP files.
+ *
+ * The files are standard PCAP with nanosecond timestamps (magic
+ * 0xa1b23c4d, version 2.4) in host byte order, link type LinkType. Every
+ * record holds the frame as the sniffer passes it: a 4-byte SpWLinkHeader
+ * followed by the 5-byte OST segment header and the payload, cut to
+ * SnapLen bytes.
+ *
+ * Records are collected in a buffer of BufferSize bytes and written when
+ * it is full, on Flush and on Close. With MaxFileSize set, a record that
+ * would take the file over it starts a new file: name.pcap is followed
+ * by name.1.pcap, name.2.pcap and so on, each with its own PCAP header.
+ */
+class SpWPcapWriter : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SpWPcapWriter();
+    ~SpWPcapWriter() override;
+
+    /**
+     * Start a capture, closing the current one. Aborts if the file cannot
+     * be created.
+     *
+     * \param fileName name of the first file
+     */
+    void Open(const std::string& fileName);
+
+    /**
+     * Write what is buffered and close the file.
+     */
+    void Close();
+
+    /**
+     * Write what is buffered.
+     */
+    void Flush();
+
+    /**
+     * \param t timestamp of the record
+     * \param p the frame
+     */
+    void Write(Time t, Ptr<const Packet> p);
+
+    /**
+     * Trace sink for the SpWDevice sniffer sources, writes p with the
+     * current time.
+     *
+     * \param p the frame
+     */
+    void Capture(Ptr<const Packet> p);
+
+    /**
+     * \return records written since Open
+     */
+    uint64_t GetRecordCount() const;
+
+    /**
+     * \return files started since Open
+     */
+    uint32_t GetFileCount() const;
+
+    /**
+     * \param i index of the file, from 0
+     * \return its name
+     */
+    std::string GetFileName(uint32_t i) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    static const uint32_t PCAP_HEADER_SIZE = 24;
+    static const uint32_t RECORD_HEADER_SIZE = 16;
+
+    /**
+     * Open file m_files and write the PCAP header to the buffer.
+     */
+    void StartFile();
+
+    /**
+     * Append a value in host byte order to the buffer.
+     */
+    template <typename T>
+    void Put(T value)
+    {
+        size_t offset = m_buffer.size();
+        m_buffer.resize(offset + sizeof(value));
+        memcpy(m_buffer.data() + offset, &value, sizeof(value));
+    }
+
+    uint64_t m_maxFileSize;         //!< Bytes after which a new file is started, 0 for one file
+    uint32_t m_bufferSize;          //!< Bytes buffered before a write
+    uint32_t m_snapLen;             //!< Bytes of a frame kept
+    uint32_t m_linkType;            //!< PCAP link type of the files
+    std::string m_fileName;         //!< Name of the first file
+    std::ofstream m_file;           //!< Current file
+    std::vector<uint8_t> m_buffer;  //!< Records not written yet
+    uint64_t m_fileBytes;           //!< Bytes of the current file, buffer included
+    uint32_t m_files;               //!< Files started
+    uint64_t m_records;             //!< Records written
+};
+
+} // namespace ns3
+
+#endif /* SPW_PCAP_WRITER_H */
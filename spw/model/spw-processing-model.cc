@@ -0,0 +1,225 @@
+#include "spw-processing-model.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SpWProcessingModel");
+
+NS_OBJECT_ENSURE_REGISTERED(SpWProcessingModel);
+
+TypeId
+SpWProcessingModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SpWProcessingModel")
+            .SetParent<Object>()
+            .SetGroupName("PointToPoint")
+            .AddTraceSource("Drop",
+                            "A receiver had no room for the frame",
+                            MakeTraceSourceAccessor(&SpWProcessingModel::m_dropTrace),
+                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+SpWProcessingModel::SpWProcessingModel()
+    : m_drops(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SpWProcessingModel::~SpWProcessingModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+bool
+SpWProcessingModel::Admit(Ptr<const Packet> p, uint32_t wire, Time& delay)
+{
+    NS_LOG_FUNCTION(this << p << wire);
+    NS_ASSERT(wire < 2);
+    if (!DoAdmit(p, wire, delay))
+    {
+        NS_LOG_LOGIC("receiver of wire " << wire << " drops " << p);
+        m_drops++;
+        m_dropTrace(p);
+        return false;
+    }
+    return true;
+}
+
+uint32_t
+SpWProcessingModel::GetDropCount() const
+{
+    return m_drops;
+}
+
+NS_OBJECT_ENSURE_REGISTERED(SpWFixedProcessingModel);
+
+TypeId
+SpWFixedProcessingModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SpWFixedProcessingModel")
+            .SetParent<SpWProcessingModel>()
+            .SetGroupName("PointToPoint")
+            .AddConstructor<SpWFixedProcessingModel>()
+            .AddAttribute("Delay",
+                          "Processing time of a frame",
+                          TimeValue(MilliSeconds(100)),
+                          MakeTimeAccessor(&SpWFixedProcessingModel::m_delay),
+                          MakeTimeChecker(Time(0)));
+    return tid;
+}
+
+SpWFixedProcessingModel::SpWFixedProcessingModel()
+    : m_delay(MilliSeconds(100))
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+SpWFixedProcessingModel::SetDelay(Time delay)
+{
+    NS_LOG_FUNCTION(this << delay);
+    m_delay = delay;
+}
+
+Time
+SpWFixedProcessingModel::GetDelay() const
+{
+    return m_delay;
+}
+
+bool
+SpWFixedProcessingModel::DoAdmit(Ptr<const Packet> p, uint32_t wire, Time& delay)
+{
+    delay = m_delay;
+    return true;
+}
+
+NS_OBJECT_ENSURE_REGISTERED(SpWPerByteProcessingModel);
+
+TypeId
+SpWPerByteProcessingModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SpWPerByteProcessingModel")
+            .SetParent<SpWProcessingModel>()
+            .SetGroupName("PointToPoint")
+            .AddConstructor<SpWPerByteProcessingModel>()
+            .AddAttribute("Overhead",
+                          "Processing time of every frame",
+                          TimeValue(MicroSeconds(10)),
+                          MakeTimeAccessor(&SpWPerByteProcessingModel::m_overhead),
+                          MakeTimeChecker(Time(0)))
+            .AddAttribute("Rate",
+                          "Rate the bytes of a frame are processed at",
+                          DataRateValue(DataRate("400Mbps")),
+                          MakeDataRateAccessor(&SpWPerByteProcessingModel::m_rate),
+                          MakeDataRateChecker());
+    return tid;
+}
+
+SpWPerByteProcessingModel::SpWPerByteProcessingModel()
+    : m_overhead(MicroSeconds(10)),
+      m_rate(DataRate("400Mbps"))
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+SpWPerByteProcessingModel::SetOverhead(Time overhead)
+{
+    NS_LOG_FUNCTION(this << overhead);
+    m_overhead = overhead;
+}
+
+void
+SpWPerByteProcessingModel::SetRate(DataRate rate)
+{
+    NS_LOG_FUNCTION(this << rate);
+    m_rate = rate;
+}
+
+Time
+SpWPerByteProcessingModel::GetServiceTime(Ptr<const Packet> p) const
+{
+    return m_overhead + m_rate.CalculateBytesTxTime(p->GetSize());
+}
+
+bool
+SpWPerByteProcessingModel::DoAdmit(Ptr<const Packet> p, uint32_t wire, Time& delay)
+{
+    delay = GetServiceTime(p);
+    return true;
+}
+
+NS_OBJECT_ENSURE_REGISTERED(SpWCpuProcessingModel);
+
+TypeId
+SpWCpuProcessingModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SpWCpuProcessingModel")
+            .SetParent<SpWPerByteProcessingModel>()
+            .SetGroupName("PointToPoint")
+            .AddConstructor<SpWCpuProcessingModel>()
+            .AddAttribute("Capacity",
+                          "Frames a receiver holds, the one in service included",
+                          UintegerValue(16),
+                          MakeUintegerAccessor(&SpWCpuProcessingModel::m_capacity),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+SpWCpuProcessingModel::SpWCpuProcessingModel()
+    : m_capacity(16)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+SpWCpuProcessingModel::SetCapacity(uint32_t capacity)
+{
+    NS_LOG_FUNCTION(this << capacity);
+    m_capacity = capacity;
+}
+
+uint32_t
+SpWCpuProcessingModel::GetBacklog(uint32_t wire)
+{
+    Update(wire);
+    return m_done[wire].size();
+}
+
+void
+SpWCpuProcessingModel::Update(uint32_t wire)
+{
+    Time now = Simulator::Now();
+    while (!m_done[wire].empty() && m_done[wire].front() <= now)
+    {
+        m_done[wire].pop_front();
+    }
+}
+
+bool
+SpWCpuProcessingModel::DoAdmit(Ptr<const Packet> p, uint32_t wire, Time& delay)
+{
+    Update(wire);
+    if (m_done[wire].size() >= m_capacity)
+    {
+        return false;
+    }
+    Time now = Simulator::Now();
+    Time start = m_done[wire].empty() ? now : m_done[wire].back();
+    m_done[wire].push_back(start + GetServiceTime(p));
+    delay = m_done[wire].back() - now;
+    return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,155 @@
+#ifndef SPW_PROCESSING_MODEL_H
+#define SPW_PROCESSING_MODEL_H
+
+#include "ns3/data-rate.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/packet.h"
+#include "ns3/traced-callback.h"
+
+#include <deque>
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point
+ * \brief Time the receiver takes for a frame before its device gets it.
+ *
+ * SpWChannel asks the model when the last character of a frame arrives.
+ * Each wire ends at its own receiver, models with state keep it per wire.
+ */
+class SpWProcessingModel : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SpWProcessingModel();
+    ~SpWProcessingModel() override;
+
+    /**
+     * A frame has arrived.
+     *
+     * \param p the frame
+     * \param wire the wire it arrived on, 0 or 1
+     * \param delay set to the time from now until the receiver is done with it
+     * \return false if the receiver has no room for the frame and drops it
+     */
+    bool Admit(Ptr<const Packet> p, uint32_t wire, Time& delay);
+
+    /**
+     * \return frames dropped by the receivers
+     */
+    uint32_t GetDropCount() const;
+
+  private:
+    /**
+     * \copydoc Admit
+     */
+    virtual bool DoAdmit(Ptr<const Packet> p, uint32_t wire, Time& delay) = 0;
+
+    uint32_t m_drops;                              //!< Frames dropped
+    TracedCallback<Ptr<const Packet>> m_dropTrace; //!< Frame dropped
+};
+
+/**
+ * \ingroup point-to-point
+ * \brief Every frame takes Delay, however many there are.
+ */
+class SpWFixedProcessingModel : public SpWProcessingModel
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SpWFixedProcessingModel();
+
+    void SetDelay(Time delay);
+    Time GetDelay() const;
+
+  private:
+    bool DoAdmit(Ptr<const Packet> p, uint32_t wire, Time& delay) override;
+
+    Time m_delay; //!< Processing time of a frame
+};
+
+/**
+ * \ingroup point-to-point
+ * \brief A frame takes Overhead plus its bytes at Rate, however many
+ * there are.
+ */
+class SpWPerByteProcessingModel : public SpWProcessingModel
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SpWPerByteProcessingModel();
+
+    void SetOverhead(Time overhead);
+    void SetRate(DataRate rate);
+
+    /**
+     * \param p a frame
+     * \return the time it takes to process p
+     */
+    Time GetServiceTime(Ptr<const Packet> p) const;
+
+  private:
+    bool DoAdmit(Ptr<const Packet> p, uint32_t wire, Time& delay) override;
+
+    Time m_overhead; //!< Processing time of every frame
+    DataRate m_rate; //!< Rate the bytes of a frame are processed at
+};
+
+/**
+ * \ingroup point-to-point
+ * \brief The receiver processes one frame at a time, each taking its
+ * SpWPerByteProcessingModel service time, and holds at most Capacity
+ * frames, the one in service included. Frames arriving to a full
+ * receiver are dropped.
+ */
+class SpWCpuProcessingModel : public SpWPerByteProcessingModel
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SpWCpuProcessingModel();
+
+    void SetCapacity(uint32_t capacity);
+
+    /**
+     * \param wire a wire
+     * \return frames its receiver holds now
+     */
+    uint32_t GetBacklog(uint32_t wire);
+
+  private:
+    bool DoAdmit(Ptr<const Packet> p, uint32_t wire, Time& delay) override;
+
+    /**
+     * Forget the frames of the receiver done by now.
+     */
+    void Update(uint32_t wire);
+
+    uint32_t m_capacity;       //!< Frames a receiver holds
+    std::deque<Time> m_done[2]; //!< When the frames held by each receiver are done
+};
+
+} // namespace ns3
+
+#endif /* SPW_PROCESSING_MODEL_H */
@@ -0,0 +1,259 @@
+#include "spw-router.h"
+
+#include "spw-address-tag.h"
+
+#include "ns3/abort.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/trace-source-accessor.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SpWRouter");
+
+NS_OBJECT_ENSURE_REGISTERED(SpWRouter);
+
+TypeId
+SpWRouter::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SpWRouter")
+            .SetParent<Object>()
+            .SetGroupName("PointToPoint")
+            .AddConstructor<SpWRouter>()
+            .AddAttribute("SwitchingDelay",
+                          "Time from the arrival of the address of a packet "
+                          "until it can go out",
+                          TimeValue(Time(0)),
+                          MakeTimeAccessor(&SpWRouter::m_switchingDelay),
+                          MakeTimeChecker(Time(0)))
+            .AddTraceSource("Forward",
+                            "A packet is switched to an output port",
+                            MakeTraceSourceAccessor(&SpWRouter::m_forwardTrace),
+                            "ns3::SpWRouter::ForwardCallback")
+            .AddTraceSource("Drop",
+                            "A packet has no route",
+                            MakeTraceSourceAccessor(&SpWRouter::m_dropTrace),
+                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+SpWRouter::SpWRouter()
+    : m_routes(256),
+      m_switchingDelay(0),
+      m_nextInput(0),
+      m_timeCode(0),
+      m_forwarded(0),
+      m_drops(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SpWRouter::~SpWRouter()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+SpWRouter::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_ports.clear();
+    m_inputs.clear();
+    Object::DoDispose();
+}
+
+uint8_t
+SpWRouter::AddPort(Ptr<SpWDevice> device)
+{
+    NS_LOG_FUNCTION(this << device);
+    NS_ABORT_MSG_IF(m_ports.size() == 31, "SpWRouter has at most 31 ports");
+    m_ports.push_back(device);
+    m_inputs.emplace_back();
+    if (!device->GetQueue())
+    {
+        device->SetQueue(CreateObject<DropTailQueue<Packet>>());
+    }
+    device->SetHeadReceiveCallback(MakeCallback(&SpWRouter::ReceiveHead, this));
+    device->SetDeviceReadyCallback(MakeCallback(&SpWRouter::Forward, this));
+    device->SetTimeCodeCallback(MakeCallback(&SpWRouter::ReceiveTimeCode, this));
+    return m_ports.size();
+}
+
+Ptr<SpWDevice>
+SpWRouter::GetPort(uint8_t port) const
+{
+    NS_ASSERT(port >= 1 && port <= m_ports.size());
+    return m_ports[port - 1];
+}
+
+uint8_t
+SpWRouter::GetNPorts() const
+{
+    return m_ports.size();
+}
+
+void
+SpWRouter::AddRoute(uint8_t logical, const std::vector<uint8_t>& ports)
+{
+    NS_LOG_FUNCTION(this << +logical);
+    NS_ABORT_MSG_IF(ports.empty(), "Route to " << +logical << " without a port");
+    for (uint8_t port : ports)
+    {
+        NS_ABORT_MSG_IF(port < 1 || port > m_ports.size(),
+                        "Route to " << +logical << " through unknown port " << +port);
+    }
+    m_routes[logical] = ports;
+}
+
+void
+SpWRouter::Start()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& device : m_ports)
+    {
+        device->ErrorResetSpWState();
+    }
+}
+
+uint64_t
+SpWRouter::GetForwardedCount() const
+{
+    return m_forwarded;
+}
+
+uint64_t
+SpWRouter::GetDropCount() const
+{
+    return m_drops;
+}
+
+Time
+SpWRouter::GetBlockedTime() const
+{
+    return m_blocked;
+}
+
+uint32_t
+SpWRouter::GetInputBacklog(uint8_t port) const
+{
+    NS_ASSERT(port >= 1 && port <= m_inputs.size());
+    return m_inputs[port - 1].size();
+}
+
+void
+SpWRouter::ReceiveHead(Ptr<SpWDevice> device, Ptr<Packet> packet, Time tail)
+{
+    NS_LOG_FUNCTION(this << device << packet << tail);
+    uint8_t input = 0;
+    while (m_ports[input] != device)
+    {
+        input++;
+    }
+
+    SpWAddressTag tag;
+    if (!packet->RemovePacketTag(tag))
+    {
+        Drop(packet);
+        return;
+    }
+    Frame frame;
+    if (tag.HasPath())
+    {
+        frame.ports.push_back(tag.GetPort());
+        tag.PopPath();
+    }
+    else
+    {
+        frame.ports = m_routes[tag.GetLogicalAddress()];
+    }
+    if (frame.ports.empty() || frame.ports[0] < 1 || frame.ports[0] > m_ports.size())
+    {
+        NS_LOG_LOGIC("no route to " << +tag.GetLogicalAddress());
+        Drop(packet);
+        return;
+    }
+    packet->AddPacketTag(tag);
+    frame.packet = packet;
+    frame.tail = tail;
+    Simulator::Schedule(m_switchingDelay, &SpWRouter::Arrive, this, input, frame);
+}
+
+void
+SpWRouter::Arrive(uint8_t port, Frame frame)
+{
+    frame.arrived = Simulator::Now();
+    m_inputs[port].push_back(frame);
+    Forward();
+}
+
+void
+SpWRouter::Forward()
+{
+    uint8_t n = m_inputs.size();
+    for (uint8_t k = 0; k < n; ++k)
+    {
+        uint8_t input = (m_nextInput + k) % n;
+        std::deque<Frame>& queue = m_inputs[input];
+        while (!queue.empty())
+        {
+            // the packet at the head blocks the ones behind it
+            uint8_t output = FindOutput(queue.front());
+            if (output == 0)
+            {
+                break;
+            }
+            Frame frame = queue.front();
+            queue.pop_front();
+            m_blocked += Simulator::Now() - frame.arrived;
+            m_forwarded++;
+            m_nextInput = (input + 1) % n;
+            NS_LOG_LOGIC("port " << +(input + 1) << " -> port " << +output);
+            m_forwardTrace(frame.packet, input + 1, output);
+            m_ports[output - 1]->SendCutThrough(frame.packet, frame.tail);
+        }
+    }
+}
+
+uint8_t
+SpWRouter::FindOutput(const Frame& frame) const
+{
+    for (uint8_t port : frame.ports)
+    {
+        if (m_ports[port - 1]->IsReadyToTransmit())
+        {
+            return port;
+        }
+    }
+    return 0;
+}
+
+void
+SpWRouter::Drop(Ptr<const Packet> packet)
+{
+    m_drops++;
+    m_dropTrace(packet);
+}
+
+void
+SpWRouter::ReceiveTimeCode(Ptr<SpWDevice> device, uint8_t timeCode)
+{
+    NS_LOG_FUNCTION(this << device << +timeCode);
+    if (timeCode != (m_timeCode + 1) % 64)
+    {
+        // already passed on, it came back over another link
+        return;
+    }
+    m_timeCode = timeCode;
+    for (auto& port : m_ports)
+    {
+        if (port != device)
+        {
+            port->SendTimeCode(timeCode);
+        }
+    }
+}
+
+} // namespace ns3
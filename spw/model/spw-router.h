@@ -0,0 +1,186 @@
+#ifndef SPW_ROUTER_H
+#define SPW_ROUTER_H
+
+#include "spw-device.h"
+
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/packet.h"
+#include "ns3/traced-callback.h"
+
+#include <deque>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point
+ * \brief SpaceWire router with wormhole switching.
+ *
+ * Every port is a SpWDevice on its own SpWChannel, ports are numbered from
+ * 1 as the path addresses that select them. A packet is switched when its
+ * address characters are in, see SpWAddressTag:
+ *
+ * - a path address character selects the output port and is deleted;
+ * - a logical address selects a group of ports in the routing table and
+ *   the packet takes the first of them that is free (group adaptive
+ *   routing), it is not deleted.
+ *
+ * The output port then sends the packet while the rest of it is still
+ * arriving, and is held until its EOP has gone out. A packet whose output
+ * ports are all busy waits at the head of its input port and the packets
+ * that arrive behind it wait too, even if their output is free (head of
+ * line blocking). Freed outputs serve the waiting inputs in turn.
+ *
+ * Time-codes are passed on: one that advances the time counter of the
+ * router by one goes out of every other port, others are ignored.
+ *
+ * Packets with a path address of a port that does not exist or a logical
+ * address without a route are dropped. The input link is not held back
+ * by a blocked packet: the packets behind it wait in the input port,
+ * GetInputBacklog tells how many.
+ */
+class SpWRouter : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SpWRouter();
+    ~SpWRouter() override;
+
+    /**
+     * Add a port. The router takes the receive and ready callbacks of the
+     * device and gives it a transmit queue if it has none.
+     *
+     * \param device the device of the port, attached to its channel
+     * \return the port number
+     */
+    uint8_t AddPort(Ptr<SpWDevice> device);
+
+    /**
+     * \param port the port number, from 1
+     * \return the device of the port
+     */
+    Ptr<SpWDevice> GetPort(uint8_t port) const;
+
+    /**
+     * \return ports of the router
+     */
+    uint8_t GetNPorts() const;
+
+    /**
+     * Route a logical address to a group of ports.
+     *
+     * \param logical the logical address
+     * \param ports the group, the first free one is taken
+     */
+    void AddRoute(uint8_t logical, const std::vector<uint8_t>& ports);
+
+    /**
+     * Start the links of all the ports.
+     */
+    void Start();
+
+    /**
+     * \return packets switched to an output port
+     */
+    uint64_t GetForwardedCount() const;
+
+    /**
+     * \return packets without a route
+     */
+    uint64_t GetDropCount() const;
+
+    /**
+     * \return total time packets waited at their input port for an output
+     */
+    Time GetBlockedTime() const;
+
+    /**
+     * \param port the port number
+     * \return packets waiting at the input port
+     */
+    uint32_t GetInputBacklog(uint8_t port) const;
+
+    /**
+     * TracedCallback signature for the Forward trace source.
+     *
+     * \param [in] packet The packet switched.
+     * \param [in] input The port it came in on.
+     * \param [in] output The port it goes out of.
+     */
+    typedef void (*ForwardCallback)(Ptr<const Packet> packet, uint8_t input, uint8_t output);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /** A packet at an input port. */
+    struct Frame
+    {
+        Ptr<Packet> packet;         //!< The packet
+        Time tail;                  //!< When its EOP arrives
+        Time arrived;               //!< When it reached the input port
+        std::vector<uint8_t> ports; //!< Output ports it may take
+    };
+
+    /**
+     * The head of a packet came in on a port.
+     *
+     * \param device the device of the port
+     * \param packet the packet
+     * \param tail when its EOP arrives
+     */
+    void ReceiveHead(Ptr<SpWDevice> device, Ptr<Packet> packet, Time tail);
+
+    /**
+     * Queue a switched packet at its input port.
+     *
+     * \param port the input port
+     * \param frame the packet
+     */
+    void Arrive(uint8_t port, Frame frame);
+
+    /**
+     * Send the packets at the head of the input ports out of their free
+     * output ports, starting with the input after the last one served.
+     */
+    void Forward();
+
+    /**
+     * \param frame a packet
+     * \return the first free port it may take, 0 if they are all busy
+     */
+    uint8_t FindOutput(const Frame& frame) const;
+
+    void Drop(Ptr<const Packet> packet);
+
+    /**
+     * A port ticked, distribute the time-code.
+     *
+     * \param device the device of the port
+     * \param timeCode the time-code
+     */
+    void ReceiveTimeCode(Ptr<SpWDevice> device, uint8_t timeCode);
+
+    std::vector<Ptr<SpWDevice>> m_ports;          //!< Devices by port number - 1
+    std::vector<std::deque<Frame>> m_inputs;      //!< Packets at the input ports
+    std::vector<std::vector<uint8_t>> m_routes;   //!< Port groups by logical address
+    Time m_switchingDelay;                        //!< From head arrival to output
+    uint8_t m_nextInput;                          //!< Input served first
+    uint8_t m_timeCode;                           //!< Time counter
+    uint64_t m_forwarded;                         //!< Packets switched
+    uint64_t m_drops;                             //!< Packets without a route
+    Time m_blocked;                               //!< Time spent waiting at the inputs
+    TracedCallback<Ptr<const Packet>, uint8_t, uint8_t> m_forwardTrace; //!< Packet switched
+    TracedCallback<Ptr<const Packet>> m_dropTrace;                      //!< Packet dropped
+};
+
+} // namespace ns3
+
+#endif /* SPW_ROUTER_H */
@@ -0,0 +1,106 @@
+#include "spw-time-code-generator.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SpWTimeCodeGenerator");
+
+NS_OBJECT_ENSURE_REGISTERED(SpWTimeCodeGenerator);
+
+TypeId
+SpWTimeCodeGenerator::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SpWTimeCodeGenerator")
+            .SetParent<Object>()
+            .SetGroupName("PointToPoint")
+            .AddConstructor<SpWTimeCodeGenerator>()
+            .AddAttribute("Period",
+                          "Time between time-codes, the length of a slot",
+                          TimeValue(MicroSeconds(100)),
+                          MakeTimeAccessor(&SpWTimeCodeGenerator::SetPeriod,
+                                           &SpWTimeCodeGenerator::GetPeriod),
+                          MakeTimeChecker());
+    return tid;
+}
+
+SpWTimeCodeGenerator::SpWTimeCodeGenerator()
+    : m_period(MicroSeconds(100)),
+      m_ticks(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SpWTimeCodeGenerator::~SpWTimeCodeGenerator()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+SpWTimeCodeGenerator::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::Cancel(m_tickEvent);
+    m_devices.clear();
+    Object::DoDispose();
+}
+
+void
+SpWTimeCodeGenerator::AddDevice(Ptr<SpWDevice> device)
+{
+    NS_LOG_FUNCTION(this << device);
+    m_devices.push_back(device);
+}
+
+void
+SpWTimeCodeGenerator::Start()
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::Cancel(m_tickEvent);
+    m_ticks = 0;
+    Tick();
+}
+
+void
+SpWTimeCodeGenerator::Stop()
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::Cancel(m_tickEvent);
+}
+
+void
+SpWTimeCodeGenerator::SetPeriod(Time period)
+{
+    NS_LOG_FUNCTION(this << period);
+    NS_ABORT_MSG_IF(!period.IsStrictlyPositive(), "SpWTimeCodeGenerator needs a period");
+    m_period = period;
+}
+
+Time
+SpWTimeCodeGenerator::GetPeriod() const
+{
+    return m_period;
+}
+
+uint64_t
+SpWTimeCodeGenerator::GetTickCount() const
+{
+    return m_ticks;
+}
+
+void
+SpWTimeCodeGenerator::Tick()
+{
+    m_ticks++;
+    for (auto& device : m_devices)
+    {
+        device->TickIn();
+    }
+    m_tickEvent = Simulator::Schedule(m_period, &SpWTimeCodeGenerator::Tick, this);
+}
+
+} // namespace ns3
@@ -0,0 +1,70 @@
+#ifndef SPW_TIME_CODE_GENERATOR_H
+#define SPW_TIME_CODE_GENERATOR_H
+
+#include "spw-device.h"
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point
+ * \brief Time master of a SpaceWire network.
+ *
+ * Every Period the generator ticks the devices it drives (TICK_IN), they
+ * advance their time counter and send it to their peers. Routers pass
+ * the time-codes on, see SpWRouter, so the whole network counts the
+ * periods modulo 64: the time-code is the number of the current slot.
+ */
+class SpWTimeCodeGenerator : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SpWTimeCodeGenerator();
+    ~SpWTimeCodeGenerator() override;
+
+    /**
+     * \param device a device to tick, usually on the node of the time master
+     */
+    void AddDevice(Ptr<SpWDevice> device);
+
+    /**
+     * Tick now and every Period from now on.
+     */
+    void Start();
+
+    void Stop();
+
+    void SetPeriod(Time period);
+    Time GetPeriod() const;
+
+    /**
+     * \return ticks since Start
+     */
+    uint64_t GetTickCount() const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    void Tick();
+
+    std::vector<Ptr<SpWDevice>> m_devices; //!< Devices ticked
+    Time m_period;                         //!< Time between ticks
+    uint64_t m_ticks;                      //!< Ticks since Start
+    EventId m_tickEvent;                   //!< Next tick
+};
+
+} // namespace ns3
+
+#endif /* SPW_TIME_CODE_GENERATOR_H */
@@ -0,0 +1,227 @@
+#include "spw-trace-sink.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SpWTraceSink");
+
+NS_OBJECT_ENSURE_REGISTERED(SpWTraceSink);
+
+std::string
+FormatSpWTraceRecord(const SpWTraceRecord& r)
+{
+    bool isAck = r.flags & SpWTraceRecord::FLAG_ACK;
+    bool isReception = r.kind != SpWTraceRecord::TX_START;
+    const char* format;
+    uint8_t left;
+    uint8_t right;
+
+    // the node of the first device is always on the left
+    if (r.wire == 0)
+    {
+        left = r.src;
+        right = r.dst;
+        if (isAck)
+        {
+            format = isReception
+                         ? "         NODE[%2d] --(%2d)-> <SEQ.N=%3d><ACK> NODE[%2d] received"
+                         : "         NODE[%2d] --(%2d)-> <SEQ.N=%3d><ACK> NODE[%2d]         ";
+        }
+        else
+        {
+            format = isReception
+                         ? "         NODE[%2d] --(%2d)-> <SEQ.N=%3d>      NODE[%2d] received"
+                         : "         NODE[%2d] --(%2d)-> <SEQ.N=%3d>      NODE[%2d]         ";
+        }
+    }
+    else
+    {
+        left = r.dst;
+        right = r.src;
+        if (isAck)
+        {
+            format = isReception
+                         ? "received NODE[%2d] <-(%2d)-- <SEQ.N=%3d><ACK> NODE[%2d]         "
+                         : "         NODE[%2d] <-(%2d)-- <SEQ.N=%3d><ACK> NODE[%2d]         ";
+        }
+        else
+        {
+            format = isReception
+                         ? "received NODE[%3d] <-(%2d)-- <SEQ.N=%3d>      NODE[%2d]         "
+                         : "         NODE[%2d] <-(%2d)-- <SEQ.N=%3d>      NODE[%2d]         ";
+        }
+    }
+
+    char buff[100];
+    snprintf(buff, sizeof(buff), format, left, r.channelSeq, r.seq, right);
+    std::string line(buff);
+    if (r.kind == SpWTraceRecord::RX_EEP)
+    {
+        line.replace(line.find("received"), 8, "EEP     ");
+    }
+    return line;
+}
+
+TypeId
+SpWTraceSink::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SpWTraceSink")
+            .SetParent<Object>()
+            .SetGroupName("PointToPoint")
+            .AddConstructor<SpWTraceSink>()
+            .AddAttribute("FileName",
+                          "File the records are mapped to, empty to keep them in memory",
+                          StringValue(""),
+                          MakeStringAccessor(&SpWTraceSink::m_fileName),
+                          MakeStringChecker())
+            .AddAttribute("Capacity",
+                          "Records kept, older ones are overwritten",
+                          UintegerValue(1 << 16),
+                          MakeUintegerAccessor(&SpWTraceSink::m_capacity),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+SpWTraceSink::SpWTraceSink()
+    : m_capacity(1 << 16),
+      m_map(nullptr),
+      m_mapSize(0),
+      m_header(nullptr),
+      m_records(nullptr)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SpWTraceSink::~SpWTraceSink()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+}
+
+void
+SpWTraceSink::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Close();
+    Object::DoDispose();
+}
+
+void
+SpWTraceSink::Open(const std::string& fileName, uint32_t capacity)
+{
+    NS_LOG_FUNCTION(this << fileName << capacity);
+    NS_ABORT_MSG_IF(capacity == 0, "SpWTraceSink needs room for a record");
+    Close();
+
+    m_fileName = fileName;
+    m_capacity = capacity;
+    m_mapSize = sizeof(FileHeader) + size_t(capacity) * sizeof(SpWTraceRecord);
+    if (fileName.empty())
+    {
+        m_map = mmap(nullptr, m_mapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    else
+    {
+        int fd = ::open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        NS_ABORT_MSG_IF(fd < 0, "SpWTraceSink cannot create " << fileName);
+        NS_ABORT_MSG_IF(ftruncate(fd, m_mapSize) != 0, "SpWTraceSink cannot size " << fileName);
+        m_map = mmap(nullptr, m_mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);
+    }
+    NS_ABORT_MSG_IF(m_map == MAP_FAILED, "SpWTraceSink cannot map " << m_mapSize << " bytes");
+
+    m_header = static_cast<FileHeader*>(m_map);
+    memcpy(m_header->magic, "SPWTRACE", sizeof(m_header->magic));
+    m_header->version = VERSION;
+    m_header->recordSize = sizeof(SpWTraceRecord);
+    m_header->capacity = capacity;
+    m_header->count = 0;
+    m_records = reinterpret_cast<SpWTraceRecord*>(m_header + 1);
+}
+
+void
+SpWTraceSink::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_map)
+    {
+        return;
+    }
+    munmap(m_map, m_mapSize);
+    m_map = nullptr;
+    m_header = nullptr;
+    m_records = nullptr;
+}
+
+void
+SpWTraceSink::Record(const SpWTraceRecord& r)
+{
+    if (!m_map)
+    {
+        Open(m_fileName, m_capacity);
+    }
+    m_records[m_header->count % m_capacity] = r;
+    m_header->count++;
+}
+
+uint64_t
+SpWTraceSink::GetCount() const
+{
+    return m_header ? m_header->count : 0;
+}
+
+uint32_t
+SpWTraceSink::GetSize() const
+{
+    return GetCount() < m_capacity ? GetCount() : m_capacity;
+}
+
+SpWTraceRecord
+SpWTraceSink::GetRecord(uint32_t i) const
+{
+    NS_ASSERT(i < GetSize());
+    return m_records[(GetCount() - GetSize() + i) % m_capacity];
+}
+
+bool
+SpWTraceSink::Load(const std::string& fileName, std::vector<SpWTraceRecord>& records)
+{
+    std::ifstream in(fileName, std::ios::binary);
+    FileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        memcmp(header.magic, "SPWTRACE", sizeof(header.magic)) != 0 ||
+        header.version != VERSION || header.recordSize != sizeof(SpWTraceRecord) ||
+        header.capacity == 0)
+    {
+        return false;
+    }
+
+    std::vector<SpWTraceRecord> ring(header.capacity);
+    if (!in.read(reinterpret_cast<char*>(ring.data()), ring.size() * sizeof(SpWTraceRecord)))
+    {
+        return false;
+    }
+    uint64_t kept = header.count < header.capacity ? header.count : header.capacity;
+    records.clear();
+    records.reserve(kept);
+    for (uint64_t i = header.count - kept; i < header.count; ++i)
+    {
+        records.push_back(ring[i % header.capacity]);
+    }
+    return true;
+}
+
+} // namespace ns3
@@ -0,0 +1,164 @@
+#ifndef SPW_TRACE_SINK_H
+#define SPW_TRACE_SINK_H
+
+#include "ns3/object.h"
+
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup point-to-point
+ * \brief A packet event on a SpWChannel, as SpWTraceSink stores it.
+ *
+ * 24 bytes in host byte order, no padding:
+ *
+ *     offset size field
+ *          0    8 timeNs      simulation time in nanoseconds
+ *          8    4 size        packet size in bytes
+ *         12    4 channelSeq  number of the packet on the channel
+ *         16    1 kind        Kind
+ *         17    1 wire        0 from the first device attached, 1 back
+ *         18    1 src         address of the sending device
+ *         19    1 dst         address of the receiving device
+ *         20    1 seq         OST sequence number
+ *         21    1 flags       OST flags, see the FLAG_ bits
+ *         22    2 reserved    0
+ */
+struct SpWTraceRecord
+{
+    enum Kind : uint8_t
+    {
+        TX_START = 0, //!< First character on the wire
+        RX_END = 1,   //!< Packet handed to the receiving device
+        RX_EEP = 2,   //!< Packet ended by an EEP, size is what was received
+    };
+
+    static const uint8_t FLAG_ACK = 0x01;
+    static const uint8_t FLAG_SYN = 0x02;
+    static const uint8_t FLAG_RST = 0x04;
+    static const uint8_t FLAG_DTA = 0x08;
+
+    int64_t timeNs;
+    uint32_t size;
+    uint32_t channelSeq;
+    uint8_t kind;
+    uint8_t wire;
+    uint8_t src;
+    uint8_t dst;
+    uint8_t seq;
+    uint8_t flags;
+    uint16_t reserved;
+};
+
+static_assert(sizeof(SpWTraceRecord) == 24, "the trace file layout depends on it");
+
+/**
+ * \return the line SpWChannel logs for the record, without the time
+ */
+std::string FormatSpWTraceRecord(const SpWTraceRecord& r);
+
+/**
+ * \ingroup point-to-point
+ * \brief Ring of SpWTraceRecord in a memory-mapped file.
+ *
+ * Recording copies the record into the mapping and nothing else, the
+ * kernel writes the pages back. The file starts with a 32-byte header:
+ *
+ *     offset size field
+ *          0    8 magic       "SPWTRACE"
+ *          8    4 version     1
+ *         12    4 recordSize  24
+ *         16    8 capacity    records the ring holds
+ *         24    8 count       records written so far
+ *
+ * followed by capacity records. Record i is kept in slot i % capacity,
+ * so once count exceeds capacity only the last capacity records remain.
+ * With an empty FileName the ring is kept in anonymous memory.
+ *
+ * The sink opens with its attributes on the first record unless Open was
+ * called before. spw-trace-decode prints a file in the format of the
+ * SpWChannel log.
+ */
+class SpWTraceSink : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    SpWTraceSink();
+    ~SpWTraceSink() override;
+
+    /**
+     * Map a new ring, dropping the current one. Aborts if the file cannot
+     * be created.
+     *
+     * \param fileName file to map, empty for anonymous memory
+     * \param capacity records in the ring
+     */
+    void Open(const std::string& fileName, uint32_t capacity);
+
+    /**
+     * Unmap the ring, the file keeps what was recorded.
+     */
+    void Close();
+
+    void Record(const SpWTraceRecord& r);
+
+    /**
+     * \return records written since Open, including the overwritten ones
+     */
+    uint64_t GetCount() const;
+
+    /**
+     * \return records still in the ring
+     */
+    uint32_t GetSize() const;
+
+    /**
+     * \param i index from 0, the oldest record kept, to GetSize() - 1
+     * \return the record
+     */
+    SpWTraceRecord GetRecord(uint32_t i) const;
+
+    /**
+     * Read a trace file.
+     *
+     * \param fileName the file
+     * \param records filled with the records kept, oldest first
+     * \return false if the file is not a trace file
+     */
+    static bool Load(const std::string& fileName, std::vector<SpWTraceRecord>& records);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /** The header at the start of the mapping. */
+    struct FileHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t recordSize;
+        uint64_t capacity;
+        uint64_t count;
+    };
+
+    static const uint32_t VERSION = 1;
+
+    std::string m_fileName;    //!< File of the ring, empty for memory
+    uint32_t m_capacity;       //!< Records in the ring
+    void* m_map;               //!< The mapping, nullptr when closed
+    size_t m_mapSize;          //!< Bytes mapped
+    FileHeader* m_header;      //!< Header in the mapping
+    SpWTraceRecord* m_records; //!< Ring in the mapping
+};
+
+} // namespace ns3
+
+#endif /* SPW_TRACE_SINK_H */
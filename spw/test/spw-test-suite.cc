@@ -4,12 +4,28 @@
 
 // An essential include is test.h
 #include "ns3/test.h"
+#include "ns3/boolean.h"
 #include "ns3/drop-tail-queue.h"
 #include "ns3/spw-channel.h"
+#include "ns3/spw-codel-queue.h"
 #include "ns3/spw-device.h"
+#include "ns3/spw-error-model.h"
+#include "ns3/spw-flow-control.h"
+#include "ns3/spw-link-header.h"
+#include "ns3/spw-pcap-helper.h"
+#include "ns3/spw-processing-model.h"
+#include "ns3/spw-router.h"
+#include "ns3/spw-time-code-generator.h"
+#include "ns3/spw-trace-sink.h"
 #include "ns3/simulator.h"
 #include "ns3/log.h"
+#include "ns3/ost-header.h"
 #include "ns3/seq-ts-header.h"
+#include "ns3/uinteger.h"
+
+#include <fstream>
+#include <map>
+#include <vector>
 
 // Do not put your test classes in namespace ns3.  You may find it useful
 // to use the using directive to access the ns3 namespace directly
@@ -141,6 +157,1215 @@ SpwTestCase1::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup spw-tests
+ * Link start-up of two devices, the second one started later.
+ *
+ * Both handshake modes must reach RUN at the same time: the second device
+ * starts while the first one is in STARTED, they exchange NULLs and FCTs
+ * and are in RUN two character delays later.
+ */
+class SpwHandshakeTestCase : public TestCase
+{
+  public:
+    SpwHandshakeTestCase(bool analytical);
+    void DoRun() override;
+
+  private:
+    void Ready(uint32_t dev);
+    void FirstReady();
+    void SecondReady();
+
+    bool m_analytical;
+    Time m_ready[2];
+};
+
+SpwHandshakeTestCase::SpwHandshakeTestCase(bool analytical)
+    : TestCase(analytical ? "SpW analytical link start-up" : "SpW per-character link start-up"),
+      m_analytical(analytical)
+{
+}
+
+void
+SpwHandshakeTestCase::Ready(uint32_t dev)
+{
+    if (m_ready[dev].IsZero())
+    {
+        m_ready[dev] = Simulator::Now();
+    }
+}
+
+void
+SpwHandshakeTestCase::FirstReady()
+{
+    Ready(0);
+}
+
+void
+SpwHandshakeTestCase::SecondReady()
+{
+    Ready(1);
+}
+
+void
+SpwHandshakeTestCase::DoRun()
+{
+    Ptr<SpWDevice> dev[2];
+    Ptr<SpWChannel> channel = CreateObject<SpWChannel>();
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        dev[i] = CreateObject<SpWDevice>();
+        dev[i]->SetAttribute("AnalyticalHandshake", BooleanValue(m_analytical));
+        dev[i]->Attach(channel);
+        dev[i]->SetAddress(Mac8Address::Allocate());
+        dev[i]->SetQueue(CreateObject<DropTailQueue<Packet>>());
+    }
+    dev[0]->SetDeviceReadyCallback(MakeCallback(&SpwHandshakeTestCase::FirstReady, this));
+    dev[1]->SetDeviceReadyCallback(MakeCallback(&SpwHandshakeTestCase::SecondReady, this));
+
+    // the first device cycles through the reset states alone, the second one
+    // reaches STARTED 5 us into a STARTED window of the first one
+    Time start = MicroSeconds(32 * 100 + 5);
+    Simulator::Schedule(Seconds(0), &SpWDevice::ErrorResetSpWState, dev[0]);
+    Simulator::Schedule(start, &SpWDevice::ErrorResetSpWState, dev[1]);
+    Simulator::Stop(MilliSeconds(10));
+    Simulator::Run();
+
+    Time run = start + NanoSeconds(19200 + 22);
+    NS_TEST_EXPECT_MSG_EQ(dev[0]->IsReadyToTransmit(), true, "first device in RUN");
+    NS_TEST_EXPECT_MSG_EQ(dev[1]->IsReadyToTransmit(), true, "second device in RUN");
+    NS_TEST_EXPECT_MSG_EQ(m_ready[0], run, "first device RUN time");
+    NS_TEST_EXPECT_MSG_EQ(m_ready[1], run, "second device RUN time");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup spw-tests
+ * Credit-based flow control and character-level line time: a receiver that
+ * keeps up never stalls the transmitter, a slow one with a one-FCT buffer
+ * stalls it for every block.
+ */
+class SpwCreditTestCase : public TestCase
+{
+  public:
+    SpwCreditTestCase();
+    void DoRun() override;
+};
+
+SpwCreditTestCase::SpwCreditTestCase()
+    : TestCase("SpW credit-based flow control")
+{
+}
+
+void
+SpwCreditTestCase::DoRun()
+{
+    Time charTime = NanoSeconds(10);
+    Time eopTime = NanoSeconds(4);
+    SpWCreditModel credit;
+
+    credit.Reset(Seconds(0), SpWCreditModel::MAX_CREDIT, Time(), NanoSeconds(10), NanoSeconds(5));
+    NS_TEST_EXPECT_MSG_EQ(credit.Transmit(Seconds(0), 1000, charTime, eopTime), Time(), "fast reader");
+    NS_TEST_EXPECT_MSG_EQ(credit.Transmit(NanoSeconds(10010), 1000, charTime, eopTime), Time(), "fast reader");
+
+    // 8 N-chars of buffer read every 100 ns: each FCT is sent when the last
+    // N-char of the previous block is read, 10 ns before it is received
+    credit.Reset(Seconds(0), 8, NanoSeconds(100), NanoSeconds(10), NanoSeconds(5));
+    Time stalled = credit.Transmit(Seconds(0), 16, charTime, eopTime);
+    // block 0 is read by 815 ns, block 1 sent from 825 ns is read by 1640 ns
+    NS_TEST_EXPECT_MSG_EQ(stalled, NanoSeconds((825 - 80) + (1650 - 905)), "slow reader");
+
+    // the device accumulates the stalls of the packets it sends
+    Ptr<SpWDevice> dev = CreateObject<SpWDevice>();
+    NS_TEST_EXPECT_MSG_EQ(dev->GetRxBufferSize(), SpWCreditModel::MAX_CREDIT, "default buffer");
+    NS_TEST_EXPECT_MSG_EQ(dev->GetRxReadTime(), Time(), "default reader keeps up");
+    NS_TEST_EXPECT_MSG_EQ(dev->GetCreditStarvationTime(), Time(), "no stall before sending");
+
+    // 10 bits per data character and 4 for the EOP
+    dev->SetDataRate(DataRate("200Mbps"));
+    NS_TEST_EXPECT_MSG_EQ(dev->GetLineTime(100), NanoSeconds(5020), "line time");
+    dev->Dispose();
+}
+
+/**
+ * \ingroup spw-tests
+ * Character error model: a packet whose first character is corrupt is
+ * ended by an EEP and resets the link right after that character, a clean
+ * one is received after its whole line time. The channel traces the end
+ * of either.
+ */
+class SpwEepTestCase : public TestCase
+{
+  public:
+    SpwEepTestCase(bool corrupt);
+    void DoRun() override;
+
+  private:
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+    void Ready();
+    void CheckRun(Ptr<SpWDevice> dev, bool run);
+
+    bool m_corrupt;
+    Time m_received;
+};
+
+SpwEepTestCase::SpwEepTestCase(bool corrupt)
+    : TestCase(corrupt ? "SpW packet ended by an EEP" : "SpW packet with no character error"),
+      m_corrupt(corrupt)
+{
+}
+
+bool
+SpwEepTestCase::RxPacket(Ptr<NetDevice> dev,
+                         Ptr<const Packet> pkt,
+                         uint16_t mode,
+                         const Address& sender)
+{
+    m_received = Simulator::Now();
+    return true;
+}
+
+void
+SpwEepTestCase::Ready()
+{
+}
+
+void
+SpwEepTestCase::CheckRun(Ptr<SpWDevice> dev, bool run)
+{
+    NS_TEST_EXPECT_MSG_EQ(dev->IsReadyToTransmit(), run, "link state at " << Simulator::Now());
+}
+
+void
+SpwEepTestCase::DoRun()
+{
+    Ptr<SpWDevice> dev[2];
+    Ptr<SpWChannel> channel = CreateObject<SpWChannel>();
+    Ptr<SpWTraceSink> sink = CreateObject<SpWTraceSink>();
+    sink->Open("", 4);
+    channel->SetTraceSink(sink);
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        dev[i] = CreateObject<SpWDevice>();
+        dev[i]->SetDataRate(DataRate("200Mbps"));
+        dev[i]->Attach(channel);
+        dev[i]->SetAddress(Mac8Address::Allocate());
+        dev[i]->SetQueue(CreateObject<DropTailQueue<Packet>>());
+        dev[i]->SetDeviceReadyCallback(MakeCallback(&SpwEepTestCase::Ready, this));
+    }
+    Ptr<SpWCharacterErrorModel> em = CreateObject<SpWCharacterErrorModel>();
+    em->SetRate(m_corrupt ? 1.0 : 0.0);
+    dev[1]->SetCharacterParityErrorModel(em);
+    dev[1]->SetReceiveCallback(MakeCallback(&SpwEepTestCase::RxPacket, this));
+
+    Time sent = MilliSeconds(1);
+    Simulator::Schedule(Seconds(0), &SpWDevice::ErrorResetSpWState, dev[0]);
+    Simulator::Schedule(Seconds(0), &SpWDevice::ErrorResetSpWState, dev[1]);
+    Simulator::Schedule(sent, &SpWDevice::Send, dev[0], Create<Packet>(100), dev[1]->GetAddress(), 0);
+    // one 10-bit character at 200 Mbps and the 48 ns channel delay
+    Time eep = sent + NanoSeconds(50 + 48);
+    Simulator::Schedule(eep - NanoSeconds(1), &SpwEepTestCase::CheckRun, this, dev[1], true);
+    Simulator::Schedule(eep + NanoSeconds(1), &SpwEepTestCase::CheckRun, this, dev[1], !m_corrupt);
+    Simulator::Stop(MilliSeconds(200));
+    Simulator::Run();
+
+    // 100 characters and the EOP, handed over by the channel 100 ms later
+    Time received = m_corrupt ? Time() : sent + NanoSeconds(5020 + 48) + MilliSeconds(100);
+    NS_TEST_EXPECT_MSG_EQ(m_received, received, "reception time");
+
+    // the packet is traced both ways, ended by the EEP before its first character
+    NS_TEST_ASSERT_MSG_EQ(sink->GetCount(), 2, "transmission and its end traced");
+    NS_TEST_EXPECT_MSG_EQ(unsigned(sink->GetRecord(0).kind),
+                          unsigned(SpWTraceRecord::TX_START),
+                          "transmission start");
+    NS_TEST_EXPECT_MSG_EQ(sink->GetRecord(0).size, 100, "packet size");
+    NS_TEST_EXPECT_MSG_EQ(unsigned(sink->GetRecord(1).kind),
+                          unsigned(m_corrupt ? SpWTraceRecord::RX_EEP : SpWTraceRecord::RX_END),
+                          "end of the packet");
+    NS_TEST_EXPECT_MSG_EQ(sink->GetRecord(1).size, m_corrupt ? 0 : 100, "characters received");
+    NS_TEST_EXPECT_MSG_EQ(sink->GetRecord(1).timeNs,
+                          (m_corrupt ? eep : received).GetNanoSeconds(),
+                          "time of the end");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup spw-tests
+ * Control queue: an ACK sent behind data frames overtakes the ones still
+ * queued when the device has a control queue, and waits for them when it
+ * has not. The packet sent callback sees the frames leave in that order.
+ */
+class SpwControlQueueTestCase : public TestCase
+{
+  public:
+    SpwControlQueueTestCase(bool controlQueue);
+    void DoRun() override;
+
+  private:
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+    void Ready();
+    void Sent(Ptr<const Packet> pkt);
+    void Send(Ptr<SpWDevice> dev, Address dest);
+
+    static const uint32_t DATA_FRAMES = 3;
+
+    bool m_controlQueue;
+    std::vector<bool> m_acks;
+    std::vector<bool> m_sentAcks;
+};
+
+SpwControlQueueTestCase::SpwControlQueueTestCase(bool controlQueue)
+    : TestCase(controlQueue ? "SpW control frames served first" : "SpW frames served in order"),
+      m_controlQueue(controlQueue)
+{
+}
+
+bool
+SpwControlQueueTestCase::RxPacket(Ptr<NetDevice> dev,
+                                  Ptr<const Packet> pkt,
+                                  uint16_t mode,
+                                  const Address& sender)
+{
+    OstHeader header;
+    pkt->PeekHeader(header);
+    m_acks.push_back(header.is_ack());
+    return true;
+}
+
+void
+SpwControlQueueTestCase::Ready()
+{
+}
+
+void
+SpwControlQueueTestCase::Sent(Ptr<const Packet> pkt)
+{
+    OstHeader header;
+    pkt->PeekHeader(header);
+    m_sentAcks.push_back(header.is_ack());
+}
+
+void
+SpwControlQueueTestCase::Send(Ptr<SpWDevice> dev, Address dest)
+{
+    for (uint32_t i = 0; i < DATA_FRAMES; ++i)
+    {
+        Ptr<Packet> data = Create<Packet>(1000);
+        data->AddHeader(OstHeader(i, 0, 1000));
+        dev->Send(data, dest, 0);
+    }
+    OstHeader ack(0, 0, 0);
+    ack.set_flag(ACK);
+    Ptr<Packet> p = Create<Packet>();
+    p->AddHeader(ack);
+    dev->Send(p, dest, 0);
+}
+
+void
+SpwControlQueueTestCase::DoRun()
+{
+    Ptr<SpWDevice> dev[2];
+    Ptr<SpWChannel> channel = CreateObject<SpWChannel>();
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        dev[i] = CreateObject<SpWDevice>();
+        dev[i]->SetDataRate(DataRate("200Mbps"));
+        dev[i]->Attach(channel);
+        dev[i]->SetAddress(Mac8Address::Allocate());
+        dev[i]->SetQueue(CreateObject<DropTailQueue<Packet>>());
+        dev[i]->SetDeviceReadyCallback(MakeCallback(&SpwControlQueueTestCase::Ready, this));
+    }
+    if (m_controlQueue)
+    {
+        dev[0]->SetControlQueue(CreateObject<DropTailQueue<Packet>>());
+    }
+    dev[0]->SetPacketSentCallback(MakeCallback(&SpwControlQueueTestCase::Sent, this));
+    dev[1]->SetReceiveCallback(MakeCallback(&SpwControlQueueTestCase::RxPacket, this));
+
+    Simulator::Schedule(Seconds(0), &SpWDevice::ErrorResetSpWState, dev[0]);
+    Simulator::Schedule(Seconds(0), &SpWDevice::ErrorResetSpWState, dev[1]);
+    Simulator::Schedule(MilliSeconds(1), &SpwControlQueueTestCase::Send, this, dev[0], dev[1]->GetAddress());
+    Simulator::Stop(MilliSeconds(200));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_acks.size(), DATA_FRAMES + 1, "every frame received");
+    // the first data frame is on the wire when the ACK is queued
+    uint32_t position = m_controlQueue ? 1 : DATA_FRAMES;
+    for (uint32_t i = 0; i < m_acks.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_acks[i], i == position, "frame " << i);
+    }
+    NS_TEST_EXPECT_MSG_EQ((m_sentAcks == m_acks), true, "frames sent in the order received");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup spw-tests
+ * CoDel queue fed twice as fast as it is served: nothing is touched during
+ * the first interval, then packets are dropped, or marked and delivered.
+ */
+class SpwCoDelQueueTestCase : public TestCase
+{
+  public:
+    SpwCoDelQueueTestCase(bool mark);
+    void DoRun() override;
+
+  private:
+    void Congestion(Ptr<const Packet> p, bool dropped);
+    void Enqueue();
+    void Dequeue();
+
+    bool m_mark;
+    Ptr<SpWCoDelQueue> m_queue;
+    uint32_t m_enqueued;
+    uint32_t m_dequeued;
+    uint32_t m_drops;
+    uint32_t m_marks;
+    Time m_first;
+};
+
+SpwCoDelQueueTestCase::SpwCoDelQueueTestCase(bool mark)
+    : TestCase(mark ? "SpW CoDel queue marking" : "SpW CoDel queue dropping"),
+      m_mark(mark),
+      m_enqueued(0),
+      m_dequeued(0),
+      m_drops(0),
+      m_marks(0)
+{
+}
+
+void
+SpwCoDelQueueTestCase::Congestion(Ptr<const Packet> p, bool dropped)
+{
+    if (m_drops + m_marks == 0)
+    {
+        m_first = Simulator::Now();
+    }
+    (dropped ? m_drops : m_marks)++;
+}
+
+void
+SpwCoDelQueueTestCase::Enqueue()
+{
+    if (m_queue->Enqueue(Create<Packet>(1000)))
+    {
+        m_enqueued++;
+    }
+    Simulator::Schedule(MilliSeconds(5), &SpwCoDelQueueTestCase::Enqueue, this);
+}
+
+void
+SpwCoDelQueueTestCase::Dequeue()
+{
+    if (m_queue->Dequeue())
+    {
+        m_dequeued++;
+    }
+    Simulator::Schedule(MilliSeconds(10), &SpwCoDelQueueTestCase::Dequeue, this);
+}
+
+void
+SpwCoDelQueueTestCase::DoRun()
+{
+    m_queue = CreateObject<SpWCoDelQueue>();
+    m_queue->SetAttribute("UseMark", BooleanValue(m_mark));
+    m_queue->SetAttribute("MaxSize", QueueSizeValue(QueueSize("1000p")));
+    m_queue->SetCongestionCallback(MakeCallback(&SpwCoDelQueueTestCase::Congestion, this));
+    Simulator::Schedule(Seconds(0), &SpwCoDelQueueTestCase::Enqueue, this);
+    Simulator::Schedule(Seconds(0), &SpwCoDelQueueTestCase::Dequeue, this);
+    Simulator::Stop(Seconds(2));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_GT(m_first, m_queue->GetInterval(), "nothing dropped within the first interval");
+    NS_TEST_EXPECT_MSG_EQ(m_drops, m_queue->GetDropCount(), "every drop reported");
+    NS_TEST_EXPECT_MSG_EQ(m_marks, m_queue->GetMarkCount(), "every mark reported");
+    if (m_mark)
+    {
+        NS_TEST_EXPECT_MSG_GT(m_marks, 0, "packets marked");
+        NS_TEST_EXPECT_MSG_EQ(m_drops, 0, "nothing dropped");
+        NS_TEST_EXPECT_MSG_EQ(m_enqueued, m_dequeued + m_queue->GetNPackets(), "every packet kept");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_GT(m_drops, 0, "packets dropped");
+        NS_TEST_EXPECT_MSG_EQ(m_marks, 0, "nothing marked");
+        NS_TEST_EXPECT_MSG_EQ(m_enqueued, m_dequeued + m_drops + m_queue->GetNPackets(), "packets accounted for");
+    }
+
+    m_queue = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup spw-tests
+ * A frame each way recorded to a trace file: the file holds the TX and RX
+ * records of both, the log lines are rebuilt from the records and a full
+ * ring keeps the newest ones.
+ */
+class SpwTraceSinkTestCase : public TestCase
+{
+  public:
+    SpwTraceSinkTestCase();
+    void DoRun() override;
+
+  private:
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+    void Ready();
+    void Send(Ptr<SpWDevice> dev, Address dest, uint8_t seq_n, bool ack);
+};
+
+SpwTraceSinkTestCase::SpwTraceSinkTestCase()
+    : TestCase("SpW channel trace sink")
+{
+}
+
+bool
+SpwTraceSinkTestCase::RxPacket(Ptr<NetDevice> dev,
+                               Ptr<const Packet> pkt,
+                               uint16_t mode,
+                               const Address& sender)
+{
+    return true;
+}
+
+void
+SpwTraceSinkTestCase::Ready()
+{
+}
+
+void
+SpwTraceSinkTestCase::Send(Ptr<SpWDevice> dev, Address dest, uint8_t seq_n, bool ack)
+{
+    OstHeader header(seq_n, 0, ack ? 0 : 100);
+    Ptr<Packet> p = Create<Packet>(ack ? 0 : 100);
+    if (ack)
+    {
+        header.set_flag(ACK);
+    }
+    p->AddHeader(header);
+    dev->Send(p, dest, 0);
+}
+
+void
+SpwTraceSinkTestCase::DoRun()
+{
+    std::string fileName = CreateTempDirFilename("spw.trace");
+    Ptr<SpWTraceSink> sink = CreateObject<SpWTraceSink>();
+    sink->Open(fileName, 16);
+
+    Ptr<SpWDevice> dev[2];
+    Ptr<SpWChannel> channel = CreateObject<SpWChannel>();
+    channel->SetTraceSink(sink);
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        dev[i] = CreateObject<SpWDevice>();
+        dev[i]->SetDataRate(DataRate("200Mbps"));
+        dev[i]->Attach(channel);
+        dev[i]->SetAddress(Mac8Address::Allocate());
+        dev[i]->SetQueue(CreateObject<DropTailQueue<Packet>>());
+        dev[i]->SetDeviceReadyCallback(MakeCallback(&SpwTraceSinkTestCase::Ready, this));
+        dev[i]->SetReceiveCallback(MakeCallback(&SpwTraceSinkTestCase::RxPacket, this));
+    }
+
+    Simulator::Schedule(Seconds(0), &SpWDevice::ErrorResetSpWState, dev[0]);
+    Simulator::Schedule(Seconds(0), &SpWDevice::ErrorResetSpWState, dev[1]);
+    Simulator::Schedule(MilliSeconds(1), &SpwTraceSinkTestCase::Send, this, dev[0], dev[1]->GetAddress(), 5, false);
+    Simulator::Schedule(MilliSeconds(2), &SpwTraceSinkTestCase::Send, this, dev[1], dev[0]->GetAddress(), 5, true);
+    Simulator::Stop(MilliSeconds(200));
+    Simulator::Run();
+
+    std::vector<SpWTraceRecord> records;
+    NS_TEST_ASSERT_MSG_EQ(SpWTraceSink::Load(fileName, records), true, "trace file read back");
+    NS_TEST_ASSERT_MSG_EQ(records.size(), 4, "TX and RX of both frames");
+    NS_TEST_EXPECT_MSG_EQ(sink->GetCount(), 4, "every record counted");
+    uint8_t kinds[] = {SpWTraceRecord::TX_START,
+                       SpWTraceRecord::TX_START,
+                       SpWTraceRecord::RX_END,
+                       SpWTraceRecord::RX_END};
+    uint8_t wires[] = {0, 1, 0, 1};
+    for (uint32_t i = 0; i < records.size(); ++i)
+    {
+        const SpWTraceRecord& r = records[i];
+        SpWTraceRecord kept = sink->GetRecord(i);
+        NS_TEST_EXPECT_MSG_EQ(r.timeNs, kept.timeNs, "record " << i << " in the file");
+        NS_TEST_EXPECT_MSG_EQ(unsigned(r.kind), unsigned(kinds[i]), "record " << i << " kind");
+        NS_TEST_EXPECT_MSG_EQ(unsigned(r.wire), unsigned(wires[i]), "record " << i << " wire");
+        NS_TEST_EXPECT_MSG_EQ(unsigned(r.seq), 5, "record " << i << " sequence number");
+        NS_TEST_EXPECT_MSG_EQ(bool(r.flags & SpWTraceRecord::FLAG_ACK), r.wire == 1, "record " << i << " flags");
+        NS_TEST_EXPECT_MSG_GT(r.size, 100 * (r.wire == 0), "record " << i << " size");
+    }
+    NS_TEST_EXPECT_MSG_LT(records[0].timeNs, records[1].timeNs, "records in time order");
+    sink->Close();
+
+    SpWTraceRecord r = records[3];
+    r.src = 2;
+    r.dst = 1;
+    r.channelSeq = 7;
+    r.seq = 3;
+    r.flags = 0;
+    NS_TEST_EXPECT_MSG_EQ(FormatSpWTraceRecord(r),
+                          "received NODE[  1] <-( 7)-- <SEQ.N=  3>      NODE[ 2]         ",
+                          "reception on the second wire");
+    r.kind = SpWTraceRecord::TX_START;
+    r.wire = 0;
+    r.src = 1;
+    r.dst = 2;
+    r.flags = SpWTraceRecord::FLAG_ACK;
+    NS_TEST_EXPECT_MSG_EQ(FormatSpWTraceRecord(r),
+                          "         NODE[ 1] --( 7)-> <SEQ.N=  3><ACK> NODE[ 2]         ",
+                          "ACK transmission on the first wire");
+    r.kind = SpWTraceRecord::RX_EEP;
+    NS_TEST_EXPECT_MSG_EQ(FormatSpWTraceRecord(r),
+                          "         NODE[ 1] --( 7)-> <SEQ.N=  3><ACK> NODE[ 2] EEP     ",
+                          "EEP on the first wire");
+
+    Ptr<SpWTraceSink> ring = CreateObject<SpWTraceSink>();
+    ring->Open("", 3);
+    for (uint32_t i = 0; i < 5; ++i)
+    {
+        r.channelSeq = i;
+        ring->Record(r);
+    }
+    NS_TEST_EXPECT_MSG_EQ(ring->GetCount(), 5, "records written");
+    NS_TEST_EXPECT_MSG_EQ(ring->GetSize(), 3, "records kept");
+    for (uint32_t i = 0; i < ring->GetSize(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(ring->GetRecord(i).channelSeq, i + 2, "newest records kept in order");
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup spw-tests
+ * Frames of a device captured to PCAP files of two records each: every
+ * file has a PCAP header, the records carry the link header and the OST
+ * header of the frames in both directions.
+ */
+class SpwPcapTestCase : public TestCase
+{
+  public:
+    SpwPcapTestCase();
+    void DoRun() override;
+
+  private:
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+    void Ready();
+    void Send(Ptr<SpWDevice> dev, Address dest, uint8_t seq_n, bool ack);
+
+    /**
+     * Append the frames of a capture file to m_frames.
+     *
+     * \param fileName the file
+     */
+    void Read(const std::string& fileName);
+
+    static const uint32_t PAYLOAD = 100;
+    static const uint32_t RECORD = 16 + 4 + 5 + PAYLOAD; //!< record of a data frame
+
+    std::vector<std::vector<uint8_t>> m_frames;
+};
+
+SpwPcapTestCase::SpwPcapTestCase()
+    : TestCase("SpW PCAP capture")
+{
+}
+
+bool
+SpwPcapTestCase::RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender)
+{
+    return true;
+}
+
+void
+SpwPcapTestCase::Ready()
+{
+}
+
+void
+SpwPcapTestCase::Send(Ptr<SpWDevice> dev, Address dest, uint8_t seq_n, bool ack)
+{
+    OstHeader header(seq_n, 0, ack ? 0 : PAYLOAD);
+    Ptr<Packet> p = Create<Packet>(ack ? 0 : PAYLOAD);
+    if (ack)
+    {
+        header.set_flag(ACK);
+    }
+    p->AddHeader(header);
+    dev->Send(p, dest, 0);
+}
+
+void
+SpwPcapTestCase::Read(const std::string& fileName)
+{
+    std::ifstream in(fileName, std::ios::binary);
+    uint32_t header[6];
+    NS_TEST_ASSERT_MSG_EQ(bool(in.read(reinterpret_cast<char*>(header), sizeof(header))), true, fileName << " has a header");
+    NS_TEST_EXPECT_MSG_EQ(header[0], 0xa1b23c4d, fileName << " magic");
+    NS_TEST_EXPECT_MSG_EQ(header[5], 147, fileName << " link type");
+
+    uint32_t record[4];
+    while (in.read(reinterpret_cast<char*>(record), sizeof(record)))
+    {
+        NS_TEST_EXPECT_MSG_EQ(record[2], record[3], "frame captured whole");
+        std::vector<uint8_t> frame(record[2]);
+        in.read(reinterpret_cast<char*>(frame.data()), frame.size());
+        m_frames.push_back(frame);
+    }
+}
+
+void
+SpwPcapTestCase::DoRun()
+{
+    Ptr<SpWDevice> dev[2];
+    uint8_t address[2];
+    Ptr<SpWChannel> channel = CreateObject<SpWChannel>();
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        dev[i] = CreateObject<SpWDevice>();
+        dev[i]->SetDataRate(DataRate("200Mbps"));
+        dev[i]->Attach(channel);
+        dev[i]->SetAddress(Mac8Address::Allocate());
+        dev[i]->SetQueue(CreateObject<DropTailQueue<Packet>>());
+        dev[i]->SetDeviceReadyCallback(MakeCallback(&SpwPcapTestCase::Ready, this));
+        dev[i]->SetReceiveCallback(MakeCallback(&SpwPcapTestCase::RxPacket, this));
+        Mac8Address::ConvertFrom(dev[i]->GetAddress()).CopyTo(&address[i]);
+    }
+
+    SpWPcapHelper pcap;
+    pcap.SetWriterAttribute("MaxFileSize", UintegerValue(24 + 2 * RECORD));
+    Ptr<SpWPcapWriter> writer = pcap.EnablePcap(CreateTempDirFilename("spw.pcap"), dev[0]);
+
+    Simulator::Schedule(Seconds(0), &SpWDevice::ErrorResetSpWState, dev[0]);
+    Simulator::Schedule(Seconds(0), &SpWDevice::ErrorResetSpWState, dev[1]);
+    for (uint8_t seq = 0; seq < 3; ++seq)
+    {
+        Simulator::Schedule(MilliSeconds(1), &SpwPcapTestCase::Send, this, dev[0], dev[1]->GetAddress(), seq, false);
+    }
+    Simulator::Schedule(MilliSeconds(500), &SpwPcapTestCase::Send, this, dev[1], dev[0]->GetAddress(), 7, true);
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+    writer->Close();
+
+    NS_TEST_EXPECT_MSG_EQ(writer->GetRecordCount(), 4, "every frame captured");
+    NS_TEST_ASSERT_MSG_EQ(writer->GetFileCount(), 2, "capture rotated");
+    for (uint32_t i = 0; i < writer->GetFileCount(); ++i)
+    {
+        Read(writer->GetFileName(i));
+    }
+    NS_TEST_ASSERT_MSG_EQ(m_frames.size(), 4, "every record read back");
+    for (uint32_t i = 0; i < m_frames.size(); ++i)
+    {
+        const std::vector<uint8_t>& frame = m_frames[i];
+        bool received = i == 3;
+        NS_TEST_ASSERT_MSG_EQ(frame.size(), 4 + 5 + (received ? 0 : PAYLOAD), "frame " << i << " size");
+        NS_TEST_EXPECT_MSG_EQ(unsigned(frame[0]), unsigned(address[received ? 0 : 1]), "frame " << i << " destination");
+        NS_TEST_EXPECT_MSG_EQ(unsigned(frame[1]), unsigned(SpWLinkHeader::PROTOCOL_OST), "frame " << i << " protocol");
+        NS_TEST_EXPECT_MSG_EQ(unsigned(frame[2]), unsigned(address[received ? 1 : 0]), "frame " << i << " source");
+        NS_TEST_EXPECT_MSG_EQ(unsigned(frame[3]), unsigned(received ? SpWLinkHeader::FLAG_RECEIVED : 0), "frame " << i << " flags");
+        NS_TEST_EXPECT_MSG_EQ(unsigned(frame[4]), unsigned(received ? 1 : 0), "frame " << i << " OST flags");
+        NS_TEST_EXPECT_MSG_EQ(unsigned(frame[6]), unsigned(received ? 7 : i), "frame " << i << " sequence number");
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup spw-tests
+ * Receiver processing models: fixed and per-byte times, a CPU server
+ * queueing frames per wire and dropping them when full, and a channel
+ * handing a frame over after the time of its model.
+ */
+class SpwProcessingModelTestCase : public TestCase
+{
+  public:
+    SpwProcessingModelTestCase();
+    void DoRun() override;
+
+  private:
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+    void Ready();
+    void Send(Ptr<SpWDevice> dev, Address dest);
+
+    /**
+     * Admit a frame of 100 bytes to the CPU model on a wire.
+     */
+    void Admit(uint32_t wire, bool admitted, Time delay);
+
+    Ptr<SpWCpuProcessingModel> m_cpu;
+    Time m_sent;
+    Time m_received;
+};
+
+SpwProcessingModelTestCase::SpwProcessingModelTestCase()
+    : TestCase("SpW receiver processing models")
+{
+}
+
+bool
+SpwProcessingModelTestCase::RxPacket(Ptr<NetDevice> dev,
+                                     Ptr<const Packet> pkt,
+                                     uint16_t mode,
+                                     const Address& sender)
+{
+    m_received = Simulator::Now();
+    return true;
+}
+
+void
+SpwProcessingModelTestCase::Ready()
+{
+}
+
+void
+SpwProcessingModelTestCase::Send(Ptr<SpWDevice> dev, Address dest)
+{
+    Ptr<Packet> p = Create<Packet>(100);
+    p->AddHeader(OstHeader(0, 0, 100));
+    m_sent = Simulator::Now();
+    dev->Send(p, dest, 0);
+}
+
+void
+SpwProcessingModelTestCase::Admit(uint32_t wire, bool admitted, Time delay)
+{
+    Time d;
+    bool ok = m_cpu->Admit(Create<Packet>(100), wire, d);
+    NS_TEST_EXPECT_MSG_EQ(ok, admitted, "frame admitted on wire " << wire << " at " << Simulator::Now());
+    if (ok)
+    {
+        NS_TEST_EXPECT_MSG_EQ(d, delay, "frame done on wire " << wire << " at " << Simulator::Now());
+    }
+}
+
+void
+SpwProcessingModelTestCase::DoRun()
+{
+    Ptr<Packet> p = Create<Packet>(100);
+    Time delay;
+
+    Ptr<SpWFixedProcessingModel> fixed = CreateObject<SpWFixedProcessingModel>();
+    fixed->SetDelay(MicroSeconds(3));
+    NS_TEST_EXPECT_MSG_EQ(fixed->Admit(p, 0, delay), true, "fixed model admits");
+    NS_TEST_EXPECT_MSG_EQ(delay, MicroSeconds(3), "fixed time");
+
+    // 100 bytes at 8 Mbps take 100 us
+    Ptr<SpWPerByteProcessingModel> perByte = CreateObject<SpWPerByteProcessingModel>();
+    perByte->SetOverhead(MicroSeconds(10));
+    perByte->SetRate(DataRate("8Mbps"));
+    NS_TEST_EXPECT_MSG_EQ(perByte->Admit(p, 0, delay), true, "per-byte model admits");
+    NS_TEST_EXPECT_MSG_EQ(delay, MicroSeconds(110), "overhead plus bytes");
+    NS_TEST_EXPECT_MSG_EQ(perByte->Admit(p, 0, delay), true, "per-byte model admits again");
+    NS_TEST_EXPECT_MSG_EQ(delay, MicroSeconds(110), "no queueing");
+
+    m_cpu = CreateObject<SpWCpuProcessingModel>();
+    m_cpu->SetOverhead(MicroSeconds(10));
+    m_cpu->SetRate(DataRate("8Mbps"));
+    m_cpu->SetCapacity(2);
+    Simulator::Schedule(Seconds(0), &SpwProcessingModelTestCase::Admit, this, 0, true, MicroSeconds(110));
+    Simulator::Schedule(Seconds(0), &SpwProcessingModelTestCase::Admit, this, 0, true, MicroSeconds(220));
+    Simulator::Schedule(Seconds(0), &SpwProcessingModelTestCase::Admit, this, 0, false, Time());
+    Simulator::Schedule(Seconds(0), &SpwProcessingModelTestCase::Admit, this, 1, true, MicroSeconds(110));
+    // the first frame is done, the second one has 60 us left
+    Simulator::Schedule(MicroSeconds(160), &SpwProcessingModelTestCase::Admit, this, 0, true, MicroSeconds(170));
+    Simulator::Run();
+    NS_TEST_EXPECT_MSG_EQ(m_cpu->GetDropCount(), 1, "full receiver drops");
+    NS_TEST_EXPECT_MSG_EQ(m_cpu->GetBacklog(0), 2, "two frames held at the last arrival");
+    Simulator::Destroy();
+
+    Ptr<SpWDevice> dev[2];
+    Ptr<SpWChannel> channel = CreateObject<SpWChannel>();
+    channel->SetProcessingModel(fixed);
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        dev[i] = CreateObject<SpWDevice>();
+        dev[i]->SetDataRate(DataRate("200Mbps"));
+        dev[i]->Attach(channel);
+        dev[i]->SetAddress(Mac8Address::Allocate());
+        dev[i]->SetQueue(CreateObject<DropTailQueue<Packet>>());
+        dev[i]->SetDeviceReadyCallback(MakeCallback(&SpwProcessingModelTestCase::Ready, this));
+    }
+    dev[1]->SetReceiveCallback(MakeCallback(&SpwProcessingModelTestCase::RxPacket, this));
+
+    Simulator::Schedule(Seconds(0), &SpWDevice::ErrorResetSpWState, dev[0]);
+    Simulator::Schedule(Seconds(0), &SpWDevice::ErrorResetSpWState, dev[1]);
+    Simulator::Schedule(MilliSeconds(1), &SpwProcessingModelTestCase::Send, this, dev[0], dev[1]->GetAddress());
+    Simulator::Stop(MilliSeconds(10));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_GT(m_received, m_sent + MicroSeconds(3), "frame handed over after processing");
+    NS_TEST_EXPECT_MSG_LT(m_received, m_sent + MicroSeconds(20), "frame handed over soon after arrival");
+
+    m_cpu = nullptr;
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup spw-tests
+ * A router between two senders and two receivers, the first receiver on
+ * one port or, with group adaptive routing, on two.
+ */
+class SpwRouterTestCase : public TestCase
+{
+  public:
+    SpwRouterTestCase(bool group);
+    void DoRun() override;
+
+  private:
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+    void Ready();
+    void Send(Ptr<SpWDevice> dev, uint8_t dst, uint32_t size);
+
+    /**
+     * Connect a device to a new port of the router.
+     */
+    Ptr<SpWDevice> Connect(Ptr<SpWRouter> router);
+
+    bool m_group;
+    std::map<uint8_t, std::vector<Time>> m_received; //!< Arrivals by logical address
+    std::map<Ptr<NetDevice>, uint8_t> m_nodes;       //!< Logical address of the devices
+};
+
+SpwRouterTestCase::SpwRouterTestCase(bool group)
+    : TestCase(group ? "SpW router with group adaptive routing" : "SpW router"),
+      m_group(group)
+{
+}
+
+bool
+SpwRouterTestCase::RxPacket(Ptr<NetDevice> dev,
+                            Ptr<const Packet> pkt,
+                            uint16_t mode,
+                            const Address& sender)
+{
+    m_received[m_nodes[dev]].push_back(Simulator::Now());
+    return true;
+}
+
+void
+SpwRouterTestCase::Ready()
+{
+}
+
+void
+SpwRouterTestCase::Send(Ptr<SpWDevice> dev, uint8_t dst, uint32_t size)
+{
+    Ptr<Packet> p = Create<Packet>(size);
+    p->AddHeader(OstHeader(0, 0, size));
+    dev->Send(p, Mac8Address(dst), 0);
+}
+
+Ptr<SpWDevice>
+SpwRouterTestCase::Connect(Ptr<SpWRouter> router)
+{
+    Ptr<SpWChannel> channel = CreateObject<SpWChannel>();
+    channel->SetProcessingModel(nullptr);
+    Ptr<SpWDevice> dev[2];
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        dev[i] = CreateObject<SpWDevice>();
+        dev[i]->SetDataRate(DataRate("100Mbps"));
+        dev[i]->Attach(channel);
+        dev[i]->SetAddress(Mac8Address::Allocate());
+        dev[i]->SetQueue(CreateObject<DropTailQueue<Packet>>());
+        dev[i]->SetDeviceReadyCallback(MakeCallback(&SpwRouterTestCase::Ready, this));
+    }
+    router->AddPort(dev[1]);
+    dev[0]->SetReceiveCallback(MakeCallback(&SpwRouterTestCase::RxPacket, this));
+    Simulator::Schedule(Seconds(0), &SpWDevice::ErrorResetSpWState, dev[0]);
+    return dev[0];
+}
+
+void
+SpwRouterTestCase::DoRun()
+{
+    const uint8_t B = 40;
+    const uint8_t C = 50;
+    Ptr<SpWRouter> router = CreateObject<SpWRouter>();
+    Ptr<SpWDevice> a1 = Connect(router); // port 1
+    Ptr<SpWDevice> a2 = Connect(router); // port 2
+    Ptr<SpWDevice> b = Connect(router);  // port 3
+    Ptr<SpWDevice> b2 = Connect(router); // port 4
+    Ptr<SpWDevice> c = Connect(router);  // port 5
+    m_nodes[b] = B;
+    m_nodes[b2] = B;
+    m_nodes[c] = C;
+    router->AddRoute(B, m_group ? std::vector<uint8_t>{3, 4} : std::vector<uint8_t>{3});
+    router->AddRoute(C, {5});
+    a1->SetPath(C, {5});
+    a1->SetPath(99, {9});
+    router->Start();
+
+    // a long packet takes port 3, A2 has one for B behind it and one for C
+    Time t0 = MilliSeconds(1);
+    Time lineTime = a1->GetLineTime(2000 + OstHeader().GetSerializedSize() + 1);
+    Simulator::Schedule(t0, &SpwRouterTestCase::Send, this, a1, B, 2000);
+    Simulator::Schedule(t0 + MicroSeconds(1), &SpwRouterTestCase::Send, this, a2, B, 100);
+    Simulator::Schedule(t0 + MicroSeconds(1), &SpwRouterTestCase::Send, this, a2, C, 100);
+    // path addressed, then to a port the router does not have
+    Simulator::Schedule(MilliSeconds(2), &SpwRouterTestCase::Send, this, a1, C, 100);
+    Simulator::Schedule(MilliSeconds(2), &SpwRouterTestCase::Send, this, a1, 99, 100);
+    Simulator::Stop(MilliSeconds(5));
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_received[B].size(), 2, "both packets reach B");
+    NS_TEST_ASSERT_MSG_EQ(m_received[C].size(), 2, "both packets reach C");
+    NS_TEST_EXPECT_MSG_EQ(router->GetForwardedCount(), 4, "packets switched");
+    NS_TEST_EXPECT_MSG_EQ(router->GetDropCount(), 1, "packet to a missing port dropped");
+
+    // wormhole switching: the long packet is through in about one line time,
+    // not two as with store and forward
+    Time last = std::max(m_received[B][0], m_received[B][1]);
+    NS_TEST_EXPECT_MSG_LT(m_received[B][0], t0 + lineTime + MicroSeconds(20), "packet cut through");
+    if (m_group)
+    {
+        // the packets for B take a port each and nothing waits
+        NS_TEST_EXPECT_MSG_LT(last, t0 + lineTime + MicroSeconds(20), "both packets cut through");
+        NS_TEST_EXPECT_MSG_LT(m_received[C][0], t0 + lineTime / 2, "C not blocked");
+        NS_TEST_EXPECT_MSG_EQ(router->GetBlockedTime(), Time(), "no packet waits");
+    }
+    else
+    {
+        // the short packet for B waits for port 3, the one for C behind it
+        NS_TEST_EXPECT_MSG_GT(last, t0 + lineTime, "port 3 busy with the long packet");
+        NS_TEST_EXPECT_MSG_GT(m_received[C][0], t0 + lineTime, "head of line blocking");
+        NS_TEST_EXPECT_MSG_GT(router->GetBlockedTime(), lineTime, "packets wait at port 2");
+    }
+    NS_TEST_EXPECT_MSG_GT(m_received[C][1], MilliSeconds(2), "path addressed packet");
+    NS_TEST_EXPECT_MSG_EQ(router->GetInputBacklog(2), 0, "nothing left at port 2");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup spw-tests
+ * A time master ticking through a router: every node sees each tick once,
+ * and a time-code out of sequence is not passed on.
+ */
+class SpwTimeCodeTestCase : public TestCase
+{
+  public:
+    SpwTimeCodeTestCase();
+    void DoRun() override;
+
+  private:
+    void Ready();
+    void Tick(Ptr<SpWDevice> dev, uint8_t timeCode);
+
+    std::map<Ptr<SpWDevice>, std::vector<Time>> m_ticks; //!< Ticks by device
+};
+
+SpwTimeCodeTestCase::SpwTimeCodeTestCase()
+    : TestCase("SpW time-code distribution")
+{
+}
+
+void
+SpwTimeCodeTestCase::Ready()
+{
+}
+
+void
+SpwTimeCodeTestCase::Tick(Ptr<SpWDevice> dev, uint8_t timeCode)
+{
+    NS_TEST_EXPECT_MSG_EQ(+timeCode, (m_ticks[dev].size() + 1) % 64, "time-codes in sequence");
+    m_ticks[dev].push_back(Simulator::Now());
+}
+
+void
+SpwTimeCodeTestCase::DoRun()
+{
+    Ptr<SpWRouter> router = CreateObject<SpWRouter>();
+    Ptr<SpWDevice> dev[3];
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        Ptr<SpWChannel> channel = CreateObject<SpWChannel>();
+        Ptr<SpWDevice> port = CreateObject<SpWDevice>();
+        dev[i] = CreateObject<SpWDevice>();
+        for (auto d : {dev[i], port})
+        {
+            d->SetDataRate(DataRate("100Mbps"));
+            d->Attach(channel);
+            d->SetAddress(Mac8Address::Allocate());
+            d->SetQueue(CreateObject<DropTailQueue<Packet>>());
+        }
+        router->AddPort(port);
+        dev[i]->SetDeviceReadyCallback(MakeCallback(&SpwTimeCodeTestCase::Ready, this));
+        dev[i]->SetTimeCodeCallback(MakeCallback(&SpwTimeCodeTestCase::Tick, this));
+        Simulator::Schedule(Seconds(0), &SpWDevice::ErrorResetSpWState, dev[i]);
+    }
+    router->Start();
+
+    // dev[0] is the time master, 70 ticks wrap the counter around
+    const Time period = MicroSeconds(20);
+    Ptr<SpWTimeCodeGenerator> generator = CreateObject<SpWTimeCodeGenerator>();
+    generator->SetPeriod(period);
+    generator->AddDevice(dev[0]);
+    Simulator::Schedule(MilliSeconds(1), &SpWTimeCodeGenerator::Start, generator);
+    Simulator::Schedule(MilliSeconds(1) + period * 69 + period / 2,
+                        &SpWTimeCodeGenerator::Stop,
+                        generator);
+    Simulator::Schedule(MilliSeconds(3), &SpWDevice::SendTimeCode, dev[0], 30);
+    Simulator::Stop(MilliSeconds(4));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(generator->GetTickCount(), 70, "ticks generated");
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        NS_TEST_ASSERT_MSG_EQ(m_ticks[dev[i]].size(), 70, "every tick seen once");
+        NS_TEST_EXPECT_MSG_EQ(+dev[i]->GetTimeCode(), i == 0 ? 30 : 70 % 64, "time counter");
+    }
+    // two links away from the master, a few hundred nanoseconds later
+    Time lag = m_ticks[dev[1]][5] - m_ticks[dev[0]][5];
+    NS_TEST_EXPECT_MSG_GT(lag, Time(), "time-code travels");
+    NS_TEST_EXPECT_MSG_LT(lag, MicroSeconds(1), "time-code ahead of the packets");
+    NS_TEST_EXPECT_MSG_EQ(m_ticks[dev[2]][69] - m_ticks[dev[2]][0], period * 69, "ticks a period apart");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup spw-tests
+ * Link rates: start-up at 10 Mbps, fallback after parity errors and back
+ * once the link is clean, and a rate change without a link reset.
+ */
+class SpwRateTestCase : public TestCase
+{
+  public:
+    SpwRateTestCase();
+    void DoRun() override;
+
+  private:
+    bool RxPacket(Ptr<NetDevice> dev, Ptr<const Packet> pkt, uint16_t mode, const Address& sender);
+    void Ready();
+    void LinkChange();
+    void Check(Ptr<SpWDevice> dev, bool run, uint64_t bps);
+
+    std::vector<Time> m_received; //!< Arrivals at the second device
+    uint32_t m_linkChanges;       //!< Link changes of the first device
+};
+
+SpwRateTestCase::SpwRateTestCase()
+    : TestCase("SpW link rate fallback"),
+      m_linkChanges(0)
+{
+}
+
+bool
+SpwRateTestCase::RxPacket(Ptr<NetDevice> dev,
+                          Ptr<const Packet> pkt,
+                          uint16_t mode,
+                          const Address& sender)
+{
+    m_received.push_back(Simulator::Now());
+    return true;
+}
+
+void
+SpwRateTestCase::Ready()
+{
+}
+
+void
+SpwRateTestCase::LinkChange()
+{
+    m_linkChanges++;
+}
+
+void
+SpwRateTestCase::Check(Ptr<SpWDevice> dev, bool run, uint64_t bps)
+{
+    NS_TEST_EXPECT_MSG_EQ(dev->IsReadyToTransmit(), run, "link state at " << Simulator::Now());
+    NS_TEST_EXPECT_MSG_EQ(dev->GetCurrentDataRate().GetBitRate(), bps, "rate at " << Simulator::Now());
+}
+
+void
+SpwRateTestCase::DoRun()
+{
+    Ptr<SpWDevice> dev[2];
+    Ptr<SpWChannel> channel = CreateObject<SpWChannel>();
+    channel->SetProcessingModel(nullptr);
+    for (uint32_t i = 0; i < 2; ++i)
+    {
+        dev[i] = CreateObject<SpWDevice>();
+        dev[i]->SetDataRate(DataRate("100Mbps"));
+        dev[i]->SetStartupDataRate(DataRate("10Mbps"));
+        dev[i]->SetRateFallback(2, MilliSeconds(1), MilliSeconds(2));
+        dev[i]->Attach(channel);
+        dev[i]->SetAddress(Mac8Address::Allocate());
+        dev[i]->SetQueue(CreateObject<DropTailQueue<Packet>>());
+        dev[i]->SetDeviceReadyCallback(MakeCallback(&SpwRateTestCase::Ready, this));
+        Simulator::Schedule(Seconds(0), &SpWDevice::ErrorResetSpWState, dev[i]);
+    }
+    dev[1]->SetReceiveCallback(MakeCallback(&SpwRateTestCase::RxPacket, this));
+    Ptr<SpWCharacterErrorModel> em = CreateObject<SpWCharacterErrorModel>();
+    em->SetRate(1.0);
+    dev[1]->SetCharacterParityErrorModel(em);
+
+    // reset, NULL and FCT at 10 Mbps with the 48 ns channel delay
+    Time run = NanoSeconds(6400 + 12800 + 800 + 48 + 400 + 48);
+    Simulator::Schedule(run - NanoSeconds(1), &SpwRateTestCase::Check, this, dev[0], false, 100000000);
+    Simulator::Schedule(run + NanoSeconds(1), &SpwRateTestCase::Check, this, dev[0], true, 100000000);
+
+    // every packet is cut short, each two resets halve the rate
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        Simulator::Schedule(MilliSeconds(1) + MicroSeconds(100 * i),
+                            &SpWDevice::Send,
+                            dev[0],
+                            Create<Packet>(100),
+                            dev[1]->GetAddress(),
+                            0);
+    }
+    Simulator::Schedule(MicroSeconds(1150), &SpwRateTestCase::Check, this, dev[1], true, 50000000);
+    Simulator::Schedule(MicroSeconds(1350), &SpwRateTestCase::Check, this, dev[0], true, 25000000);
+    Simulator::Schedule(MicroSeconds(1350), &SpwRateTestCase::Check, this, dev[1], true, 25000000);
+    Simulator::Schedule(MicroSeconds(1400), &SpWCharacterErrorModel::SetRate, em, 0.0);
+    Time slow = MicroSeconds(1500);
+    Simulator::Schedule(slow, &SpWDevice::Send, dev[0], Create<Packet>(100), dev[1]->GetAddress(), 0);
+
+    // clean for 2 ms after the last error, then for 2 ms more
+    Simulator::Schedule(MicroSeconds(3250), &SpwRateTestCase::Check, this, dev[0], true, 25000000);
+    Simulator::Schedule(MicroSeconds(3350), &SpwRateTestCase::Check, this, dev[0], true, 50000000);
+    Simulator::Schedule(MicroSeconds(5350), &SpwRateTestCase::Check, this, dev[1], true, 100000000);
+
+    // without a link reset
+    Time fast = MilliSeconds(6);
+    Simulator::Schedule(fast - MicroSeconds(1),
+                        &SpWDevice::AddLinkChangeCallback,
+                        dev[0],
+                        MakeCallback(&SpwRateTestCase::LinkChange, this));
+    Simulator::Schedule(fast, &SpWDevice::ChangeDataRate, dev[0], DataRate("200Mbps"));
+    Simulator::Schedule(fast, &SpWDevice::Send, dev[0], Create<Packet>(100), dev[1]->GetAddress(), 0);
+    Simulator::Stop(MilliSeconds(7));
+    Simulator::Run();
+
+    // 100 characters and the EOP
+    NS_TEST_ASSERT_MSG_EQ(m_received.size(), 2, "packets after the errors");
+    NS_TEST_EXPECT_MSG_EQ(m_received[0], slow + NanoSeconds(40160 + 48), "sent at 25 Mbps");
+    NS_TEST_EXPECT_MSG_EQ(m_received[1], fast + NanoSeconds(5020 + 48), "sent at 200 Mbps");
+    NS_TEST_EXPECT_MSG_EQ(m_linkChanges, 0, "no reset for the rate change");
+    NS_TEST_EXPECT_MSG_EQ(dev[0]->GetDataRate().GetBitRate(), 100000000, "run rate kept");
+
+    std::map<uint64_t, SpWRateStats> stats = dev[0]->GetRateStats();
+    NS_TEST_EXPECT_MSG_EQ(stats[100000000].errorResets, 2, "resets at 100 Mbps");
+    NS_TEST_EXPECT_MSG_EQ(stats[50000000].errorResets, 2, "resets at 50 Mbps");
+    NS_TEST_EXPECT_MSG_EQ(stats[25000000].packets, 1, "packet sent at 25 Mbps");
+    NS_TEST_EXPECT_MSG_EQ(stats[25000000].bytes, 100, "bytes sent at 25 Mbps");
+    NS_TEST_EXPECT_MSG_EQ(stats[200000000].packets, 1, "packet sent at 200 Mbps");
+    Time total;
+    for (auto& rate : stats)
+    {
+        total += rate.second.time;
+    }
+    NS_TEST_EXPECT_MSG_EQ(total, Simulator::Now(), "time at all rates");
+
+    Simulator::Destroy();
+}
+
 // The TestSuite class names the TestSuite, identifies what type of TestSuite,
 // and enables the TestCases to be run.  Typically, only the constructor for
 // this class must be defined
@@ -160,6 +1385,22 @@ SpwTestSuite::SpwTestSuite()
 {
     // TestDuration for TestCase can be QUICK, EXTENSIVE or TAKES_FOREVER
     AddTestCase(new SpwTestCase1, TestCase::QUICK);
+    AddTestCase(new SpwHandshakeTestCase(false), TestCase::QUICK);
+    AddTestCase(new SpwHandshakeTestCase(true), TestCase::QUICK);
+    AddTestCase(new SpwCreditTestCase, TestCase::QUICK);
+    AddTestCase(new SpwEepTestCase(false), TestCase::QUICK);
+    AddTestCase(new SpwEepTestCase(true), TestCase::QUICK);
+    AddTestCase(new SpwControlQueueTestCase(false), TestCase::QUICK);
+    AddTestCase(new SpwControlQueueTestCase(true), TestCase::QUICK);
+    AddTestCase(new SpwCoDelQueueTestCase(false), TestCase::QUICK);
+    AddTestCase(new SpwCoDelQueueTestCase(true), TestCase::QUICK);
+    AddTestCase(new SpwTraceSinkTestCase, TestCase::QUICK);
+    AddTestCase(new SpwPcapTestCase, TestCase::QUICK);
+    AddTestCase(new SpwProcessingModelTestCase, TestCase::QUICK);
+    AddTestCase(new SpwRouterTestCase(false), TestCase::QUICK);
+    AddTestCase(new SpwRouterTestCase(true), TestCase::QUICK);
+    AddTestCase(new SpwTimeCodeTestCase, TestCase::QUICK);
+    AddTestCase(new SpwRateTestCase, TestCase::QUICK);
 }
 
 // Do not forget to allocate an instance of this TestSuite